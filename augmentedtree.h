@@ -0,0 +1,458 @@
+/*******************************************************************************
+ * Name        : augmentedtree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Red-black tree augmented with a per-subtree summary under a
+ *               user-supplied monoid, answering range aggregates such as
+ *               sums, minimums and maximums in O(log n).
+ ******************************************************************************/
+#ifndef AUGMENTEDTREE_H_
+#define AUGMENTEDTREE_H_
+
+#include "intrusivetree.h"
+#include "rbtree.h"
+#include "treehash.h"
+#include <limits>
+#include <stdint.h>
+#include <sstream>
+#include <string>
+#include <utility>
+
+/**
+ * A monoid describes the summary kept in every node. It must provide
+ *   typedef ... summary_type;
+ *   summary_type identity() const;
+ *   summary_type lift(const K &key, const V &value) const;
+ *   summary_type combine(const summary_type &a, const summary_type &b) const;
+ * where combine is associative and identity is its neutral element. combine
+ * need not be commutative; the left operand always covers smaller keys.
+ */
+template<typename K, typename V>
+struct SumMonoid {
+	typedef V summary_type;
+
+	summary_type identity() const {
+		return V();
+	}
+
+	summary_type lift(const K &, const V &value) const {
+		return value;
+	}
+
+	summary_type combine(const summary_type &a, const summary_type &b) const {
+		return a + b;
+	}
+};
+
+template<typename K, typename V>
+struct CountMonoid {
+	typedef size_t summary_type;
+
+	summary_type identity() const {
+		return 0;
+	}
+
+	summary_type lift(const K &, const V &) const {
+		return 1;
+	}
+
+	summary_type combine(const summary_type &a, const summary_type &b) const {
+		return a + b;
+	}
+};
+
+template<typename K, typename V>
+struct MinMonoid {
+	typedef V summary_type;
+
+	summary_type identity() const {
+		return std::numeric_limits<V>::max();
+	}
+
+	summary_type lift(const K &, const V &value) const {
+		return value;
+	}
+
+	summary_type combine(const summary_type &a, const summary_type &b) const {
+		return b < a ? b : a;
+	}
+};
+
+template<typename K, typename V>
+struct MaxMonoid {
+	typedef V summary_type;
+
+	summary_type identity() const {
+		return std::numeric_limits<V>::is_integer ?
+				std::numeric_limits<V>::min() : -std::numeric_limits<V>::max();
+	}
+
+	summary_type lift(const K &, const V &value) const {
+		return value;
+	}
+
+	summary_type combine(const summary_type &a, const summary_type &b) const {
+		return a < b ? b : a;
+	}
+};
+
+/**
+ * Digest of a set of key-value pairs: how many there are and the sum, mod
+ * 2^64, of a hash of each pair. Summing makes it independent of tree shape,
+ * so two trees holding the same pairs agree on every key range however they
+ * were built.
+ */
+struct MerkleDigest {
+	uint64_t hash;
+	uint64_t count;
+
+	MerkleDigest(uint64_t h = 0, uint64_t c = 0) :
+			hash(h), count(c) {
+	}
+
+	bool operator==(const MerkleDigest &rhs) const {
+		return hash == rhs.hash && count == rhs.count;
+	}
+
+	bool operator!=(const MerkleDigest &rhs) const {
+		return !(*this == rhs);
+	}
+};
+
+/**
+ * Keeps a MerkleDigest of every subtree, for comparing replicas with
+ * AugmentedRedBlackTree::diff. Needs std::hash for K and V.
+ */
+template<typename K, typename V>
+struct MerkleMonoid {
+	typedef MerkleDigest summary_type;
+
+	summary_type identity() const {
+		return MerkleDigest();
+	}
+
+	summary_type lift(const K &key, const V &value) const {
+		static_assert(is_hashable<K>::value && is_hashable<V>::value,
+				"MerkleMonoid needs std::hash for the key and value types");
+		return MerkleDigest(
+				mix_hash(tree_hash(key) ^ (tree_hash(value) >> 1)), 1);
+	}
+
+	summary_type combine(const summary_type &a, const summary_type &b) const {
+		return MerkleDigest(a.hash + b.hash, a.count + b.count);
+	}
+};
+
+template<typename K, typename V, typename Monoid>
+class AugmentedRedBlackTree;
+
+template<typename K, typename V, typename Monoid>
+class AugmentedNode {
+public:
+	typedef typename Monoid::summary_type summary_type;
+
+	AugmentedNode(const K &key, const V &value) :
+			key_(key), value_(value) {
+	}
+
+	inline const K& key() const {
+		return key_;
+	}
+
+	inline const V& value() const {
+		return value_;
+	}
+
+	/**
+	 * Returns the combined summary of the subtree rooted at this node.
+	 */
+	inline const summary_type& summary() const {
+		return summary_;
+	}
+
+private:
+	K key_;
+	V value_;
+	summary_type summary_;
+	RedBlackHook<AugmentedNode> hook_;
+
+	friend class AugmentedRedBlackTree<K, V, Monoid> ;
+};
+
+/**
+ * Red-black tree whose nodes carry the Monoid summary of their subtree. The
+ * summary is recomputed by the intrusive tree after each rotation and along
+ * the paths touched by insert, erase and set_value, so every update stays
+ * O(log n).
+ */
+template<typename K, typename V, typename Monoid = SumMonoid<K, V> >
+class AugmentedRedBlackTree {
+public:
+	typedef AugmentedNode<K, V, Monoid> node_type;
+	typedef typename Monoid::summary_type summary_type;
+
+private:
+	struct KeyOf {
+		const K& operator()(const node_type &n) const {
+			return n.key_;
+		}
+	};
+
+	/**
+	 * summary(x) = summary(left) + lift(x) + summary(right).
+	 */
+	struct Summarize {
+		Monoid monoid;
+
+		Summarize(const Monoid &m) :
+				monoid(m) {
+		}
+
+		void operator()(node_type *x, const node_type *l,
+				const node_type *r) const {
+			summary_type s = monoid.lift(x->key_, x->value_);
+			if (l != NULL)
+				s = monoid.combine(l->summary_, s);
+			if (r != NULL)
+				s = monoid.combine(s, r->summary_);
+			x->summary_ = s;
+		}
+	};
+
+	typedef IntrusiveRedBlackTree<node_type, K, &node_type::hook_, KeyOf,
+			std::less<K>, Summarize> tree_type;
+
+public:
+	typedef typename tree_type::iterator iterator;
+
+	AugmentedRedBlackTree(const Monoid &monoid = Monoid()) :
+			tree_(KeyOf(), std::less<K>(), Summarize(monoid)),
+			monoid_(monoid) {
+	}
+
+	~AugmentedRedBlackTree() {
+		tree_.clear_and_dispose(Deleter());
+	}
+
+	/**
+	 * Inserts a key-value pair. Throws a tree_exception on a duplicate key.
+	 */
+	void insert(const K &key, const V &value) {
+		node_type *n = new node_type(key, value);
+		if (!tree_.insert(n)) {
+			delete n;
+			std::stringstream ss;
+			ss << key;
+			throw tree_exception(
+					"Attempt to insert duplicate key '" + ss.str() + "'.");
+		}
+	}
+
+	/**
+	 * Removes key. Returns false if it is not present.
+	 */
+	bool erase(const K &key) {
+		node_type *n = tree_.erase(key);
+		delete n;
+		return n != NULL;
+	}
+
+	/**
+	 * Replaces the value stored with it and refreshes the summaries above it.
+	 */
+	void set_value(const iterator &it, const V &value) {
+		node_type *n = &*it;
+		n->value_ = value;
+		tree_.propagate(n);
+	}
+
+	iterator find(const K &key) const {
+		return iterator(tree_.find(key), &tree_);
+	}
+
+	iterator begin() const {
+		return tree_.begin();
+	}
+
+	iterator end() const {
+		return tree_.end();
+	}
+
+	size_t size() const {
+		return tree_.size();
+	}
+
+	bool empty() const {
+		return tree_.empty();
+	}
+
+	/**
+	 * Returns the summary of the whole tree.
+	 */
+	summary_type total() const {
+		return tree_.root() == NULL ?
+				monoid_.identity() : tree_.root()->summary_;
+	}
+
+	/**
+	 * Returns the summary of every pair with lo <= key <= hi, combined in
+	 * key order, in O(log n).
+	 */
+	summary_type aggregate(const K &lo, const K &hi) const {
+		// Descend to the first node inside [lo, hi]; the paths to lo and
+		// hi split there.
+		node_type *x = tree_.root();
+		while (x != NULL) {
+			if (x->key_ < lo)
+				x = tree_type::right(x);
+			else if (hi < x->key_)
+				x = tree_type::left(x);
+			else
+				break;
+		}
+		if (x == NULL)
+			return monoid_.identity();
+		summary_type s = monoid_.combine(
+				keys_at_least(tree_type::left(x), lo, false),
+				monoid_.lift(x->key_, x->value_));
+		return monoid_.combine(s, keys_at_most(tree_type::right(x), hi, false));
+	}
+
+	/**
+	 * Returns the summary of every pair with key <= hi, e.g. a prefix sum.
+	 */
+	summary_type prefix(const K &hi) const {
+		return keys_at_most(tree_.root(), hi, false);
+	}
+
+	/**
+	 * Calls out(key), in key order, for every key whose pair differs between
+	 * this tree and other: present in only one of them, or present in both
+	 * with different values. A subtree of this tree is skipped when its
+	 * summary equals other's summary over the same key range, so with a
+	 * hash monoid such as MerkleMonoid only the paths down to the d
+	 * differences are walked, each step costing one O(log n) range query on
+	 * other: O(d log^2 n) in all. Needs operator== on summaries and values.
+	 */
+	template<typename Out>
+	void diff(const AugmentedRedBlackTree &other, Out out) const {
+		diff(tree_.root(), NULL, NULL, other, out);
+	}
+
+private:
+	tree_type tree_;
+	Monoid monoid_;
+
+	// Owns its nodes; not copyable.
+	AugmentedRedBlackTree(const AugmentedRedBlackTree &);
+	AugmentedRedBlackTree& operator=(const AugmentedRedBlackTree &);
+
+	struct Deleter {
+		void operator()(node_type *n) const {
+			delete n;
+		}
+	};
+
+	inline summary_type summary_of(const node_type *n) const {
+		return n == NULL ? monoid_.identity() : n->summary_;
+	}
+
+	/**
+	 * Returns true if key lies strictly between lo and hi; a NULL bound is
+	 * unbounded.
+	 */
+	static inline bool between(const K &key, const K *lo, const K *hi) {
+		return (lo == NULL || *lo < key) && (hi == NULL || key < *hi);
+	}
+
+	/**
+	 * Returns the summary of every pair with key strictly between lo and hi.
+	 */
+	summary_type aggregate_between(const K *lo, const K *hi) const {
+		node_type *x = tree_.root();
+		while (x != NULL && !between(x->key_, lo, hi))
+			x = lo != NULL && !(*lo < x->key_) ?
+					tree_type::right(x) : tree_type::left(x);
+		if (x == NULL)
+			return monoid_.identity();
+		node_type *l = tree_type::left(x), *r = tree_type::right(x);
+		summary_type s = monoid_.combine(
+				lo == NULL ? summary_of(l) : keys_at_least(l, *lo, true),
+				monoid_.lift(x->key_, x->value_));
+		return monoid_.combine(s,
+				hi == NULL ? summary_of(r) : keys_at_most(r, *hi, true));
+	}
+
+	/**
+	 * Compares the subtree x of this tree, which holds exactly this tree's
+	 * keys strictly between lo and hi, with other's keys in that range.
+	 */
+	template<typename Out>
+	void diff(const node_type *x, const K *lo, const K *hi,
+			const AugmentedRedBlackTree &other, Out &out) const {
+		summary_type theirs = other.aggregate_between(lo, hi);
+		if (x == NULL) {
+			// Every key other has here is missing from this tree.
+			if (!(theirs == monoid_.identity())) {
+				node_type *n = lo == NULL ?
+						other.tree_.first() : other.tree_.upper_bound(*lo);
+				for (; n != NULL && between(n->key_, lo, hi);
+						n = other.tree_.next(n))
+					out(n->key_);
+			}
+			return;
+		}
+		if (x->summary_ == theirs)
+			return;
+		diff(tree_type::left(x), lo, &x->key_, other, out);
+		const node_type *match = other.tree_.find(x->key_);
+		if (match == NULL || !(match->value_ == x->value_))
+			out(x->key_);
+		diff(tree_type::right(x), &x->key_, hi, other, out);
+	}
+
+	/**
+	 * Returns the summary of the keys >= lo, or > lo if strict, in the
+	 * subtree rooted at x. Pieces are found from right to left, so each is
+	 * prepended.
+	 */
+	summary_type keys_at_least(node_type *x, const K &lo, bool strict) const {
+		summary_type s = monoid_.identity();
+		while (x != NULL) {
+			if (strict ? !(lo < x->key_) : x->key_ < lo) {
+				x = tree_type::right(x);
+			} else {
+				summary_type piece = monoid_.combine(
+						monoid_.lift(x->key_, x->value_),
+						summary_of(tree_type::right(x)));
+				s = monoid_.combine(piece, s);
+				x = tree_type::left(x);
+			}
+		}
+		return s;
+	}
+
+	/**
+	 * Returns the summary of the keys <= hi, or < hi if strict, in the
+	 * subtree rooted at x. Pieces are found from left to right, so each is
+	 * appended.
+	 */
+	summary_type keys_at_most(node_type *x, const K &hi, bool strict) const {
+		summary_type s = monoid_.identity();
+		while (x != NULL) {
+			if (strict ? !(x->key_ < hi) : hi < x->key_) {
+				x = tree_type::left(x);
+			} else {
+				summary_type piece = monoid_.combine(
+						summary_of(tree_type::left(x)),
+						monoid_.lift(x->key_, x->value_));
+				s = monoid_.combine(s, piece);
+				x = tree_type::right(x);
+			}
+		}
+		return s;
+	}
+};
+
+#endif /* AUGMENTEDTREE_H_ */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Name        : bloomfilter_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Measures RedBlackTree::find with the Bloom filter off and at
+ *               several densities, for lookup mixes with different shares of
+ *               absent keys, reporting time per lookup and the measured
+ *               false-positive rate.
+ *               Usage: bloomfilter_bench [keys] [lookups]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 2000000;
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(2 * i);
+    }
+    mt19937 rng(19);
+    shuffle(keys.begin(), keys.end(), rng);
+    RedBlackTree<int, int> tree;
+    for (size_t i = 0; i < n; ++i) {
+        tree.insert(keys[i], keys[i]);
+    }
+
+    // Present keys are even and absent ones odd.
+    const double miss_shares[] = { 0.1, 0.5, 0.9 };
+    const double densities[] = { 0, 4, 8, 12 };
+    uniform_int_distribution<size_t> pick(0, n - 1);
+    uniform_real_distribution<double> coin(0, 1);
+    cout << n << " keys, " << lookups << " lookups" << endl << endl;
+    cout << setw(8) << "misses" << setw(8) << "bits" << setw(12) << "KiB"
+         << setw(14) << "find (ns)" << setw(10) << "fpr" << endl;
+    for (size_t i = 0; i < sizeof(miss_shares) / sizeof(miss_shares[0]);
+            ++i) {
+        vector<int> probes(lookups);
+        for (size_t k = 0; k < lookups; ++k) {
+            probes[k] = static_cast<int>(2 * pick(rng))
+                    + (coin(rng) < miss_shares[i]);
+        }
+        for (size_t j = 0; j < sizeof(densities) / sizeof(densities[0]);
+                ++j) {
+            tree.set_bloom_filter(densities[j]);
+            tree.reset_bloom_filter_stats();
+            size_t found = 0;
+            bench_clock::time_point start = bench_clock::now();
+            for (size_t k = 0; k < probes.size(); ++k) {
+                found += tree.find(probes[k]) != tree.end();
+            }
+            double find = seconds_since(start);
+            cout << setw(8) << fixed << setprecision(1) << miss_shares[i]
+                 << setw(8) << setprecision(0) << densities[j] << setw(12)
+                 << tree.bloom_filter_bytes() / 1024 << setw(14)
+                 << setprecision(1) << find * 1e9 / probes.size()
+                 << setw(10) << setprecision(4)
+                 << tree.bloom_filter_stats().false_positive_rate() << "   ("
+                 << found << ")" << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Name        : btree_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Compares random lookups in RedBlackTree<int, int> and in
+ *               BTree<int, int> with 15 and 63 keys per node, at growing
+ *               sizes: time per lookup, and nodes visited per successful
+ *               and unsuccessful lookup, each a likely cache miss once the
+ *               tree outgrows the cache.
+ *               Usage: btree_bench [largest number of keys]
+ ******************************************************************************/
+#include "../btree.h"
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/**
+ * Loads keys into a new T, then looks up every probe. Half the probes are
+ * odd and miss.
+ */
+template<typename T>
+void run(const char *name, const vector<int> &keys,
+        const vector<int> &probes) {
+    T tree;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(keys[i], keys[i]);
+    }
+    size_t found = 0;
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t i = 0; i < probes.size(); ++i) {
+        found += tree.find(probes[i]) != tree.end();
+    }
+    double find = seconds_since(start);
+
+    cout << setw(12) << keys.size() << setw(16) << name << setw(12) << fixed
+         << setprecision(1) << find * 1e9 / probes.size() << setw(12)
+         << tree.successful_search_cost() << setw(12)
+         << tree.unsuccessful_search_cost() << "   (" << found << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    size_t largest = argc > 1 ? strtoul(argv[1], NULL, 10) : 6400000;
+    mt19937 rng(32);
+
+    cout << setw(12) << "keys" << setw(16) << "tree" << setw(12)
+         << "find ns" << setw(12) << "nodes hit" << setw(12) << "nodes miss"
+         << endl;
+    for (size_t n = 100000; n <= largest; n *= 4) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = static_cast<int>(2 * i);
+        }
+        shuffle(keys.begin(), keys.end(), rng);
+        vector<int> probes(2000000);
+        uniform_int_distribution<int> pick(0, static_cast<int>(2 * n - 1));
+        for (size_t i = 0; i < probes.size(); ++i) {
+            probes[i] = pick(rng);
+        }
+        run<RedBlackTree<int, int> >("RedBlackTree", keys, probes);
+        run<BTree<int, int, 15> >("BTree<15>", keys, probes);
+        run<BTree<int, int, 63> >("BTree<63>", keys, probes);
+    }
+    return 0;
+}
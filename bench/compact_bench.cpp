@@ -0,0 +1,196 @@
+/*******************************************************************************
+ * Name        : compact_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Scatters the nodes of a RedBlackTree with rounds of erases
+ *               and inserts, then measures in-order iteration and random
+ *               finds, with cache misses per operation where the kernel
+ *               exposes hardware counters, before compaction, after an
+ *               incremental compaction in key order, and after compact().
+ *               Usage: compact_bench [keys] [nodes per slice]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/**
+ * Counts last-level cache misses of this thread through perf_event_open.
+ * read() returns -1 where the counter is not available.
+ */
+class MissCounter {
+public:
+    MissCounter() : fd_(-1) {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1,
+                -1, 0));
+#endif
+    }
+
+    ~MissCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long read() {
+        long long count = -1;
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(fd_, &count, sizeof(count)) != sizeof(count)) {
+                count = -1;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_;
+};
+
+MissCounter misses;
+
+void report(double seconds, long long missed, size_t ops) {
+    cout << setw(12) << fixed << setprecision(1)
+         << seconds * 1e9 / ops << setw(14);
+    if (missed < 0) {
+        cout << "n/a";
+    } else {
+        cout << setprecision(2) << (double) missed / ops;
+    }
+}
+
+void measure(const string &state, RedBlackTree<int, int> &tree,
+        const vector<int> &probes) {
+    misses.start();
+    bench_clock::time_point start = bench_clock::now();
+    long long sum = 0;
+    for (RedBlackTree<int, int>::iterator it = tree.begin(); it != tree.end();
+            ++it) {
+        sum += it->second;
+    }
+    double scan = seconds_since(start);
+    long long scan_misses = misses.read();
+
+    misses.start();
+    start = bench_clock::now();
+    for (size_t i = 0; i < probes.size(); ++i) {
+        sum += tree.find(probes[i]) != tree.end();
+    }
+    double find = seconds_since(start);
+    long long find_misses = misses.read();
+
+    cout << setw(14) << state;
+    report(scan, scan_misses, tree.size());
+    report(find, find_misses, probes.size());
+    cout << "   (" << sum % 10 << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t slice = argc > 2 ? strtoul(argv[2], NULL, 10) : 4096;
+    mt19937 rng(37);
+    uniform_int_distribution<int> key(0, static_cast<int>(4 * n));
+    RedBlackTree<int, int> tree;
+    while (tree.size() < n) {
+        int k = key(rng);
+        if (tree.find(k) == tree.end()) {
+            tree.insert(k, k);
+        }
+    }
+    // Each round frees half the nodes in random order and refills the
+    // holes through the free list, so neighbours in the tree end up far
+    // apart in memory.
+    for (int round = 0; round < 4; ++round) {
+        vector<int> keys;
+        for (RedBlackTree<int, int>::iterator it = tree.begin();
+                it != tree.end(); ++it) {
+            keys.push_back(it->first);
+        }
+        shuffle(keys.begin(), keys.end(), rng);
+        for (size_t i = 0; i < keys.size() / 2; ++i) {
+            tree.erase(keys[i]);
+        }
+        while (tree.size() < n) {
+            int k = key(rng);
+            if (tree.find(k) == tree.end()) {
+                tree.insert(k, k);
+            }
+        }
+    }
+    vector<int> probes(1000000);
+    for (size_t i = 0; i < probes.size(); ++i) {
+        probes[i] = key(rng);
+    }
+
+    cout << n << " keys after 4 rounds of churn" << endl << endl;
+    cout << setw(14) << "layout" << setw(12) << "scan ns" << setw(14)
+         << "misses/key" << setw(12) << "find ns" << setw(14)
+         << "misses/find" << endl;
+    measure("scattered", tree, probes);
+
+    size_t steps = 0;
+    double longest = 0;
+    bench_clock::time_point total = bench_clock::now();
+    for (bool done = false; !done; ++steps) {
+        bench_clock::time_point start = bench_clock::now();
+        done = tree.compact_step(slice);
+        longest = max(longest, seconds_since(start));
+    }
+    double incremental = seconds_since(total);
+    measure("key order", tree, probes);
+
+    total = bench_clock::now();
+    tree.compact();
+    double full = seconds_since(total);
+    measure("preorder", tree, probes);
+
+    cout << endl << "compact_step: " << steps << " slices of " << slice
+         << " nodes, " << setprecision(1) << incremental * 1e3
+         << " ms in all, longest slice " << setprecision(3)
+         << longest * 1e3 << " ms" << endl;
+    cout << "compact():    " << setprecision(1) << full * 1e3 << " ms"
+         << endl;
+    return 0;
+}
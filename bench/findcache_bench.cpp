@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Name        : findcache_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Measures RedBlackTree::find under Zipf-distributed lookups
+ *               with the find cache off and at several sizes, reporting time
+ *               per lookup and hit rate.
+ *               Usage: findcache_bench [keys] [lookups]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/**
+ * Draws count keys where the key of rank r (1-based) has probability
+ * proportional to 1 / r^s. Ranks are assigned to keys at random so that hot
+ * keys are spread over the tree.
+ */
+vector<int> zipf_keys(const vector<int> &keys, double s, size_t count,
+        mt19937 &rng) {
+    vector<double> cdf(keys.size());
+    double total = 0;
+    for (size_t r = 0; r < keys.size(); ++r) {
+        total += 1 / pow(static_cast<double>(r + 1), s);
+        cdf[r] = total;
+    }
+    vector<int> ranked(keys);
+    shuffle(ranked.begin(), ranked.end(), rng);
+    uniform_real_distribution<double> u(0, total);
+    vector<int> out(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t r = lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin();
+        out[i] = ranked[min(r, keys.size() - 1)];
+    }
+    return out;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 2000000;
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(i);
+    }
+    mt19937 rng(17);
+    shuffle(keys.begin(), keys.end(), rng);
+    RedBlackTree<int, int> tree;
+    for (size_t i = 0; i < n; ++i) {
+        tree.insert(keys[i], keys[i]);
+    }
+
+    const double skews[] = { 0.8, 0.99, 1.2 };
+    const size_t slots[] = { 0, 1024, 4096, 16384, 65536 };
+    cout << n << " keys, " << lookups << " lookups" << endl << endl;
+    cout << setw(8) << "zipf s" << setw(10) << "slots" << setw(14)
+         << "find (ns)" << setw(12) << "hit rate" << endl;
+    for (size_t i = 0; i < sizeof(skews) / sizeof(skews[0]); ++i) {
+        vector<int> probes = zipf_keys(keys, skews[i], lookups, rng);
+        for (size_t j = 0; j < sizeof(slots) / sizeof(slots[0]); ++j) {
+            tree.set_find_cache_slots(slots[j]);
+            long long sum = 0;
+            bench_clock::time_point start = bench_clock::now();
+            for (size_t k = 0; k < probes.size(); ++k) {
+                sum += (*tree.find(probes[k])).second;
+            }
+            double find = seconds_since(start);
+            FindCacheStats stats = tree.find_cache_stats();
+            tree.reset_find_cache_stats();
+            cout << setw(8) << fixed << setprecision(2) << skews[i]
+                 << setw(10) << slots[j] << setw(14) << setprecision(1)
+                 << find * 1e9 / probes.size() << setw(12)
+                 << setprecision(3) << stats.hit_rate() << "   (" << sum
+                 << ")" << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Name        : findnear_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Looks up keys that wander a few positions at a time through
+ *               a loaded RedBlackTree, with find() from the root, with
+ *               find_near() from the previous result and with a cursor, for
+ *               several step sizes, then with uniformly random keys.
+ *               Usage: findnear_bench [keys] [lookups]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+typedef RedBlackTree<int, int> Tree_t;
+
+/**
+ * Returns lookups keys, each at most step positions from the one before, or
+ * uniformly random keys if step is 0. Keys are even; one in four lookups is
+ * for an odd key, which misses.
+ */
+vector<int> make_lookups(size_t n, size_t lookups, int step, mt19937 &rng) {
+    uniform_int_distribution<int> jump(-step, step), any(0,
+            static_cast<int>(n) - 1), miss(0, 3);
+    vector<int> keys(lookups);
+    int pos = static_cast<int>(n / 2);
+    for (size_t i = 0; i < lookups; ++i) {
+        pos = step == 0 ? any(rng) :
+                min(max(pos + jump(rng), 0), static_cast<int>(n) - 1);
+        keys[i] = 2 * pos + (miss(rng) == 0);
+    }
+    return keys;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 2000000;
+    mt19937 rng(49);
+    vector<int> loaded(n);
+    for (size_t i = 0; i < n; ++i) {
+        loaded[i] = static_cast<int>(2 * i);
+    }
+    shuffle(loaded.begin(), loaded.end(), rng);
+    Tree_t tree;
+    for (size_t i = 0; i < n; ++i) {
+        tree.insert(loaded[i], loaded[i]);
+    }
+
+    cout << n << " keys, " << lookups << " lookups per step size" << endl
+         << endl;
+    cout << setw(10) << "step" << setw(12) << "find ns" << setw(16)
+         << "find_near ns" << setw(14) << "cursor ns" << endl;
+    const int steps[] = { 1, 16, 256, 4096, 0 };
+    for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); ++s) {
+        vector<int> keys = make_lookups(n, lookups, steps[s], rng);
+        long long found[3] = { 0, 0, 0 };
+
+        bench_clock::time_point start = bench_clock::now();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            found[0] += tree.find(keys[i]) != tree.end();
+        }
+        double root = seconds_since(start);
+
+        start = bench_clock::now();
+        Tree_t::iterator hint = tree.end();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            Tree_t::iterator it = tree.find_near(hint, keys[i]);
+            if (it != tree.end()) {
+                hint = it;
+                ++found[1];
+            }
+        }
+        double hinted = seconds_since(start);
+
+        start = bench_clock::now();
+        Tree_t::cursor cursor(tree);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            found[2] += cursor.find(keys[i]) != tree.end();
+        }
+        double cursored = seconds_since(start);
+
+        cout << setw(10);
+        if (steps[s] > 0) {
+            cout << steps[s];
+        } else {
+            cout << "random";
+        }
+        cout << fixed << setprecision(1) << setw(12)
+             << root * 1e9 / lookups << setw(16) << hinted * 1e9 / lookups
+             << setw(14) << cursored * 1e9 / lookups
+             << (found[0] == found[1] && found[1] == found[2] ?
+                     "" : "  MISMATCH") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Name        : fixedtree_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Keeps a RedBlackTree and a FixedRedBlackTree near capacity
+ *               with random erase and insert pairs, timing each operation on
+ *               its own, and prints the mean, 99th and 99.9th percentile and
+ *               worst latency of each.
+ *               Usage: fixedtree_bench [operations]
+ ******************************************************************************/
+#include "../fixedtree.h"
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double nanoseconds_since(bench_clock::time_point start) {
+    return chrono::duration<double, nano>(bench_clock::now() - start).count();
+}
+
+const size_t CAPACITY = 50000;
+
+typedef FixedRedBlackTree<int, int, CAPACITY> Fixed;
+
+// Static, so the fixed tree costs nothing to set up and no stack.
+Fixed fixed_tree;
+
+struct Dynamic {
+    RedBlackTree<int, int> tree;
+
+    void insert(int key) {
+        tree.insert(key, key);
+    }
+
+    void erase(int key) {
+        tree.erase(key);
+    }
+};
+
+struct Static {
+    void insert(int key) {
+        fixed_tree.insert(key, key);
+    }
+
+    void erase(int key) {
+        fixed_tree.erase(key);
+    }
+};
+
+void report(const char *name, vector<double> &ns) {
+    double sum = 0;
+    for (size_t i = 0; i < ns.size(); ++i) {
+        sum += ns[i];
+    }
+    sort(ns.begin(), ns.end());
+    cout << setw(24) << name << fixed << setprecision(0) << setw(10)
+         << sum / ns.size() << setw(10) << ns[ns.size() * 99 / 100]
+         << setw(10) << ns[ns.size() * 999 / 1000] << setw(12) << ns.back()
+         << endl;
+}
+
+/**
+ * Fills the tree to capacity, then erases a random key and inserts a new one
+ * ops times.
+ */
+template<typename T>
+void run(const char *name, T &tree, size_t ops) {
+    mt19937 rng(48);
+    vector<int> keys(CAPACITY);
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        keys[i] = static_cast<int>(2 * i);
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        tree.insert(keys[i]);
+    }
+    uniform_int_distribution<size_t> slot(0, CAPACITY - 1);
+    int next = static_cast<int>(2 * CAPACITY);
+    vector<double> inserts(ops), erases(ops);
+    for (size_t i = 0; i < ops; ++i) {
+        size_t s = slot(rng);
+        bench_clock::time_point start = bench_clock::now();
+        tree.erase(keys[s]);
+        erases[i] = nanoseconds_since(start);
+        next += 2 * static_cast<int>(slot(rng) % 8) + 1;
+        keys[s] = next;
+        start = bench_clock::now();
+        tree.insert(keys[s]);
+        inserts[i] = nanoseconds_since(start);
+    }
+    string label(name);
+    report((label + " erase").c_str(), erases);
+    report((label + " insert").c_str(), inserts);
+}
+
+int main(int argc, char *argv[]) {
+    size_t ops = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000000;
+
+    cout << CAPACITY << " keys, " << ops << " erase and insert pairs" << endl
+         << endl;
+    cout << setw(24) << "" << setw(10) << "mean ns" << setw(10) << "p99"
+         << setw(10) << "p99.9" << setw(12) << "max" << endl;
+    Dynamic dynamic;
+    run("RedBlackTree", dynamic, ops);
+    Static fixed;
+    run("FixedRedBlackTree", fixed, ops);
+    cout << (fixed_tree.size() == dynamic.tree.size() ? "" : "MISMATCH\n");
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Name        : journal_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Measures MutationJournal: durable inserts per second and
+ *               records per fsync as the number of writer threads grows, and
+ *               recovery time for a log of random inserts against the sorted
+ *               log a checkpoint leaves.
+ *               Usage: journal_bench [keys] [journal path]
+ ******************************************************************************/
+#include "../journal.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+const size_t SYNCED_RECORDS = 4000;
+
+/**
+ * Each writer logs its share of the records, waiting for each one to be
+ * durable before logging the next, as a server acknowledging requests would.
+ */
+struct Writer {
+    MutationJournal<int, int> *journal;
+    int first;
+    size_t count;
+
+    void operator()() const {
+        for (size_t i = 0; i < count; ++i) {
+            int key = first + static_cast<int>(i);
+            journal->sync(journal->log_insert(key, key));
+        }
+    }
+};
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    string path = argc > 2 ? argv[2] : "journal_bench.log";
+
+    cout << SYNCED_RECORDS << " records, each synced before the next"
+         << endl << endl;
+    cout << setw(10) << "threads" << setw(16) << "records/s" << setw(18)
+         << "records/fsync" << endl;
+    const unsigned threads[] = { 1, 2, 4, 8, 16 };
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+        remove(path.c_str());
+        MutationJournal<int, int> journal(path);
+        vector<thread> workers;
+        size_t share = SYNCED_RECORDS / threads[t];
+        bench_clock::time_point start = bench_clock::now();
+        for (unsigned i = 0; i < threads[t]; ++i) {
+            Writer w = { &journal, static_cast<int>(i * share), share };
+            workers.push_back(thread(w));
+        }
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+        double elapsed = seconds_since(start);
+        JournalStats stats = journal.stats();
+        cout << setw(10) << threads[t] << setw(16) << fixed
+             << setprecision(0) << stats.records / elapsed << setw(18)
+             << setprecision(1) << stats.records_per_sync() << endl;
+    }
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(i);
+    }
+    mt19937 rng(29);
+    shuffle(keys.begin(), keys.end(), rng);
+    remove(path.c_str());
+    RedBlackTree<int, int> tree;
+    {
+        MutationJournal<int, int> journal(path);
+        for (size_t i = 0; i < n; ++i) {
+            tree.insert(keys[i], keys[i]);
+            journal.log_insert(keys[i], keys[i]);
+        }
+        journal.sync();
+    }
+
+    cout << endl << n << " keys" << endl << endl;
+    cout << setw(22) << "log" << setw(14) << "replay (ms)" << setw(14)
+         << "bulk loaded" << endl;
+    for (int sorted = 0; sorted < 2; ++sorted) {
+        if (sorted) {
+            MutationJournal<int, int> journal(path);
+            journal.checkpoint(tree);
+        }
+        RedBlackTree<int, int> recovered;
+        bench_clock::time_point start = bench_clock::now();
+        JournalReplayStats stats = MutationJournal<int, int>::replay(path,
+                recovered);
+        double replay = seconds_since(start);
+        cout << setw(22) << (sorted ? "after checkpoint" : "random inserts")
+             << setw(14) << setprecision(1) << replay * 1e3 << setw(14)
+             << stats.bulk_loaded
+             << (recovered.size() == tree.size() ? "" : "  MISMATCH")
+             << endl;
+    }
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Name        : lazyerase_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Runs bursts of erases, each followed by a burst of inserts
+ *               that refill the tree, with eager erase and with lazy erase at
+ *               several tombstone thresholds, and measures the erases, the
+ *               inserts and random finds between bursts. The tree is refilled
+ *               once with new keys and once with the keys just erased.
+ *               Usage: lazyerase_bench [keys] [bursts] [erases per burst]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+void run(double threshold, size_t n, size_t bursts, size_t burst,
+        bool same_keys) {
+    mt19937 rng(43);
+    uniform_int_distribution<int> key(0, static_cast<int>(4 * n));
+    RedBlackTree<int, int> tree;
+    tree.set_lazy_erase(threshold);
+    vector<int> live;
+    while (tree.size() < n) {
+        int k = key(rng);
+        if (tree.find(k) == tree.end()) {
+            tree.insert(k, k);
+            live.push_back(k);
+        }
+    }
+    double erasing = 0, inserting = 0, finding = 0;
+    long long found = 0;
+    for (size_t b = 0; b < bursts; ++b) {
+        shuffle(live.begin(), live.end(), rng);
+        bench_clock::time_point start = bench_clock::now();
+        for (size_t i = 0; i < burst; ++i) {
+            tree.erase(live[live.size() - 1 - i]);
+        }
+        erasing += seconds_since(start);
+        vector<int> fresh;
+        if (same_keys) {
+            fresh.assign(live.end() - burst, live.end());
+        }
+        live.resize(live.size() - burst);
+        while (fresh.size() < burst) {
+            int k = key(rng);
+            if (tree.find(k) == tree.end()) {
+                fresh.push_back(k);
+            }
+        }
+        start = bench_clock::now();
+        for (size_t i = 0; i < fresh.size(); ++i) {
+            try {
+                tree.insert(fresh[i], fresh[i]);
+                live.push_back(fresh[i]);
+            } catch (const tree_exception &) {
+            }
+        }
+        inserting += seconds_since(start);
+
+        start = bench_clock::now();
+        for (size_t i = 0; i < burst; ++i) {
+            found += tree.find(key(rng)) != tree.end();
+        }
+        finding += seconds_since(start);
+    }
+    size_t ops = bursts * burst;
+    cout << setw(12) << fixed;
+    if (threshold > 0) {
+        cout << setprecision(2) << threshold;
+    } else {
+        cout << "eager";
+    }
+    cout << setw(12) << setprecision(1) << erasing * 1e9 / ops << setw(12)
+         << inserting * 1e9 / ops << setw(12) << finding * 1e9 / ops
+         << setw(14) << tree.tombstone_count() << "   (" << found % 10 << ")"
+         << endl;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t bursts = argc > 2 ? strtoul(argv[2], NULL, 10) : 20;
+    size_t burst = argc > 3 ? strtoul(argv[3], NULL, 10) : 100000;
+    burst = min(burst, n);
+
+    cout << n << " keys, " << bursts << " bursts of " << burst
+         << " erases then " << burst << " inserts" << endl;
+    const double thresholds[] = { 0, 0.1, 0.25, 0.5 };
+    for (int same_keys = 0; same_keys < 2; ++same_keys) {
+        cout << endl << (same_keys ? "Erased keys" : "New keys")
+             << " inserted" << endl;
+        cout << setw(12) << "threshold" << setw(12) << "erase ns"
+             << setw(12) << "insert ns" << setw(12) << "find ns" << setw(14)
+             << "tombstones" << endl;
+        for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]);
+                ++t) {
+            run(thresholds[t], n, bursts, burst, same_keys);
+        }
+    }
+    return 0;
+}
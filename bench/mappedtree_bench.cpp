@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * Name        : mappedtree_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Builds a MappedRedBlackTree in a file and an
+ *               IndexedRedBlackTree saved with write(), then times reopening
+ *               the file against reading the saved tree back in, and random
+ *               finds in each, with a RedBlackTree as the baseline.
+ *               Usage: mappedtree_bench [keys] [directory]
+ ******************************************************************************/
+#include "../indextree.h"
+#include "../mappedtree.h"
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+typedef MappedRedBlackTree<long long, long long> Mapped;
+typedef IndexedRedBlackTree<long long, long long> Indexed;
+
+/**
+ * Prints one line of results; open is negative for a tree with no file.
+ */
+void row(const string &name, double build, double open, double find,
+        size_t n, size_t finds) {
+    cout << setw(16) << name << fixed << setprecision(1) << setw(14)
+         << build * 1e9 / n << setw(12);
+    if (open >= 0) {
+        cout << open * 1e3;
+    } else {
+        cout << "-";
+    }
+    cout << setw(12) << find * 1e9 / finds << endl;
+}
+
+template<typename T>
+double time_finds(T &tree, const vector<long long> &keys, long long &found) {
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        found += tree.find(keys[i]) != tree.end();
+    }
+    return seconds_since(start);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000000;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+    string mapped_path = dir + "/mappedtree_bench.rbt";
+    string indexed_path = dir + "/mappedtree_bench.idx";
+    mt19937_64 rng(50);
+    vector<long long> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<long long>(2 * i);
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<long long> lookups(n);
+    uniform_int_distribution<long long> key(0, static_cast<long long>(2 * n));
+    for (size_t i = 0; i < n; ++i) {
+        lookups[i] = key(rng);
+    }
+    long long found[3] = { 0, 0, 0 };
+
+    cout << n << " keys, " << n << " random finds, files in " << dir << endl
+         << endl;
+    cout << setw(16) << "" << setw(14) << "insert ns" << setw(12)
+         << "open ms" << setw(12) << "find ns" << endl;
+
+    bench_clock::time_point start = bench_clock::now();
+    RedBlackTree<long long, long long> tree;
+    for (size_t i = 0; i < n; ++i) {
+        tree.insert(keys[i], keys[i]);
+    }
+    double build = seconds_since(start);
+    row("RedBlackTree", build, -1, time_finds(tree, lookups, found[0]), n, n);
+
+    ::unlink(indexed_path.c_str());
+    start = bench_clock::now();
+    {
+        Indexed indexed;
+        for (size_t i = 0; i < n; ++i) {
+            indexed.insert(keys[i], keys[i]);
+        }
+        ofstream out(indexed_path.c_str(), ios::binary);
+        indexed.write(out);
+    }
+    build = seconds_since(start);
+    start = bench_clock::now();
+    Indexed indexed;
+    ifstream in(indexed_path.c_str(), ios::binary);
+    indexed.read(in);
+    double open = seconds_since(start);
+    row("Indexed + read", build, open, time_finds(indexed, lookups, found[1]),
+            n, n);
+
+    ::unlink(mapped_path.c_str());
+    start = bench_clock::now();
+    {
+        Mapped mapped(mapped_path);
+        for (size_t i = 0; i < n; ++i) {
+            mapped.insert(keys[i], keys[i]);
+        }
+    }
+    build = seconds_since(start);
+    start = bench_clock::now();
+    Mapped mapped(mapped_path);
+    open = seconds_since(start);
+    row("Mapped", build, open, time_finds(mapped, lookups, found[2]), n, n);
+
+    cout << (found[0] == found[1] && found[1] == found[2] ? "" : "MISMATCH\n");
+    ::unlink(indexed_path.c_str());
+    ::unlink(mapped_path.c_str());
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Name        : merkle_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Compares two replicas built in different orders with d
+ *               changed values, first by a merged in-order scan and then by
+ *               AugmentedRedBlackTree::diff over MerkleMonoid digests.
+ *               Usage: merkle_bench [keys]
+ ******************************************************************************/
+#include "../augmentedtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+typedef AugmentedRedBlackTree<int, int, MerkleMonoid<int, int> > replica;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+struct Counter {
+    size_t *count;
+
+    void operator()(const int &) const {
+        ++*count;
+    }
+};
+
+/**
+ * Counts the keys whose pairs differ by walking both trees in key order.
+ */
+size_t scan_diff(const replica &a, const replica &b) {
+    size_t count = 0;
+    replica::iterator i = a.begin(), j = b.begin();
+    while (i != a.end() || j != b.end()) {
+        if (j == b.end() || (i != a.end() && i->key() < j->key())) {
+            ++count;
+            ++i;
+        } else if (i == a.end() || j->key() < i->key()) {
+            ++count;
+            ++j;
+        } else {
+            count += i->value() != j->value();
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(i);
+    }
+    mt19937 rng(23);
+    replica a, b;
+    shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < n; ++i) {
+        a.insert(keys[i], keys[i]);
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < n; ++i) {
+        b.insert(keys[i], keys[i]);
+    }
+
+    cout << n << " keys per replica" << endl << endl;
+    cout << setw(10) << "changes" << setw(14) << "scan (ms)" << setw(14)
+         << "diff (ms)" << setw(10) << "found" << endl;
+    size_t changed = 0;
+    const size_t targets[] = { 1, 10, 100, 1000, 10000 };
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t) {
+        for (; changed < targets[t]; ++changed) {
+            b.set_value(b.find(keys[changed]), -1);
+        }
+        bench_clock::time_point start = bench_clock::now();
+        size_t scanned = scan_diff(a, b);
+        double scan = seconds_since(start);
+        size_t found = 0;
+        Counter counter = { &found };
+        start = bench_clock::now();
+        a.diff(b, counter);
+        double diff = seconds_since(start);
+        cout << setw(10) << changed << setw(14) << fixed << setprecision(2)
+             << scan * 1e3 << setw(14) << diff * 1e3 << setw(10) << found
+             << (found == scanned ? "" : "  MISMATCH") << endl;
+    }
+    return 0;
+}
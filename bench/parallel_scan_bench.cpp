@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Name        : parallel_scan_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Sums every value of a RedBlackTree with the iterator, then
+ *               with parallel_reduce() and parallel_for_each() on 1 to 16
+ *               threads.
+ *               Usage: parallel_scan_bench [keys] [repeats]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+struct Value {
+    long long operator()(const int &, const int &value) const {
+        return value;
+    }
+};
+
+struct Add {
+    long long operator()(long long a, long long b) const {
+        return a + b;
+    }
+};
+
+/**
+ * parallel_for_each() has no per-piece state, so a total has to go through
+ * one shared counter.
+ */
+struct SharedSum {
+    atomic<long long> *sum;
+
+    void operator()(const int &, const int &value) const {
+        sum->fetch_add(value, memory_order_relaxed);
+    }
+};
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 4000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 5;
+    mt19937 rng(53);
+    uniform_int_distribution<int> key(0, static_cast<int>(4 * n));
+    RedBlackTree<int, int> tree;
+    while (tree.size() < n) {
+        int k = key(rng);
+        if (tree.find(k) == tree.end()) {
+            tree.insert(k, k % 1000);
+        }
+    }
+
+    cout << n << " keys, best of " << repeats << "; "
+         << thread::hardware_concurrency() << " hardware threads" << endl
+         << endl;
+    cout << setw(10) << "threads" << setw(14) << "iterator ms" << setw(14)
+         << "reduce ms" << setw(16) << "for_each ms" << endl;
+    const unsigned threads[] = { 1, 2, 4, 8, 16 };
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+        double best[3] = { 1e9, 1e9, 1e9 };
+        long long sums[3] = { 0, 0, 0 };
+        for (int r = 0; r < repeats; ++r) {
+            bench_clock::time_point start = bench_clock::now();
+            long long sum = 0;
+            for (RedBlackTree<int, int>::iterator it = tree.begin();
+                    it != tree.end(); ++it) {
+                sum += it->second;
+            }
+            best[0] = min(best[0], seconds_since(start));
+            sums[0] = sum;
+
+            start = bench_clock::now();
+            sums[1] = tree.parallel_reduce(0LL, Value(), Add(), threads[t]);
+            best[1] = min(best[1], seconds_since(start));
+
+            atomic<long long> shared(0);
+            SharedSum add = { &shared };
+            start = bench_clock::now();
+            tree.parallel_for_each(add, threads[t]);
+            best[2] = min(best[2], seconds_since(start));
+            sums[2] = shared.load();
+        }
+        cout << setw(10) << threads[t] << fixed << setprecision(1)
+             << setw(14) << best[0] * 1e3 << setw(14) << best[1] * 1e3
+             << setw(16) << best[2] * 1e3
+             << (sums[0] == sums[1] && sums[1] == sums[2] ? "" : "  MISMATCH")
+             << endl;
+    }
+    return 0;
+}
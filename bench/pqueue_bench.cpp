@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Name        : pqueue_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Uses a RedBlackTree keyed by expiry time as a timer queue:
+ *               each tick arms new timers and then removes every timer that
+ *               is due, with begin() and erase(), with pop_min(), and with
+ *               one pop_while() per tick. Only the removals are timed.
+ *               Usage: pqueue_bench [pending timers] [ticks] [timers per tick]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+typedef RedBlackTree<long long, int> Timers;
+
+struct Expired {
+    long long *sum;
+
+    void operator()(const long long &, const int &id) const {
+        *sum += id;
+    }
+};
+
+/**
+ * Arms the same timers in the same order for each method. Expiry times are
+ * unique: a timer's deadline is shifted by its id in the low bits.
+ */
+class Workload {
+public:
+    Workload(size_t pending, size_t ticks, size_t per_tick) :
+            pending_(pending), ticks_(ticks), per_tick_(per_tick) {
+    }
+
+    /**
+     * Returns the seconds spent expiring timers, leaving out the inserts.
+     */
+    template<typename Expire>
+    double run(Expire expire, long long &sum) const {
+        mt19937 rng(41);
+        uniform_int_distribution<long long> delay(1,
+                2 * static_cast<long long>(pending_ / per_tick_));
+        Timers timers;
+        int id = 0;
+        for (size_t i = 0; i < pending_; ++i, ++id) {
+            timers.insert(deadline(delay(rng), id), id);
+        }
+        sum = 0;
+        double elapsed = 0;
+        for (size_t now = 1; now <= ticks_; ++now) {
+            for (size_t i = 0; i < per_tick_; ++i, ++id) {
+                timers.insert(deadline(now + delay(rng), id), id);
+            }
+            bench_clock::time_point start = bench_clock::now();
+            expire(timers, deadline(now + 1, 0) - 1, sum);
+            elapsed += seconds_since(start);
+        }
+        return elapsed;
+    }
+
+private:
+    size_t pending_, ticks_, per_tick_;
+
+    static long long deadline(long long tick, int id) {
+        return (tick << 32) | static_cast<unsigned>(id);
+    }
+};
+
+void by_erase(Timers &timers, long long now, long long &sum) {
+    while (timers.size() > 0 && timers.begin()->first <= now) {
+        Timers::iterator it = timers.begin();
+        sum += it->second;
+        timers.erase(it->first);
+    }
+}
+
+void by_pop_min(Timers &timers, long long now, long long &sum) {
+    while (timers.size() > 0 && timers.peek_min()->first <= now) {
+        sum += timers.pop_min().second;
+    }
+}
+
+void by_pop_while(Timers &timers, long long now, long long &sum) {
+    Expired fn = { &sum };
+    timers.pop_while(now, fn);
+}
+
+int main(int argc, char *argv[]) {
+    size_t pending = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t ticks = argc > 2 ? strtoul(argv[2], NULL, 10) : 200;
+    size_t per_tick = argc > 3 ? strtoul(argv[3], NULL, 10) : 10000;
+    Workload workload(pending, ticks, per_tick);
+
+    cout << pending << " pending timers, " << ticks << " ticks of "
+         << per_tick << " new timers" << endl << endl;
+    cout << setw(16) << "method" << setw(12) << "expiry ms" << setw(18)
+         << "ns per expiry" << endl;
+    const char *names[] = { "begin + erase", "pop_min", "pop_while" };
+    void (*methods[])(Timers &, long long, long long &) = { by_erase,
+            by_pop_min, by_pop_while };
+    for (size_t m = 0; m < 3; ++m) {
+        long long sum;
+        double elapsed = workload.run(methods[m], sum);
+        cout << setw(16) << names[m] << setw(12) << fixed << setprecision(1)
+             << elapsed * 1e3 << setw(18) << elapsed * 1e9 / (ticks * per_tick)
+             << "   (" << sum % 10 << ")" << endl;
+    }
+    return 0;
+}
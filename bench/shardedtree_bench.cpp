@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * Name        : shardedtree_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Measures throughput of a mixed insert/find/erase workload
+ *               from 1 to 64 threads, on one RedBlackTree behind one mutex
+ *               and on ShardedRedBlackTree.
+ *               Usage: shardedtree_bench [keys] [ops per thread] [shards]
+ ******************************************************************************/
+#include "../shardedtree.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/**
+ * One RedBlackTree and one mutex, the setup the sharded tree replaces.
+ */
+class LockedTree {
+public:
+    void insert(int key, int value) {
+        lock_guard<mutex> lock(mutex_);
+        tree_.insert(key, value);
+    }
+
+    bool find(int key, int &value) {
+        lock_guard<mutex> lock(mutex_);
+        RedBlackTree<int, int>::iterator it = tree_.find(key);
+        if (it == tree_.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    bool erase(int key) {
+        lock_guard<mutex> lock(mutex_);
+        return tree_.erase(key);
+    }
+
+private:
+    mutex mutex_;
+    RedBlackTree<int, int> tree_;
+};
+
+/**
+ * Each thread draws random keys: 80% finds, 10% inserts, 10% erases.
+ */
+template<typename Map>
+struct Worker {
+    Map *map;
+    int keys;
+    size_t ops;
+    unsigned seed;
+    long long *found;
+
+    void operator()() const {
+        mt19937 rng(seed);
+        uniform_int_distribution<int> key(0, keys - 1);
+        uniform_int_distribution<int> op(0, 9);
+        long long hits = 0;
+        for (size_t i = 0; i < ops; ++i) {
+            int k = key(rng), o = op(rng), value;
+            if (o == 0) {
+                try {
+                    map->insert(k, k);
+                } catch (const tree_exception &) {
+                }
+            } else if (o == 1) {
+                map->erase(k);
+            } else {
+                hits += map->find(k, value);
+            }
+        }
+        *found = hits;
+    }
+};
+
+template<typename Map>
+double run(Map &map, int keys, unsigned threads, size_t ops) {
+    vector<thread> workers;
+    vector<long long> found(threads);
+    bench_clock::time_point start = bench_clock::now();
+    for (unsigned i = 0; i < threads; ++i) {
+        Worker<Map> w = { &map, keys, ops, i + 1, &found[i] };
+        workers.push_back(thread(w));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    return threads * ops / seconds_since(start);
+}
+
+int main(int argc, char *argv[]) {
+    int keys = argc > 1 ? atoi(argv[1]) : 1000000;
+    size_t ops = argc > 2 ? strtoul(argv[2], NULL, 10) : 200000;
+    size_t shards = argc > 3 ? strtoul(argv[3], NULL, 10) : 64;
+
+    vector<int> sample;
+    mt19937 rng(31);
+    uniform_int_distribution<int> key(0, keys - 1);
+    for (int i = 0; i < 10000; ++i) {
+        sample.push_back(key(rng));
+    }
+    vector<int> splits = ShardedRedBlackTree<int, int>::choose_splits(sample,
+            shards);
+
+    cout << keys << " key range, half loaded; " << ops << " ops per thread; "
+         << splits.size() + 1 << " shards; "
+         << thread::hardware_concurrency() << " hardware threads" << endl
+         << endl;
+    cout << setw(10) << "threads" << setw(18) << "one lock (Mops/s)"
+         << setw(18) << "sharded (Mops/s)" << endl;
+    const unsigned threads[] = { 1, 2, 4, 8, 16, 32, 64 };
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+        LockedTree locked;
+        ShardedRedBlackTree<int, int> sharded(splits);
+        for (int i = 0; i < keys; i += 2) {
+            locked.insert(i, i);
+            sharded.insert(i, i);
+        }
+        double one = run(locked, keys, threads[t], ops);
+        double many = run(sharded, keys, threads[t], ops);
+        cout << setw(10) << threads[t] << setw(18) << fixed
+             << setprecision(2) << one / 1e6 << setw(18) << many / 1e6
+             << endl;
+    }
+    return 0;
+}
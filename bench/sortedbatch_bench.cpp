@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * Name        : sortedbatch_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Inserts and then erases sorted batches of random new keys in
+ *               a loaded RedBlackTree, one key at a time from the root and
+ *               with insert_sorted_batch() and erase_sorted_batch(), for
+ *               several batch sizes, with int keys and with string keys.
+ *               Usage: sortedbatch_bench [keys] [batches per size]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+void make_key(int i, int &key) {
+    key = i;
+}
+
+/**
+ * Zero-padded, so that string order is number order, behind a prefix that
+ * every comparison has to get past.
+ */
+void make_key(int i, string &key) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "customer/%010d", i);
+    key = buf;
+}
+
+/**
+ * Returns up to size sorted odd keys; the tree holds only even ones.
+ */
+template<typename K>
+vector<pair<K, int> > make_batch(size_t size, int range, mt19937 &rng) {
+    uniform_int_distribution<int> number(0, range / 2 - 1);
+    vector<int> numbers(size);
+    for (size_t i = 0; i < size; ++i) {
+        numbers[i] = 2 * number(rng) + 1;
+    }
+    sort(numbers.begin(), numbers.end());
+    numbers.erase(unique(numbers.begin(), numbers.end()), numbers.end());
+    vector<pair<K, int> > batch(numbers.size());
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        make_key(numbers[i], batch[i].first);
+        batch[i].second = numbers[i];
+    }
+    return batch;
+}
+
+template<typename K>
+void run(const string &name, size_t n, size_t batches) {
+    int range = static_cast<int>(4 * n);
+    mt19937 rng(47);
+    vector<int> loaded(n);
+    for (size_t i = 0; i < n; ++i) {
+        loaded[i] = static_cast<int>(2 * i);
+    }
+    shuffle(loaded.begin(), loaded.end(), rng);
+    RedBlackTree<K, int> tree;
+    for (size_t i = 0; i < n; ++i) {
+        K key;
+        make_key(loaded[i], key);
+        tree.insert(key, loaded[i]);
+    }
+
+    cout << endl << name << " keys" << endl;
+    cout << setw(10) << "batch" << setw(14) << "insert ns" << setw(14)
+         << "batch ns" << setw(14) << "erase ns" << setw(14) << "batch ns"
+         << endl;
+    const size_t sizes[] = { 1000, 10000, 100000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        double one[2] = { 0, 0 }, batched[2] = { 0, 0 };
+        size_t keys = 0;
+        for (size_t b = 0; b < batches; ++b) {
+            // Each method gets its own batch, so neither runs over paths
+            // the other has just brought into cache.
+            for (int batched_run = 0; batched_run < 2; ++batched_run) {
+                vector<pair<K, int> > batch = make_batch<K>(sizes[s], range,
+                        rng);
+                vector<K> batch_keys;
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    batch_keys.push_back(batch[i].first);
+                }
+                keys += batched_run * batch.size();
+                double *t = batched_run ? batched : one;
+
+                bench_clock::time_point start = bench_clock::now();
+                if (batched_run) {
+                    tree.insert_sorted_batch(batch.begin(), batch.end());
+                } else {
+                    for (size_t i = 0; i < batch.size(); ++i) {
+                        tree.insert(batch[i].first, batch[i].second);
+                    }
+                }
+                t[0] += seconds_since(start);
+                start = bench_clock::now();
+                if (batched_run) {
+                    tree.erase_sorted_batch(batch_keys.begin(),
+                            batch_keys.end());
+                } else {
+                    for (size_t i = 0; i < batch_keys.size(); ++i) {
+                        tree.erase(batch_keys[i]);
+                    }
+                }
+                t[1] += seconds_since(start);
+            }
+        }
+        cout << setw(10) << sizes[s] << fixed << setprecision(1);
+        for (int op = 0; op < 2; ++op) {
+            cout << setw(14) << one[op] * 1e9 / keys << setw(14)
+                 << batched[op] * 1e9 / keys;
+        }
+        cout << (tree.size() == n ? "" : "  MISMATCH") << endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t batches = argc > 2 ? strtoul(argv[2], NULL, 10) : 10;
+
+    cout << n << " keys, " << batches << " sorted batches per size" << endl;
+    run<int>("int", n, batches);
+    run<string>("string", n, batches);
+    return 0;
+}
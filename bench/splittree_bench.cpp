@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Name        : splittree_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Compares RedBlackTree<int, Record> with SplitRedBlackTree<int,
+ *               Record> for a 256-byte Record: bytes per node, build time
+ *               and lookup time for hits (which read the value) and misses.
+ *               Usage: splittree_bench [keys]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include "../splittree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+struct Record {
+    long long id;
+    char payload[248];
+};
+
+/**
+ * Needed by to_ascii_drawing(), which every Tree instantiates.
+ */
+ostream& operator<<(ostream &os, const Record &r) {
+    return os << "#" << r.id;
+}
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+template<typename T>
+void run(const char *name, size_t node_bytes, const vector<int> &keys,
+        const vector<int> &hits, const vector<int> &misses) {
+    T tree;
+    Record r = Record();
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        r.id = keys[i];
+        tree.insert(keys[i], r);
+    }
+    double build = seconds_since(start);
+
+    long long sum = 0;
+    start = bench_clock::now();
+    for (size_t i = 0; i < hits.size(); ++i) {
+        sum += (*tree.find(hits[i])).second.id;
+    }
+    double hit = seconds_since(start);
+
+    size_t found = 0;
+    start = bench_clock::now();
+    for (size_t i = 0; i < misses.size(); ++i) {
+        found += tree.find(misses[i]) != tree.end();
+    }
+    double miss = seconds_since(start);
+
+    cout << setw(22) << left << name << setw(10) << right << node_bytes
+         << setw(14) << fixed << setprecision(1) << build * 1e3 << setw(14)
+         << hit * 1e9 / hits.size() << setw(14) << miss * 1e9 / misses.size()
+         << "   (" << sum << ", " << found << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 500000;
+    vector<int> keys(n), misses(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(i * 2);
+        misses[i] = static_cast<int>(i * 2 + 1);
+    }
+    mt19937 rng(13);
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<int> hits(keys);
+    shuffle(hits.begin(), hits.end(), rng);
+    shuffle(misses.begin(), misses.end(), rng);
+
+    cout << n << " keys, " << sizeof(Record) << "-byte values" << endl << endl;
+    cout << setw(22) << left << "tree" << setw(10) << right << "node B"
+         << setw(14) << "build (ms)" << setw(14) << "hit (ns)" << setw(14)
+         << "miss (ns)" << endl;
+    run<RedBlackTree<int, Record> >("RedBlackTree",
+            sizeof(RedBlackNode<int, Record>), keys, hits, misses);
+    run<SplitRedBlackTree<int, Record> >("SplitRedBlackTree",
+            sizeof(SplitNode<int>), keys, hits, misses);
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * Name        : stringtree_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Compares RedBlackTree<string, int> with StringKeyTree<int> on
+ *               a word list: bytes held by live nodes and their keys, build
+ *               time and lookup time.
+ *               Usage: stringtree_bench [word-file]
+ *               Without a file, 200000 synthetic words are generated.
+ ******************************************************************************/
+#include "../rbtree.h"
+#include "../stringtree.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/**
+ * Reads one word per line, dropping duplicates.
+ */
+vector<string> read_words(const char *path) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "Error: Cannot open '" << path << "'." << endl;
+        exit(1);
+    }
+    vector<string> words;
+    string word;
+    while (getline(in, word)) {
+        if (!word.empty()) {
+            words.push_back(word);
+        }
+    }
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+/**
+ * Generates lowercase words of 3 to 14 letters, drawn so that many share
+ * their first few letters, as dictionary words do.
+ */
+vector<string> synthetic_words(size_t n) {
+    mt19937 rng(42);
+    uniform_int_distribution<int> length(3, 14), letter(0, 25);
+    vector<string> stems;
+    for (int i = 0; i < 2000; ++i) {
+        string stem;
+        for (int j = 0, len = length(rng) / 2 + 1; j < len; ++j) {
+            stem += static_cast<char>('a' + letter(rng));
+        }
+        stems.push_back(stem);
+    }
+    uniform_int_distribution<size_t> pick(0, stems.size() - 1);
+    vector<string> words;
+    while (words.size() < n) {
+        string word = stems[pick(rng)];
+        for (int j = 0, len = length(rng) / 2; j < len; ++j) {
+            word += static_cast<char>('a' + letter(rng));
+        }
+        words.push_back(word);
+    }
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+/**
+ * Bytes a std::string keeps outside the node for its characters.
+ */
+size_t string_heap_bytes(const string &s) {
+    string empty;
+    return s.capacity() > empty.capacity() ? s.capacity() + 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    vector<string> words =
+            argc > 1 ? read_words(argv[1]) : synthetic_words(200000);
+    mt19937 rng(7);
+    shuffle(words.begin(), words.end(), rng);
+    vector<string> probes(words);
+    shuffle(probes.begin(), probes.end(), rng);
+    for (size_t i = 0, n = words.size() / 4; i < n; ++i) {
+        probes.push_back(words[i] + "#"); // misses
+    }
+
+    size_t key_bytes = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        key_bytes += words[i].size();
+    }
+    cout << words.size() << " words, " << key_bytes << " key bytes, "
+         << probes.size() << " lookups" << endl << endl;
+    cout << setw(24) << left << "tree" << setw(14) << right << "bytes"
+         << setw(14) << "build (ms)" << setw(14) << "find (ns)" << endl;
+
+    size_t found = 0;
+    {
+        RedBlackTree<string, int> rbt;
+        bench_clock::time_point start = bench_clock::now();
+        for (size_t i = 0; i < words.size(); ++i) {
+            rbt.insert(words[i], static_cast<int>(i));
+        }
+        double build = seconds_since(start);
+        start = bench_clock::now();
+        for (size_t i = 0; i < probes.size(); ++i) {
+            found += rbt.find(probes[i]) != rbt.end();
+        }
+        double find = seconds_since(start);
+        size_t bytes = 0;
+        for (RedBlackTree<string, int>::iterator it = rbt.begin();
+                it != rbt.end(); ++it) {
+            bytes += sizeof(RedBlackNode<string, int>)
+                    + string_heap_bytes((*it).first);
+        }
+        cout << setw(24) << left << "RedBlackTree" << setw(14) << right
+             << bytes << setw(14) << fixed << setprecision(1) << build * 1e3
+             << setw(14) << find * 1e9 / probes.size() << endl;
+    }
+    {
+        StringKeyTree<int> skt;
+        bench_clock::time_point start = bench_clock::now();
+        for (size_t i = 0; i < words.size(); ++i) {
+            skt.insert(words[i], static_cast<int>(i));
+        }
+        double build = seconds_since(start);
+        start = bench_clock::now();
+        for (size_t i = 0; i < probes.size(); ++i) {
+            found += skt.find(probes[i]) != skt.end();
+        }
+        double find = seconds_since(start);
+        size_t bytes = skt.size() * sizeof(StringKeyNode<int>) + key_bytes;
+        cout << setw(24) << left << "StringKeyTree" << setw(14) << right
+             << bytes << setw(14) << build * 1e3 << setw(14)
+             << find * 1e9 / probes.size() << endl;
+    }
+    if (found != 2 * words.size()) {
+        cerr << "Error: Trees disagree on lookups." << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Name        : topdowntree_bench.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Compares RedBlackTree<int, int> with TopDownRedBlackTree<int,
+ *               int>: bytes per node, build time, random lookups and a full
+ *               in-order traversal, which climbs parent pointers in the one
+ *               and pops an ancestor stack in the other.
+ *               Usage: topdowntree_bench [keys]
+ ******************************************************************************/
+#include "../rbtree.h"
+#include "../topdowntree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+double seconds_since(bench_clock::time_point start) {
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+template<typename T>
+void run(const char *name, size_t node_bytes, const vector<int> &keys,
+        const vector<int> &probes) {
+    T tree;
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(keys[i], keys[i]);
+    }
+    double build = seconds_since(start);
+
+    size_t found = 0;
+    start = bench_clock::now();
+    for (size_t i = 0; i < probes.size(); ++i) {
+        found += tree.find(probes[i]) != tree.end();
+    }
+    double find = seconds_since(start);
+
+    long long sum = 0;
+    start = bench_clock::now();
+    for (typename T::iterator it = tree.begin(); it != tree.end(); ++it) {
+        sum += (*it).second;
+    }
+    double walk = seconds_since(start);
+
+    cout << setw(22) << left << name << setw(10) << right << node_bytes
+         << setw(14) << fixed << setprecision(1) << build * 1e3 << setw(14)
+         << find * 1e9 / probes.size() << setw(14)
+         << walk * 1e9 / keys.size() << "   (" << found << ", " << sum
+         << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(i * 2);
+    }
+    mt19937 rng(11);
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<int> probes(n);
+    uniform_int_distribution<int> pick(0, static_cast<int>(2 * n));
+    for (size_t i = 0; i < n; ++i) {
+        probes[i] = pick(rng);
+    }
+
+    cout << n << " keys" << endl << endl;
+    cout << setw(22) << left << "tree" << setw(10) << right << "node B"
+         << setw(14) << "build (ms)" << setw(14) << "find (ns)" << setw(14)
+         << "walk (ns)" << endl;
+    run<RedBlackTree<int, int> >("RedBlackTree",
+            sizeof(RedBlackNode<int, int>), keys, probes);
+    run<TopDownRedBlackTree<int, int> >("TopDownRedBlackTree",
+            sizeof(TopDownNode<int, int>), keys, probes);
+    return 0;
+}
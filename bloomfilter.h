@@ -0,0 +1,253 @@
+/*******************************************************************************
+ * Name        : bloomfilter.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Blocked Bloom filter and the policy a tree uses to keep one
+ *               over its keys, so that most lookups of absent keys are
+ *               answered without descending.
+ ******************************************************************************/
+#ifndef BLOOMFILTER_H_
+#define BLOOMFILTER_H_
+
+#include "treehash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Bloom filter whose probes for one key all fall in a single 512-bit block,
+ * the size of a cache line, so a check costs one memory access. Blocks cost
+ * a little accuracy against a plain Bloom filter of the same size.
+ */
+class BlockedBloomFilter {
+public:
+	BlockedBloomFilter() :
+			blocks_(0), probes_(0) {
+	}
+
+	/**
+	 * Sizes the filter for keys keys at bits_per_key bits each and empties
+	 * it. The number of probes is the one that minimizes false positives
+	 * for that density.
+	 */
+	void reset(size_t keys, double bits_per_key) {
+		double bits = std::max(1.0, keys * bits_per_key);
+		blocks_ = static_cast<size_t>(std::ceil(bits / BLOCK_BITS));
+		probes_ = static_cast<unsigned>(bits_per_key * 0.693 + 0.5);
+		probes_ = std::min(std::max(probes_, 1u), 16u);
+		std::vector<uint64_t>(blocks_ * WORDS_PER_BLOCK, 0).swap(words_);
+	}
+
+	/**
+	 * Clears every bit, keeping the size.
+	 */
+	void clear() {
+		std::fill(words_.begin(), words_.end(), 0);
+	}
+
+	void add(uint64_t hash) {
+		uint64_t *block = &words_[block_of(hash) * WORDS_PER_BLOCK];
+		uint32_t h = static_cast<uint32_t>(hash);
+		uint32_t step = (h >> 17) | (h << 15) | 1;
+		for (unsigned i = 0; i < probes_; ++i, h += step)
+			block[(h >> 6) & (WORDS_PER_BLOCK - 1)] |=
+					uint64_t(1) << (h & 63);
+	}
+
+	/**
+	 * Returns false only if hash was never added.
+	 */
+	bool may_contain(uint64_t hash) const {
+		const uint64_t *block = &words_[block_of(hash) * WORDS_PER_BLOCK];
+		uint32_t h = static_cast<uint32_t>(hash);
+		uint32_t step = (h >> 17) | (h << 15) | 1;
+		for (unsigned i = 0; i < probes_; ++i, h += step)
+			if (!(block[(h >> 6) & (WORDS_PER_BLOCK - 1)]
+					& (uint64_t(1) << (h & 63))))
+				return false;
+		return true;
+	}
+
+	size_t bytes() const {
+		return words_.size() * sizeof(uint64_t);
+	}
+
+	unsigned probes() const {
+		return probes_;
+	}
+
+	void swap(BlockedBloomFilter &other) {
+		words_.swap(other.words_);
+		std::swap(blocks_, other.blocks_);
+		std::swap(probes_, other.probes_);
+	}
+
+private:
+	static const size_t BLOCK_BITS = 512;
+	static const size_t WORDS_PER_BLOCK = BLOCK_BITS / 64;
+
+	std::vector<uint64_t> words_;
+	size_t blocks_;
+	unsigned probes_;
+
+	/**
+	 * Maps the high half of the hash onto [0, blocks_) without a division.
+	 */
+	inline size_t block_of(uint64_t hash) const {
+		return static_cast<size_t>(((hash >> 32) * blocks_) >> 32);
+	}
+};
+
+struct BloomFilterStats {
+	uint64_t checks;
+	uint64_t rejections;
+	uint64_t false_positives;
+	uint64_t rebuilds;
+
+	BloomFilterStats() :
+			checks(0), rejections(0), false_positives(0), rebuilds(0) {
+	}
+
+	/**
+	 * Returns the fraction of lookups for absent keys that the filter let
+	 * through to a descent.
+	 */
+	double false_positive_rate() const {
+		uint64_t absent = rejections + false_positives;
+		return absent == 0 ? 0 : (double) false_positives / absent;
+	}
+};
+
+/**
+ * A Bloom filter over the keys of a tree. Inserts add to it directly. An
+ * erased key cannot be removed, so erases are only counted, and the owner
+ * rebuilds the filter from its keys once a quarter of them are stale; it
+ * also rebuilds, at twice the size, when the tree outgrows the filter. Both
+ * keep the cost O(1) amortized per update.
+ */
+template<typename K>
+class KeyBloomFilter {
+public:
+	KeyBloomFilter() :
+			bits_per_key_(0), capacity_(0), erased_(0) {
+	}
+
+	/**
+	 * Sets the density; 0 turns the filter off. The owner must rebuild()
+	 * afterwards.
+	 */
+	void configure(double bits_per_key) {
+		static_assert(is_hashable<K>::value,
+				"the Bloom filter needs std::hash for the key type");
+		bits_per_key_ = bits_per_key > 0 ? bits_per_key : 0;
+		if (bits_per_key_ == 0) {
+			BlockedBloomFilter().swap(filter_);
+			capacity_ = erased_ = 0;
+		}
+	}
+
+	inline bool enabled() const {
+		return bits_per_key_ > 0;
+	}
+
+	double bits_per_key() const {
+		return bits_per_key_;
+	}
+
+	/**
+	 * Returns false if key is certainly not in the tree.
+	 */
+	bool may_contain(const K &key) {
+		++stats_.checks;
+		if (filter_.may_contain(tree_hash(key)))
+			return true;
+		++stats_.rejections;
+		return false;
+	}
+
+	/**
+	 * Records that a key let through by may_contain() was not found.
+	 */
+	inline void record_false_positive() {
+		++stats_.false_positives;
+	}
+
+	/**
+	 * Adds a newly inserted key. Returns true if the tree, now of size keys,
+	 * has outgrown the filter and must rebuild() it.
+	 */
+	bool insert(const K &key, size_t size) {
+		filter_.add(tree_hash(key));
+		return size > capacity_;
+	}
+
+	/**
+	 * Counts an erase. Returns true if the filter has become stale enough
+	 * that the tree, now of size keys, must rebuild() it.
+	 */
+	bool erase(size_t size) {
+		return ++erased_ > size / 4;
+	}
+
+	/**
+	 * Refills the filter from the keys in [first, last), size of them,
+	 * leaving room for the tree to double.
+	 */
+	template<typename Iterator>
+	void rebuild(Iterator first, Iterator last, size_t size) {
+		// Built aside so that, if allocation fails, the old filter (which
+		// still covers every key) stays in place.
+		size_t capacity = 2 * size < MIN_CAPACITY ? MIN_CAPACITY : 2 * size;
+		BlockedBloomFilter filter;
+		filter.reset(capacity, bits_per_key_);
+		for (; first != last; ++first)
+			filter.add(tree_hash(first->first));
+		filter_.swap(filter);
+		capacity_ = capacity;
+		erased_ = 0;
+		++stats_.rebuilds;
+	}
+
+	/**
+	 * Empties the filter, keeping its size, when the tree is cleared.
+	 */
+	void clear() {
+		filter_.clear();
+		erased_ = 0;
+	}
+
+	size_t bytes() const {
+		return filter_.bytes();
+	}
+
+	const BloomFilterStats& stats() const {
+		return stats_;
+	}
+
+	void reset_stats() {
+		stats_ = BloomFilterStats();
+	}
+
+	void swap(KeyBloomFilter &other) {
+		filter_.swap(other.filter_);
+		std::swap(bits_per_key_, other.bits_per_key_);
+		std::swap(capacity_, other.capacity_);
+		std::swap(erased_, other.erased_);
+		std::swap(stats_, other.stats_);
+	}
+
+private:
+	static const size_t MIN_CAPACITY = 64;
+
+	BlockedBloomFilter filter_;
+	double bits_per_key_;
+	size_t capacity_;
+	size_t erased_;
+	BloomFilterStats stats_;
+};
+
+#endif /* BLOOMFILTER_H_ */
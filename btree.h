@@ -0,0 +1,510 @@
+/*******************************************************************************
+ * Name        : btree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : B-tree as described in chapter 18 of CLRS, with the same
+ *               interface as RedBlackTree. Each node keeps up to MaxKeys keys
+ *               in one contiguous array, so a lookup touches a few wide nodes
+ *               instead of one node per comparison.
+ ******************************************************************************/
+#ifndef BTREE_H_
+#define BTREE_H_
+
+#include "rbtree.h"
+#include "tree.h"
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+template<typename K, typename V, size_t MaxKeys>
+class BTree;
+
+/**
+ * A leaf holds keys and values in separate arrays so that the keys compared
+ * during a search sit next to each other. Internal nodes add the children.
+ */
+template<typename K, typename V, size_t MaxKeys>
+struct BTreeNode {
+	K keys[MaxKeys];
+	V values[MaxKeys];
+	BTreeNode *parent;
+	unsigned short count; // number of keys in use
+	unsigned short index; // position among the parent's children
+	bool leaf;
+
+	BTreeNode(bool is_leaf) :
+			parent(NULL), count(0), index(0), leaf(is_leaf) {
+	}
+};
+
+template<typename K, typename V, size_t MaxKeys>
+struct BTreeInternalNode: public BTreeNode<K, V, MaxKeys> {
+	BTreeNode<K, V, MaxKeys> *children[MaxKeys + 1];
+
+	BTreeInternalNode() :
+			BTreeNode<K, V, MaxKeys>(false) {
+	}
+};
+
+template<typename K, typename V, size_t MaxKeys>
+class BTreeIterator {
+	typedef BTreeNode<K, V, MaxKeys> node_type;
+
+public:
+	/**
+	 * Result of operator->. Keys and values are not stored together, so it
+	 * holds a pair of references to them: it->second = v updates the value
+	 * in the tree, as with RedBlackTree::iterator.
+	 */
+	class pair_proxy {
+	public:
+		const std::pair<const K&, V&>* operator->() const {
+			return &pair_;
+		}
+
+	private:
+		std::pair<const K&, V&> pair_;
+
+		pair_proxy(const K &key, V &value) :
+				pair_(key, value) {
+		}
+
+		friend class BTreeIterator;
+	};
+
+	BTreeIterator() :
+			node_(NULL), pos_(0), tree_(NULL) {
+	}
+
+	bool operator==(const BTreeIterator &rhs) const {
+		return node_ == rhs.node_ && pos_ == rhs.pos_;
+	}
+
+	bool operator!=(const BTreeIterator &rhs) const {
+		return !(*this == rhs);
+	}
+
+	/**
+	 * Returns a copy of the key-value pair.
+	 */
+	std::pair<K, V> operator*() const {
+		return std::pair<K, V>(node_->keys[pos_], node_->values[pos_]);
+	}
+
+	pair_proxy operator->() const {
+		return pair_proxy(node_->keys[pos_], node_->values[pos_]);
+	}
+
+	const K& key() const {
+		return node_->keys[pos_];
+	}
+
+	V& value() const {
+		return node_->values[pos_];
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key.
+	 */
+	BTreeIterator& operator++() {
+		if (node_ == NULL) {
+			// ++ from end(). Move to the first key in the tree.
+			if (tree_->root_ == NULL)
+				throw tree_exception("BTreeIterator operator++(): tree empty");
+			node_ = tree_->leftmost(tree_->root_);
+			pos_ = 0;
+		} else if (!node_->leaf) {
+			// Successor is the first key of the subtree right of this key.
+			node_ = tree_->leftmost(
+					BTree<K, V, MaxKeys>::children(node_)[pos_ + 1]);
+			pos_ = 0;
+		} else if (pos_ + 1 < node_->count) {
+			++pos_;
+		} else {
+			// Climb while we are the last child; the key separating us from
+			// our next sibling is the successor.
+			while (node_->parent != NULL
+					&& node_->index == node_->parent->count) {
+				node_ = node_->parent;
+			}
+			if (node_->parent == NULL) {
+				node_ = NULL;
+				pos_ = 0;
+			} else {
+				pos_ = node_->index;
+				node_ = node_->parent;
+			}
+		}
+		return *this;
+	}
+
+	BTreeIterator operator++(int) {
+		BTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	node_type *node_;
+	size_t pos_;
+	BTree<K, V, MaxKeys> *tree_;
+	friend class BTree<K, V, MaxKeys> ;
+
+	BTreeIterator(node_type *node, size_t pos, BTree<K, V, MaxKeys> *tree) :
+			node_(node), pos_(pos), tree_(tree) {
+	}
+};
+
+/**
+ * B-tree of minimum degree (MaxKeys + 1) / 2. MaxKeys must be odd. The
+ * default of 15 puts 60 bytes of int keys, about one cache line, in a node.
+ */
+template<typename K, typename V, size_t MaxKeys = 15>
+class BTree: public Tree {
+	static_assert(MaxKeys % 2 == 1 && MaxKeys >= 3,
+			"MaxKeys must be odd and at least 3");
+	static_assert(MaxKeys < 65535, "MaxKeys must fit in unsigned short");
+
+	typedef BTreeNode<K, V, MaxKeys> node_type;
+	typedef BTreeInternalNode<K, V, MaxKeys> internal_type;
+
+	// Minimum degree t of CLRS; every node but the root has at least t - 1
+	// keys.
+	static const size_t T = (MaxKeys + 1) / 2;
+
+public:
+	typedef BTreeIterator<K, V, MaxKeys> iterator;
+
+	/**
+	 * Constructor to create an empty B-tree.
+	 */
+	BTree() :
+			root_(NULL), size_(0), node_count_(0) {
+	}
+
+	/**
+	 * Constructor to create a B-tree with the elements from the vector.
+	 */
+	BTree(std::vector<std::pair<K, V> > &elements) :
+			root_(NULL), size_(0), node_count_(0) {
+		insert_elements(elements);
+	}
+
+	~BTree() {
+		delete_tree(root_);
+	}
+
+	/**
+	 * Inserts elements from the vector into the B-tree. Duplicate elements
+	 * are not inserted.
+	 */
+	void insert_elements(std::vector<std::pair<K, V> > &elements) {
+		for (size_t i = 0, len = elements.size(); i < len; ++i) {
+			try {
+				insert(elements[i].first, elements[i].second);
+			} catch (const tree_exception &te) {
+				std::cerr << "Warning: " << te.what() << std::endl;
+			}
+		}
+	}
+
+	/**
+	 * Inserts a key-value pair, splitting full nodes on the way down as in
+	 * B-TREE-INSERT on p. 495 of CLRS. Throws a tree_exception if the key is
+	 * already present.
+	 */
+	void insert(const K &key, const V &value) {
+		if (root_ == NULL) {
+			root_ = new node_type(true);
+			++node_count_;
+		} else if (root_->count == MaxKeys) {
+			internal_type *s = new internal_type();
+			++node_count_;
+			s->children[0] = root_;
+			root_->parent = s;
+			root_->index = 0;
+			root_ = s;
+			split_child(s, 0);
+		}
+		node_type *x = root_;
+		for (;;) {
+			size_t i = lower(x, key);
+			if (i < x->count && !(key < x->keys[i]))
+				throw_duplicate(key);
+			if (x->leaf) {
+				for (size_t j = x->count; j > i; --j) {
+					x->keys[j] = std::move(x->keys[j - 1]);
+					x->values[j] = std::move(x->values[j - 1]);
+				}
+				x->keys[i] = key;
+				x->values[i] = value;
+				++x->count;
+				++size_;
+				return;
+			}
+			if (children(x)[i]->count == MaxKeys) {
+				split_child(static_cast<internal_type*>(x), i);
+				if (x->keys[i] < key)
+					++i;
+				else if (!(key < x->keys[i]))
+					throw_duplicate(key);
+			}
+			x = children(x)[i];
+		}
+	}
+
+	/**
+	 * Returns an ASCII representation of the B-tree, one line per level
+	 * with each node's keys in brackets.
+	 */
+	std::string to_ascii_drawing() {
+		if (root_ == NULL)
+			return "Root is null.";
+		std::ostringstream oss;
+		std::vector<node_type*> level(1, root_), next;
+		while (!level.empty()) {
+			next.clear();
+			for (size_t n = 0; n < level.size(); ++n) {
+				node_type *x = level[n];
+				if (n > 0)
+					oss << " ";
+				oss << "[";
+				for (size_t i = 0; i < x->count; ++i) {
+					if (i > 0)
+						oss << " ";
+					oss << x->keys[i];
+				}
+				oss << "]";
+				if (!x->leaf) {
+					for (size_t i = 0; i <= x->count; ++i)
+						next.push_back(children(x)[i]);
+				}
+			}
+			level.swap(next);
+			if (!level.empty())
+				oss << "\n";
+		}
+		return oss.str();
+	}
+
+	/**
+	 * Returns the height of the B-tree in nodes, i.e. the number of levels
+	 * below the root. All leaves are at this depth.
+	 */
+	int height() const {
+		int h = -1;
+		for (node_type *x = root_; x != NULL;
+				x = x->leaf ? NULL : children(x)[0]) {
+			++h;
+		}
+		return h;
+	}
+
+	/**
+	 * Returns the number of keys in the B-tree.
+	 */
+	size_t size() const {
+		return size_;
+	}
+
+	/**
+	 * Returns the number of leaf nodes.
+	 */
+	size_t leaf_count() const {
+		return root_ == NULL ? 0 : leaf_count(root_);
+	}
+
+	/**
+	 * Returns the number of internal (non-leaf) nodes.
+	 */
+	size_t internal_node_count() const {
+		return root_ == NULL ? 0 : node_count_ - leaf_count(root_);
+	}
+
+	/**
+	 * Returns the number of edges on the longest path between two leaves.
+	 * Since all leaves share one depth, this is twice the height once the
+	 * root has two children.
+	 */
+	size_t diameter() const {
+		int h = height();
+		return h <= 0 ? 0 : 2 * h;
+	}
+
+	/**
+	 * Returns the largest number of nodes on any level, which is the leaf
+	 * level.
+	 */
+	size_t max_width() const {
+		return leaf_count();
+	}
+
+	/**
+	 * Returns the average number of nodes visited to find a key that is
+	 * present.
+	 */
+	double successful_search_cost() const {
+		return size_ == 0 ? 0 : 1 + (double) sum_levels(root_, 0) / size_;
+	}
+
+	/**
+	 * Returns the average number of nodes visited to find a key that is not
+	 * present. Every such search ends in a leaf.
+	 */
+	double unsuccessful_search_cost() const {
+		return root_ == NULL ? 0 : height() + 1;
+	}
+
+	/**
+	 * Searches for key. If found, returns an iterator pointing at it;
+	 * otherwise, returns end().
+	 */
+	iterator find(const K &key) {
+		node_type *x = root_;
+		while (x != NULL) {
+			size_t i = lower(x, key);
+			if (i < x->count && !(key < x->keys[i]))
+				return iterator(x, i, this);
+			x = x->leaf ? NULL : children(x)[i];
+		}
+		return end();
+	}
+
+	/**
+	 * Returns an iterator pointing to the first item in order.
+	 */
+	iterator begin() {
+		return root_ == NULL ? end() : iterator(leftmost(root_), 0, this);
+	}
+
+	/**
+	 * Returns an iterator pointing just past the end of the tree data.
+	 */
+	iterator end() {
+		return iterator(NULL, 0, this);
+	}
+
+private:
+	node_type *root_;
+	size_t size_;
+	size_t node_count_;
+	friend class BTreeIterator<K, V, MaxKeys> ;
+
+	// Owns its nodes; not copyable.
+	BTree(const BTree &);
+	BTree& operator=(const BTree &);
+
+	static inline node_type** children(node_type *x) {
+		return static_cast<internal_type*>(x)->children;
+	}
+
+	static inline node_type* const * children(const node_type *x) {
+		return static_cast<const internal_type*>(x)->children;
+	}
+
+	/**
+	 * Returns the number of keys in x less than key, i.e. the position of
+	 * key or of the child to descend into. The loop is branch-free and runs
+	 * over contiguous keys, so the compiler can vectorize it for integer
+	 * keys (e.g. with -O3).
+	 */
+	static inline size_t lower(const node_type *x, const K &key) {
+		size_t i = 0;
+		for (size_t j = 0, n = x->count; j < n; ++j)
+			i += x->keys[j] < key;
+		return i;
+	}
+
+	static node_type* leftmost(node_type *x) {
+		while (!x->leaf)
+			x = children(x)[0];
+		return x;
+	}
+
+	void throw_duplicate(const K &key) const {
+		std::stringstream ss;
+		ss << key;
+		throw tree_exception("Attempt to insert duplicate key '" + ss.str()
+				+ "'.");
+	}
+
+	/**
+	 * Splits the full child i of x around its median key, which moves up
+	 * into x, as in B-TREE-SPLIT-CHILD on p. 494 of CLRS.
+	 */
+	void split_child(internal_type *x, size_t i) {
+		node_type *y = x->children[i];
+		node_type *z;
+		if (y->leaf) {
+			z = new node_type(true);
+		} else {
+			internal_type *zi = new internal_type();
+			for (size_t j = 0; j < T; ++j) {
+				zi->children[j] = children(y)[j + T];
+				zi->children[j]->parent = zi;
+				zi->children[j]->index = static_cast<unsigned short>(j);
+			}
+			z = zi;
+		}
+		++node_count_;
+		for (size_t j = 0; j < T - 1; ++j) {
+			z->keys[j] = std::move(y->keys[j + T]);
+			z->values[j] = std::move(y->values[j + T]);
+		}
+		z->count = T - 1;
+		y->count = T - 1;
+
+		for (size_t j = x->count; j > i; --j) {
+			x->children[j + 1] = x->children[j];
+			x->children[j + 1]->index = static_cast<unsigned short>(j + 1);
+			x->keys[j] = std::move(x->keys[j - 1]);
+			x->values[j] = std::move(x->values[j - 1]);
+		}
+		x->children[i + 1] = z;
+		z->parent = x;
+		z->index = static_cast<unsigned short>(i + 1);
+		x->keys[i] = std::move(y->keys[T - 1]);
+		x->values[i] = std::move(y->values[T - 1]);
+		++x->count;
+	}
+
+	void delete_tree(node_type *x) {
+		if (x == NULL)
+			return;
+		if (x->leaf) {
+			delete x;
+		} else {
+			for (size_t i = 0; i <= x->count; ++i)
+				delete_tree(children(x)[i]);
+			delete static_cast<internal_type*>(x);
+		}
+	}
+
+	size_t leaf_count(const node_type *x) const {
+		if (x->leaf)
+			return 1;
+		size_t count = 0;
+		for (size_t i = 0; i <= x->count; ++i)
+			count += leaf_count(children(x)[i]);
+		return count;
+	}
+
+	/**
+	 * Returns the sum of the levels of every key in the subtree rooted at x.
+	 */
+	size_t sum_levels(const node_type *x, size_t level) const {
+		if (x == NULL)
+			return 0;
+		size_t sum = level * x->count;
+		if (!x->leaf) {
+			for (size_t i = 0; i <= x->count; ++i)
+				sum += sum_levels(children(x)[i], level + 1);
+		}
+		return sum;
+	}
+};
+
+#endif /* BTREE_H_ */
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * Name        : augmentedtree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks the subtree aggregates of AugmentedRedBlackTree. The
+ *               sum and minimum over any key range, and prefix sums, must
+ *               match a scan after every insert, erase and set_value(),
+ *               since each has to fix the aggregates on its path and along
+ *               its rotations. Two Merkle replicas that missed some of each
+ *               other's changes must each report exactly the keys where
+ *               they differ.
+ ******************************************************************************/
+#include "check.h"
+#include "../augmentedtree.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef map<int, long long> PairMap;
+
+long long sum_between(const PairMap &expected, int lo, int hi) {
+    long long sum = 0;
+    for (PairMap::const_iterator it = expected.lower_bound(lo);
+            it != expected.end() && it->first <= hi; ++it) {
+        sum += it->second;
+    }
+    return sum;
+}
+
+long long min_between(const PairMap &expected, int lo, int hi) {
+    long long least = numeric_limits<long long>::max();
+    for (PairMap::const_iterator it = expected.lower_bound(lo);
+            it != expected.end() && it->first <= hi; ++it) {
+        least = min(least, it->second);
+    }
+    return least;
+}
+
+/**
+ * Applies one random insert, erase or update to both tree and expected.
+ */
+template<typename Tree>
+void step(Tree &tree, PairMap &expected, mt19937 &rng, int range) {
+    int key = static_cast<int>(rng() % range);
+    long long value = static_cast<long long>(rng() % 2001) - 1000;
+    PairMap::iterator e = expected.find(key);
+    switch (rng() % 4) {
+    case 0:
+        CHECK(tree.erase(key) == (e != expected.end()));
+        if (e != expected.end()) {
+            expected.erase(e);
+        }
+        break;
+    case 1:
+        if (e != expected.end()) {
+            tree.set_value(tree.find(key), value);
+            e->second = value;
+            break;
+        }
+        // Fall through to insert.
+    default:
+        bool threw = false;
+        try {
+            tree.insert(key, value);
+        } catch (const tree_exception &) {
+            threw = true;
+        }
+        CHECK(threw == (e != expected.end()));
+        expected.insert(make_pair(key, value));
+        break;
+    }
+}
+
+void check_sums() {
+    const int RANGE = 2000, OPS = 20000;
+    mt19937 rng(28);
+    AugmentedRedBlackTree<int, long long> sums;
+    AugmentedRedBlackTree<int, long long, MinMonoid<int, long long> > mins;
+    PairMap expected, expected_mins;
+    for (int op = 0; op < OPS; ++op) {
+        mt19937 replay(rng);
+        step(sums, expected, rng, RANGE);
+        step(mins, expected_mins, replay, RANGE);
+
+        int key = static_cast<int>(rng() % RANGE);
+        AugmentedRedBlackTree<int, long long>::iterator it = sums.find(key);
+        PairMap::iterator e = expected.find(key);
+        CHECK(e == expected.end() ? it == sums.end()
+                : it != sums.end() && it->value() == e->second);
+
+        int lo = static_cast<int>(rng() % RANGE), hi = lo + rng() % 200;
+        CHECK(sums.aggregate(lo, hi) == sum_between(expected, lo, hi));
+        CHECK(sums.prefix(hi) == sum_between(expected, 0, hi));
+        CHECK(mins.aggregate(lo, hi) == min_between(expected, lo, hi));
+
+        if (op % 1000 == 0 || op == OPS - 1) {
+            CHECK(sums.size() == expected.size());
+            CHECK(sums.total() == sum_between(expected, 0, RANGE));
+            e = expected.begin();
+            for (it = sums.begin(); it != sums.end() && e != expected.end();
+                    ++it, ++e) {
+                CHECK(it->key() == e->first && it->value() == e->second);
+            }
+            CHECK(it == sums.end() && e == expected.end());
+        }
+        if (check_failures() > 0) {
+            break;
+        }
+    }
+}
+
+struct Collect {
+    vector<int> *keys;
+
+    void operator()(int key) const {
+        keys->push_back(key);
+    }
+};
+
+void check_diff() {
+    const int RANGE = 5000;
+    mt19937 rng(39);
+    AugmentedRedBlackTree<int, long long, MerkleMonoid<int, long long> > a, b;
+    PairMap expected_a, expected_b;
+    for (int round = 0; round < 20; ++round) {
+        // Mostly the same changes on both replicas, with some missed.
+        for (int i = 0; i < 500; ++i) {
+            mt19937 replay(rng);
+            step(a, expected_a, rng, RANGE);
+            if (rng() % 50 != 0) {
+                step(b, expected_b, replay, RANGE);
+            }
+        }
+        vector<int> want;
+        PairMap::iterator x = expected_a.begin(), y = expected_b.begin();
+        while (x != expected_a.end() || y != expected_b.end()) {
+            if (y == expected_b.end()
+                    || (x != expected_a.end() && x->first < y->first)) {
+                want.push_back((x++)->first);
+            } else if (x == expected_a.end() || y->first < x->first) {
+                want.push_back((y++)->first);
+            } else {
+                if (x->second != y->second) {
+                    want.push_back(x->first);
+                }
+                ++x;
+                ++y;
+            }
+        }
+        vector<int> got;
+        Collect collect = { &got };
+        a.diff(b, collect);
+        CHECK(got == want);
+        got.clear();
+        b.diff(a, collect);
+        CHECK(got == want);
+    }
+}
+
+int main() {
+    check_sums();
+    check_diff();
+    return check_status();
+}
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * Name        : btree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks BTree for a few node sizes. Keys inserted in
+ *               increasing order, which leaves every split node half full,
+ *               and in random order must still give a tree within the CLRS
+ *               bounds on height and node count; iterators must step across
+ *               node boundaries in key order; a duplicate must be refused
+ *               without touching the value; and values updated through
+ *               it->second and value() must stay updated.
+ ******************************************************************************/
+#include "check.h"
+#include "../btree.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Returns true if tree is no taller, and has no more nodes, than CLRS
+ * allows: every node but the root holds at least T - 1 keys, where T is the
+ * minimum degree.
+ */
+template<typename BTreeType>
+bool within_bounds(const BTreeType &tree, size_t max_keys) {
+    double n = static_cast<double>(tree.size());
+    double t = static_cast<double>((max_keys + 1) / 2);
+    size_t nodes = tree.leaf_count() + tree.internal_node_count();
+    if (n == 0) {
+        return nodes <= 1;
+    }
+    return tree.height() <= log((n + 1) / 2) / log(t) + 1e-9
+            && nodes <= 1 + (n - 1) / (t - 1);
+}
+
+template<size_t MaxKeys>
+void check_btree(unsigned seed) {
+    typedef BTree<int, int, MaxKeys> IntBTree;
+    const int KEYS = 20000;
+    vector<int> keys(KEYS);
+    for (int i = 0; i < KEYS; ++i) {
+        keys[i] = 2 * i;
+    }
+
+    IntBTree ascending;
+    map<int, int> expected;
+    for (int i = 0; i < KEYS; ++i) {
+        ascending.insert(keys[i], i);
+        expected[keys[i]] = i;
+        if (i % 997 == 0) {
+            CHECK(within_bounds(ascending, MaxKeys));
+        }
+    }
+    CHECK(same_contents(ascending.begin(), ascending.end(), expected));
+
+    mt19937 rng(seed);
+    shuffle(keys.begin(), keys.end(), rng);
+    IntBTree shuffled;
+    for (int i = 0; i < KEYS; ++i) {
+        shuffled.insert(keys[i], expected[keys[i]]);
+        if (i % 997 == 0) {
+            CHECK(within_bounds(shuffled, MaxKeys));
+        }
+    }
+    CHECK(within_bounds(shuffled, MaxKeys));
+    CHECK(shuffled.size() == expected.size());
+
+    // Every key, and every gap between keys, from the shuffled tree; and
+    // a walk on from each key found, with postfix and prefix steps.
+    for (int key = -1; key <= 2 * KEYS; ++key) {
+        typename IntBTree::iterator it = shuffled.find(key);
+        map<int, int>::iterator e = expected.find(key);
+        if (!CHECK(e == expected.end() ? it == shuffled.end()
+                : it != shuffled.end() && it.key() == key
+                        && it.value() == e->second)) {
+            return;
+        }
+        if (e != expected.end() && key % 101 == 0) {
+            for (size_t i = 0; i < 2 * MaxKeys && e != expected.end(); ++i) {
+                CHECK(it != shuffled.end() && (it++).key() == (e++)->first);
+            }
+            CHECK((it == shuffled.end()) == (e == expected.end()));
+        }
+    }
+
+    bool threw = false;
+    try {
+        shuffled.insert(keys[0], -1);
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw && shuffled.find(keys[0]).value() == expected[keys[0]]);
+
+    for (typename IntBTree::iterator it = shuffled.begin();
+            it != shuffled.end(); ++it) {
+        it->second = -it->first;
+        expected[it->first] = -it->first;
+    }
+    CHECK(same_contents(shuffled.begin(), shuffled.end(), expected));
+    shuffled.find(keys[0]).value() = 7;
+    CHECK(shuffled.find(keys[0])->second == 7);
+}
+
+int main() {
+    check_btree<3>(32);
+    check_btree<5>(33);
+    check_btree<15>(34);
+    check_btree<63>(35);
+    return check_status();
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Name        : check.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Shared by the checks in this directory, one program per
+ *               container, each testing what that container promises. Most
+ *               keep a std::map of what the container should hold. A check
+ *               prints nothing and exits with 0 when every CHECK holds.
+ ******************************************************************************/
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <map>
+
+/**
+ * Reports cond on stderr, with where it was checked, if it does not hold.
+ * Evaluates to cond, so a loop can stop at the first failure.
+ */
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+
+inline int& check_failures() {
+	static int failures = 0;
+	return failures;
+}
+
+inline bool check(bool ok, const char *what, const char *file, int line) {
+	if (!ok) {
+		std::cerr << file << ":" << line << ": Check failed: " << what
+				<< std::endl;
+		++check_failures();
+	}
+	return ok;
+}
+
+/**
+ * Returns the exit status of a check: 0 if every CHECK held, 1 otherwise.
+ */
+inline int check_status() {
+	return check_failures() == 0 ? 0 : 1;
+}
+
+/**
+ * Returns true if [first, last) holds exactly the pairs of expected, in the
+ * same order. The iterators must dereference to something with first and
+ * second.
+ */
+template<typename Iterator, typename K, typename V>
+bool same_contents(Iterator first, Iterator last,
+		const std::map<K, V> &expected) {
+	typename std::map<K, V>::const_iterator e = expected.begin();
+	for (; first != last; ++first, ++e) {
+		if (e == expected.end() || !((*first).first == e->first)
+				|| !((*first).second == e->second))
+			return false;
+	}
+	return e == expected.end();
+}
+
+/**
+ * Returns true if a red-black tree holding size keys may be height tall,
+ * counting a lone root as 0 and an empty tree as -1. No path is more than
+ * twice as long as any other, so height + 1 <= 2 log2(size + 1).
+ */
+inline bool red_black_height(int height, size_t size) {
+	if (size == 0)
+		return height == -1;
+	return height >= 0 && height + 1 <= 2 * std::log2(size + 1.0);
+}
+
+#endif /* CHECK_H_ */
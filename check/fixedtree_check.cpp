@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Name        : fixedtree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks FixedRedBlackTree, with 16-bit and 32-bit links, in
+ *               static trees built before main() runs. Filling a tree must
+ *               report FIXED_TREE_FULL for the next key and DUPLICATE for a
+ *               key it holds; erases and inserts must then trade places
+ *               through the free list at full capacity; and the shared_ptr
+ *               values must be released exactly as often as they are
+ *               erased or cleared.
+ ******************************************************************************/
+#include "check.h"
+#include "../fixedtree.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef shared_ptr<int> Value;
+typedef FixedRedBlackTree<int, Value, 500> SmallTree;
+// Over UINT16_MAX nodes, so the links are 32 bits wide.
+typedef FixedRedBlackTree<int, Value, 70000> LargeTree;
+
+static_assert(sizeof(SmallTree::index_type) == 2, "16-bit links");
+static_assert(sizeof(LargeTree::index_type) == 4, "32-bit links");
+static_assert(noexcept(declval<SmallTree&>().insert(0, Value())),
+        "insert is noexcept");
+
+SmallTree small_tree;
+LargeTree large_tree;
+
+template<typename FixedTree>
+bool same_contents(FixedTree &tree, const map<int, Value> &expected) {
+    map<int, Value>::const_iterator e = expected.begin();
+    for (typename FixedTree::iterator it = tree.begin(); it != tree.end();
+            ++it, ++e) {
+        if (e == expected.end() || it.key() != e->first
+                || it.value() != e->second) {
+            return false;
+        }
+    }
+    return e == expected.end()
+            && red_black_height(tree.height(), tree.size());
+}
+
+template<typename FixedTree>
+void check_fixed(FixedTree &tree, unsigned seed) {
+    const int N = static_cast<int>(FixedTree::capacity());
+    CHECK(tree.empty() && tree.begin() == tree.end());
+    mt19937 rng(seed);
+    vector<int> keys(2 * N);
+    for (int i = 0; i < 2 * N; ++i) {
+        keys[i] = i;
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+
+    // One reference here, one in expected, and one per pair in the tree.
+    Value value = make_shared<int>(0);
+    map<int, Value> expected;
+    for (int i = 0; i < N; ++i) {
+        CHECK(tree.insert(keys[i], value) == FIXED_TREE_OK);
+        expected[keys[i]] = value;
+    }
+    CHECK(tree.full() && tree.size() == static_cast<size_t>(N));
+    CHECK(tree.insert(keys[N], value) == FIXED_TREE_FULL);
+    CHECK(tree.insert(keys[0], value) == FIXED_TREE_DUPLICATE);
+    CHECK(value.use_count() == 1 + 2 * N);
+    CHECK(same_contents(tree, expected));
+
+    // keys[0, N) are in the tree and keys[N, 2N) are not; swap one of each
+    // at a time, so every insert takes the node just freed.
+    for (int op = 0; op < 4 * N; ++op) {
+        int in = static_cast<int>(rng() % N);
+        int out = N + static_cast<int>(rng() % N);
+        CHECK(tree.erase(keys[in]) && !tree.full());
+        CHECK(!tree.erase(keys[in]) && !tree.contains(keys[in]));
+        CHECK(tree.insert(keys[out], value) == FIXED_TREE_OK && tree.full());
+        typename FixedTree::iterator it = tree.find(keys[out]);
+        CHECK(it != tree.end() && it.key() == keys[out]);
+        expected.erase(keys[in]);
+        expected[keys[out]] = value;
+        swap(keys[in], keys[out]);
+        if (check_failures() > 0) {
+            return;
+        }
+    }
+    CHECK(value.use_count() == 1 + 2 * N);
+    CHECK(same_contents(tree, expected));
+
+    for (int i = 0; i < N / 2; ++i) {
+        CHECK(tree.erase(keys[i]));
+        expected.erase(keys[i]);
+    }
+    CHECK(value.use_count() == 1 + 2 * (N - N / 2));
+    CHECK(same_contents(tree, expected));
+    tree.clear();
+    expected.clear();
+    CHECK(tree.empty() && tree.begin() == tree.end());
+    CHECK(value.use_count() == 1);
+}
+
+int main() {
+    check_fixed(small_tree, 48);
+    check_fixed(large_tree, 49);
+    return check_status();
+}
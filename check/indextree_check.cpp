@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * Name        : indextree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks IndexedRedBlackTree, whose nodes sit in one array and
+ *               link to each other by index. After random inserts the
+ *               links in the array must satisfy the red-black rules, and a
+ *               value assigned through it->second must land in its node.
+ *               write() and read() must round-trip the array, and read()
+ *               of a truncated copy or one with a bad link must throw and
+ *               leave the tree as it was.
+ ******************************************************************************/
+#include "check.h"
+#include "../indextree.h"
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef IndexedRedBlackTree<int, int> IndexTree;
+typedef IndexedNode<int, int> IndexNode;
+
+/**
+ * Returns the black height of the subtree rooted at x, or -1 if it breaks a
+ * red-black rule, a parent link, or the key order.
+ */
+int black_height(const vector<IndexNode> &nodes, uint32_t x,
+        uint32_t parent) {
+    if (x == IndexNode::NIL) {
+        return 1;
+    }
+    const IndexNode &n = nodes[x];
+    if (n.parent != parent) {
+        return -1;
+    }
+    for (int side = 0; side < 2; ++side) {
+        uint32_t c = side == 0 ? n.left : n.right;
+        if (c == IndexNode::NIL) {
+            continue;
+        }
+        bool ordered = side == 0 ? nodes[c].key < n.key : n.key < nodes[c].key;
+        if (!ordered || (nodes[c].color == RED && n.color == RED)) {
+            return -1;
+        }
+    }
+    int lh = black_height(nodes, n.left, x);
+    int rh = black_height(nodes, n.right, x);
+    if (lh < 0 || lh != rh) {
+        return -1;
+    }
+    return lh + (n.color == BLACK);
+}
+
+bool is_red_black(const IndexTree &tree) {
+    uint32_t root = tree.root();
+    return (root == IndexNode::NIL || tree.nodes()[root].color == BLACK)
+            && black_height(tree.nodes(), root, IndexNode::NIL) > 0;
+}
+
+bool read_throws(IndexTree &tree, const string &bytes) {
+    istringstream in(bytes);
+    try {
+        tree.read(in);
+    } catch (const tree_exception &) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    const int RANGE = 20000, OPS = 15000;
+    mt19937 rng(34);
+    IndexTree tree;
+    map<int, int> expected;
+    for (int op = 0; op < OPS; ++op) {
+        int key = static_cast<int>(rng() % RANGE);
+        bool fresh = expected.insert(make_pair(key, op)).second;
+        bool threw = false;
+        try {
+            tree.insert(key, op);
+        } catch (const tree_exception &) {
+            threw = true;
+        }
+        CHECK(threw == !fresh);
+
+        key = static_cast<int>(rng() % RANGE);
+        IndexTree::iterator it = tree.find(key);
+        map<int, int>::iterator e = expected.find(key);
+        CHECK(e == expected.end() ? it == tree.end()
+                : it != tree.end() && (*it).first == key
+                        && (*it).second == e->second);
+
+        if (op % 1000 == 0 || op == OPS - 1) {
+            CHECK(tree.size() == expected.size());
+            CHECK(same_contents(tree.begin(), tree.end(), expected));
+            CHECK(is_red_black(tree));
+        }
+        if (check_failures() > 0) {
+            return check_status();
+        }
+    }
+
+    for (IndexTree::iterator it = tree.begin(); it != tree.end(); ++it) {
+        it->second = -it->first;
+        expected[it->first] = -it->first;
+    }
+    CHECK(tree.find(expected.begin()->first).value()
+            == -expected.begin()->first);
+    CHECK(same_contents(tree.begin(), tree.end(), expected));
+
+    ostringstream out;
+    tree.write(out);
+    string bytes = out.str();
+    IndexTree copy;
+    istringstream in(bytes);
+    copy.read(in);
+    CHECK(same_contents(copy.begin(), copy.end(), expected));
+    CHECK(is_red_black(copy));
+
+    // Each bad copy is refused, and copy keeps what it had.
+    CHECK(read_throws(copy, bytes.substr(0, bytes.size() - 1)));
+    CHECK(read_throws(copy, bytes.substr(0, 6)));
+    const size_t header = sizeof(uint32_t) + sizeof(uint64_t);
+    for (int i = 0; i < 20; ++i) {
+        string bad(bytes);
+        size_t node = header + rng() % expected.size() * sizeof(IndexNode);
+        // Point a random child or parent link at a random node.
+        uint32_t link = static_cast<uint32_t>(rng() % expected.size());
+        size_t field = offsetof(IndexNode, left) + rng() % 3 * sizeof(link);
+        if (bad.compare(node + field, sizeof(link),
+                reinterpret_cast<const char *>(&link), sizeof(link)) == 0) {
+            continue;
+        }
+        bad.replace(node + field, sizeof(link),
+                reinterpret_cast<const char *>(&link), sizeof(link));
+        CHECK(read_throws(copy, bad));
+    }
+    CHECK(same_contents(copy.begin(), copy.end(), expected));
+    return check_status();
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Name        : instrumentation_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks the counters and histograms RedBlackTree keeps when
+ *               compiled with -DRBTREE_INSTRUMENT, as the makefile builds
+ *               this check. Inserting 1 to 7 in order takes a known number
+ *               of rotations and recolorings, one allocation and one descent
+ *               per key, and one or two comparisons per node the descents
+ *               pass; finds and inserts are timed once each; and
+ *               reset_metrics() zeroes it all.
+ ******************************************************************************/
+#include "check.h"
+#include "../rbtree.h"
+
+using namespace std;
+
+typedef RedBlackTree<int, int> IntTree;
+
+/**
+ * Returns true if every counter and histogram of metrics is zero.
+ */
+bool zeroed(const TreeMetrics &metrics) {
+    const TreeCounters &c = metrics.counters;
+    return c.comparisons == 0 && c.descents == 0
+            && c.descent_depth_total == 0 && c.descent_depth_max == 0
+            && c.rotations == 0 && c.recolorings == 0 && c.allocations == 0
+            && c.deallocations == 0 && metrics.insert_latency.count() == 0
+            && metrics.find_latency.count() == 0
+            && metrics.erase_latency.count() == 0;
+}
+
+int main() {
+    CHECK(IntTree::instrumented());
+
+    IntTree tree;
+    CHECK(zeroed(tree.metrics()));
+    for (int key = 1; key <= 7; ++key) {
+        tree.insert(key, key);
+    }
+    /*
+     *      2        Inserting 3, 5 and 7 each rotates once. recolor()
+     *     / \       counts calls rather than changes of color, and the
+     *    1   4      fixup ends every pass, recursive ones included, by
+     *       / \     blackening the root: 24 in all.
+     *      3   6
+     *         / \
+     *        5   7
+     */
+    TreeMetrics metrics = tree.metrics();
+    const TreeCounters &c = metrics.counters;
+    CHECK(c.rotations == 3);
+    CHECK(c.recolorings == 24);
+    CHECK(c.allocations == 7 && c.deallocations == 0);
+    // Each insert descends past the keys already on its path: 0, 1, 2, 2,
+    // 3, 3 and 4 of them.
+    CHECK(c.descents == 7);
+    CHECK(c.descent_depth_total == 15 && c.descent_depth_max == 4);
+    CHECK(c.comparisons >= c.descent_depth_total
+            && c.comparisons <= 2 * c.descent_depth_total);
+    CHECK(metrics.insert_latency.count() == 7);
+    CHECK(metrics.find_latency.count() == 0);
+    CHECK(metrics.insert_latency.max() >= metrics.insert_latency.p50());
+    CHECK(metrics.pool_capacity_bytes > 0);
+
+    for (int key = 0; key <= 8; ++key) {
+        CHECK((tree.find(key) != tree.end()) == (key >= 1 && key <= 7));
+    }
+    metrics = tree.metrics();
+    CHECK(metrics.find_latency.count() == 9);
+    CHECK(metrics.counters.descents == 7 + 9);
+
+    tree.reset_metrics();
+    metrics = tree.metrics();
+    CHECK(zeroed(metrics));
+    // The pool is not a counter: its size is still reported.
+    CHECK(metrics.pool_capacity_bytes > 0);
+    return check_status();
+}
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * Name        : intervaltree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks the overlap queries of IntervalTree. Intervals that
+ *               share a low end are kept apart by their high end. After
+ *               random inserts and erases, overlapping() must list the same
+ *               intervals, in the same order, as a scan of every interval;
+ *               find_any_overlapping() must return one of them or none; and
+ *               each node's max_high must cover its own high end. An
+ *               interval whose high end is below its low end is refused.
+ ******************************************************************************/
+#include "check.h"
+#include "../intervaltree.h"
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+typedef pair<int, int> Interval;
+typedef map<Interval, int> IntervalMap;
+
+/**
+ * Returns the intervals of expected that overlap [lo, hi], in order.
+ */
+vector<pair<Interval, int> > overlapping(const IntervalMap &expected, int lo,
+        int hi) {
+    vector<pair<Interval, int> > result;
+    for (IntervalMap::const_iterator it = expected.begin();
+            it != expected.end() && it->first.first <= hi; ++it) {
+        if (it->first.second >= lo) {
+            result.push_back(*it);
+        }
+    }
+    return result;
+}
+
+int main() {
+    const int RANGE = 1000, OPS = 30000;
+    mt19937 rng(27);
+    uniform_int_distribution<int> point(0, RANGE), length(0, 40);
+
+    IntervalTree<int, int> tree;
+    IntervalMap expected;
+    for (int op = 0; op < OPS; ++op) {
+        int low = point(rng), high = low + length(rng);
+        if (rng() % 3 != 0) {
+            bool fresh = expected.insert(
+                    make_pair(Interval(low, high), op)).second;
+            bool threw = false;
+            try {
+                tree.insert(low, high, op);
+            } catch (const tree_exception &) {
+                threw = true;
+            }
+            CHECK(threw == !fresh);
+        } else {
+            CHECK(tree.erase(low, high) == (expected.erase(
+                    Interval(low, high)) == 1));
+        }
+
+        IntervalTree<int, int>::iterator it = tree.find(low, high);
+        IntervalMap::iterator e = expected.find(Interval(low, high));
+        CHECK(e == expected.end() ? it == tree.end()
+                : it != tree.end() && it->value() == e->second);
+
+        if (op % 8 == 0) {
+            int lo = point(rng), hi = lo + length(rng);
+            vector<pair<Interval, int> > want = overlapping(expected, lo, hi);
+            CHECK(tree.overlapping(lo, hi) == want);
+            const IntervalNode<int, int> *any = tree.find_any_overlapping(lo,
+                    hi);
+            CHECK(want.empty() ? any == NULL
+                    : any != NULL && any->overlaps(lo, hi));
+        }
+
+        if (op % 1000 == 0 || op == OPS - 1) {
+            CHECK(tree.size() == expected.size());
+            e = expected.begin();
+            for (it = tree.begin(); it != tree.end() && e != expected.end();
+                    ++it, ++e) {
+                CHECK(it->interval() == e->first);
+                CHECK(it->max_high() >= it->high());
+            }
+            CHECK(it == tree.end() && e == expected.end());
+        }
+        if (check_failures() > 0) {
+            break;
+        }
+    }
+
+    bool threw = false;
+    try {
+        tree.insert(5, 4, 0);
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw);
+    return check_status();
+}
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * Name        : intrusivetree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks IntrusiveRedBlackTree on objects it does not own: one
+ *               pool of items is linked into two trees at once, by id and
+ *               by rank, through two hooks. Each tree must hand back the
+ *               very objects linked, walking forward and back and from its
+ *               bounds; an unlinked item must show as unlinked in both; the
+ *               links in each item must satisfy the red-black rules; and
+ *               clear() must unlink every item.
+ ******************************************************************************/
+#include "check.h"
+#include "../intrusivetree.h"
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+struct Item {
+    int id, rank;
+    RedBlackHook<Item> by_id, by_rank;
+};
+
+struct IdOf {
+    int operator()(const Item &item) const {
+        return item.id;
+    }
+};
+
+struct RankOf {
+    int operator()(const Item &item) const {
+        return item.rank;
+    }
+};
+
+typedef IntrusiveRedBlackTree<Item, int, &Item::by_id, IdOf> IdTree;
+typedef IntrusiveRedBlackTree<Item, int, &Item::by_rank, RankOf> RankTree;
+
+/**
+ * Returns the black height of the subtree rooted at x, or -1 if it breaks a
+ * red-black rule, a parent link, or the key order.
+ */
+template<typename Tree, typename KeyOf>
+int black_height(const Item *x, const Item *parent, KeyOf key_of) {
+    if (x == NULL) {
+        return 1;
+    }
+    const Item *l = Tree::left(x), *r = Tree::right(x);
+    if (Tree::parent(x) != parent
+            || (l != NULL && !(key_of(*l) < key_of(*x)))
+            || (r != NULL && !(key_of(*x) < key_of(*r)))) {
+        return -1;
+    }
+    if (Tree::color(x) == RED && ((l != NULL && Tree::color(l) == RED)
+            || (r != NULL && Tree::color(r) == RED))) {
+        return -1;
+    }
+    int lh = black_height<Tree>(l, x, key_of);
+    int rh = black_height<Tree>(r, x, key_of);
+    if (lh < 0 || lh != rh) {
+        return -1;
+    }
+    return lh + (Tree::color(x) == BLACK);
+}
+
+template<typename Tree, typename KeyOf>
+bool is_red_black(const Tree &tree, KeyOf key_of) {
+    return (tree.root() == NULL || Tree::color(tree.root()) == BLACK)
+            && black_height<Tree>(tree.root(), NULL, key_of) > 0;
+}
+
+/**
+ * Returns true if walking tree forward with its iterators, and back with
+ * prev(), yields the keys of expected in order.
+ */
+template<typename Tree, typename KeyOf>
+bool same_keys(const Tree &tree, KeyOf key_of,
+        const map<int, Item *> &expected) {
+    map<int, Item *>::const_iterator e = expected.begin();
+    for (typename Tree::iterator it = tree.begin(); it != tree.end();
+            ++it, ++e) {
+        if (e == expected.end() || key_of(*it) != e->first
+                || &*it != e->second) {
+            return false;
+        }
+    }
+    if (e != expected.end()) {
+        return false;
+    }
+    map<int, Item *>::const_reverse_iterator r = expected.rbegin();
+    for (Item *x = tree.last(); x != NULL; x = tree.prev(x), ++r) {
+        if (r == expected.rend() || x != r->second) {
+            return false;
+        }
+    }
+    return r == expected.rend();
+}
+
+int main() {
+    const int ITEMS = 2000, OPS = 40000;
+    mt19937 rng(26);
+    uniform_int_distribution<int> pick(0, ITEMS - 1);
+
+    vector<Item> items(ITEMS);
+    for (int i = 0; i < ITEMS; ++i) {
+        items[i].id = i;
+        items[i].rank = (i * 7919) % ITEMS;
+    }
+
+    IdTree ids;
+    RankTree ranks;
+    map<int, Item *> expected_ids, expected_ranks;
+    for (int op = 0; op < OPS; ++op) {
+        Item &item = items[pick(rng)];
+        if (rng() % 3 != 0) {
+            bool fresh = expected_ids.insert(make_pair(item.id, &item)).second;
+            CHECK(ids.insert(item) == fresh);
+            if (fresh) {
+                CHECK(ranks.insert(item));
+                expected_ranks[item.rank] = &item;
+            }
+        } else {
+            bool present = expected_ids.erase(item.id) == 1;
+            CHECK(ids.erase(item.id) == (present ? &item : NULL));
+            if (present) {
+                ranks.erase(item);
+                expected_ranks.erase(item.rank);
+            }
+            CHECK(!IdTree::is_linked(item) && !RankTree::is_linked(item));
+        }
+
+        int key = pick(rng);
+        map<int, Item *>::iterator e = expected_ids.find(key);
+        CHECK(ids.find(key) == (e == expected_ids.end() ? NULL : e->second));
+        e = expected_ids.lower_bound(key);
+        CHECK(ids.lower_bound(key)
+                == (e == expected_ids.end() ? NULL : e->second));
+        e = expected_ids.upper_bound(key);
+        CHECK(ids.upper_bound(key)
+                == (e == expected_ids.end() ? NULL : e->second));
+
+        if (op % 1000 == 0 || op == OPS - 1) {
+            CHECK(ids.size() == expected_ids.size());
+            CHECK(ranks.size() == expected_ranks.size());
+            CHECK(same_keys(ids, IdOf(), expected_ids));
+            CHECK(same_keys(ranks, RankOf(), expected_ranks));
+            CHECK(is_red_black(ids, IdOf()));
+            CHECK(is_red_black(ranks, RankOf()));
+        }
+        if (check_failures() > 0) {
+            break;
+        }
+    }
+
+    ids.clear();
+    CHECK(ids.empty() && ids.root() == NULL);
+    for (int i = 0; i < ITEMS; ++i) {
+        CHECK(!IdTree::is_linked(items[i]));
+    }
+    return check_status();
+}
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * Name        : journal_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks MutationJournal: a tree replayed from the log of a
+ *               run of random inserts and erases must match the std::map
+ *               the run was applied to; a log ending in garbage, or in a
+ *               record whose length runs past the end of the file, must
+ *               replay up to that point and be cut back to it when opened
+ *               again; and records logged after a checkpoint must survive
+ *               the next replay.
+ ******************************************************************************/
+#include "check.h"
+#include "../journal.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+typedef RedBlackTree<int, int> IntTree;
+typedef MutationJournal<int, int> IntJournal;
+
+off_t file_size(const string &path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_size : -1;
+}
+
+void append_bytes(const string &path, const string &bytes) {
+    ofstream file(path.c_str(), ios::out | ios::binary | ios::app);
+    file.write(bytes.data(), bytes.size());
+}
+
+/**
+ * Returns a record header, as the journal writes one: op, payload length
+ * and checksum.
+ */
+string record_header(char op, uint32_t length, uint32_t checksum) {
+    string header(1, op);
+    header.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    header.append(reinterpret_cast<const char *>(&checksum),
+            sizeof(checksum));
+    return header;
+}
+
+/**
+ * Replays path into a new tree and returns true if it matches expected.
+ */
+bool replays_to(const string &path, const map<int, int> &expected,
+        JournalReplayStats &stats) {
+    IntTree tree;
+    stats = IntJournal::replay(path, tree);
+    return tree.size() == expected.size()
+            && same_contents(tree.begin(), tree.end(), expected);
+}
+
+/**
+ * Logs a sorted run of inserts, which replay() must bulk load, and then
+ * random inserts and erases, and replays them.
+ */
+void check_replay(const string &path, map<int, int> &expected) {
+    const int RUN = 1000, OPS = 20000;
+    mt19937 rng(41);
+    IntTree tree;
+    uint64_t logged = 0;
+    {
+        IntJournal journal(path);
+        for (int key = 0; key < RUN; ++key) {
+            tree.insert(key, key);
+            expected[key] = key;
+            journal.log_insert(key, key);
+            ++logged;
+        }
+        for (int op = 0; op < OPS; ++op) {
+            int key = static_cast<int>(rng() % (2 * RUN));
+            if (rng() % 3 == 0) {
+                if (tree.erase(key)) {
+                    expected.erase(key);
+                    journal.log_erase(key);
+                    ++logged;
+                }
+            } else if (expected.insert(make_pair(key, op)).second) {
+                tree.insert(key, op);
+                journal.log_insert(key, op);
+                ++logged;
+            }
+            if (op % 1000 == 0) {
+                journal.sync();
+            }
+        }
+        CHECK(journal.stats().records == logged);
+    }
+
+    JournalReplayStats stats;
+    CHECK(replays_to(path, expected, stats));
+    CHECK(stats.records == logged);
+    CHECK(stats.bulk_loaded == static_cast<uint64_t>(RUN));
+    CHECK(stats.skipped == 0);
+    CHECK(!stats.torn_tail);
+}
+
+/**
+ * Appends tail to the log, which must then replay as before but for a torn
+ * tail, and be cut back to its old length when opened.
+ */
+void check_torn_tail(const string &path, const map<int, int> &expected,
+        const string &tail) {
+    off_t size = file_size(path);
+    append_bytes(path, tail);
+    JournalReplayStats stats;
+    CHECK(replays_to(path, expected, stats));
+    CHECK(stats.torn_tail);
+    {
+        IntJournal journal(path);
+    }
+    CHECK(file_size(path) == size);
+    CHECK(replays_to(path, expected, stats));
+    CHECK(!stats.torn_tail);
+}
+
+void check_checkpoint(const string &path, map<int, int> &expected) {
+    IntTree tree;
+    IntJournal::replay(path, tree);
+    {
+        IntJournal journal(path);
+        journal.checkpoint(tree);
+        CHECK(file_size(path + ".tmp") == -1);
+
+        // Logged to the new file, after the sorted run the checkpoint wrote.
+        tree.erase(expected.begin()->first);
+        journal.log_erase(expected.begin()->first);
+        expected.erase(expected.begin());
+        for (int key = -1; key >= -10; --key) {
+            tree.insert(key, key);
+            journal.log_insert(key, key);
+            expected[key] = key;
+        }
+        journal.sync();
+    }
+    JournalReplayStats stats;
+    CHECK(replays_to(path, expected, stats));
+    CHECK(stats.bulk_loaded == expected.size() - 10 + 1);
+    CHECK(stats.records == stats.bulk_loaded + 11);
+    CHECK(!stats.torn_tail);
+}
+
+int main() {
+    char name[] = "/tmp/journal_check_XXXXXX";
+    int fd = mkstemp(name);
+    if (!CHECK(fd >= 0)) {
+        return check_status();
+    }
+    close(fd);
+    string path(name);
+
+    map<int, int> expected;
+    check_replay(path, expected);
+
+    // A whole record with a bad checksum, a header cut short, and a header
+    // claiming more bytes than the file holds.
+    check_torn_tail(path, expected, record_header(1, 8, 0) + string(8, 'x'));
+    check_torn_tail(path, expected, string(5, '\x01'));
+    check_torn_tail(path, expected, record_header(1, 0xfffffff0u, 0));
+
+    check_checkpoint(path, expected);
+
+    remove(path.c_str());
+    return check_status();
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Name        : mappedtree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks that MappedRedBlackTree keeps its contents in its
+ *               file. A temporary file is reopened after each round of
+ *               inserts and must hold every pair so far, grown a whole page
+ *               at a time; values assigned through it->second and value()
+ *               must be there after reopening; a file left as by an insert
+ *               cut short must be repaired on open; and a file of another
+ *               layout or with a bad magic number must be refused.
+ ******************************************************************************/
+#include "check.h"
+#include "../mappedtree.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+
+typedef MappedRedBlackTree<int, int> MappedTree;
+typedef MappedRedBlackTree<int, long long> WideTree;
+
+bool holds(MappedTree &tree, const map<int, int> &expected) {
+    return tree.size() == expected.size()
+            && same_contents(tree.begin(), tree.end(), expected)
+            && red_black_height(tree.height(), tree.size());
+}
+
+template<typename MappedTreeType>
+bool open_throws(const string &path) {
+    try {
+        MappedTreeType tree(path);
+    } catch (const tree_exception &) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Overwrites the 64-bit header word at index with value. The header is
+ * four 32-bit words (magic and sizes), then root, end, size and inserting.
+ */
+void poke_header(const string &path, size_t index, uint64_t value) {
+    fstream file(path.c_str(), ios::in | ios::out | ios::binary);
+    file.seekp(index * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+int main() {
+    char name[] = "/tmp/mappedtree_check_XXXXXX";
+    int fd = mkstemp(name);
+    if (!CHECK(fd >= 0)) {
+        return check_status();
+    }
+    close(fd);
+    string path(name);
+    const size_t PAGE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    mt19937 rng(50);
+    map<int, int> expected;
+    size_t last_size = 0;
+    for (int round = 0; round < 4 && check_failures() == 0; ++round) {
+        MappedTree tree(path, 1);
+        CHECK(holds(tree, expected));
+        for (int i = 0; i < 3000; ++i) {
+            int key = static_cast<int>(rng() % 20000);
+            if (expected.insert(make_pair(key, i)).second) {
+                tree.insert(key, i);
+            }
+        }
+        CHECK(holds(tree, expected));
+        CHECK(tree.file_size() % PAGE == 0 && tree.file_size() > last_size);
+        last_size = tree.file_size();
+    }
+
+    {
+        MappedTree tree(path, 1);
+        for (MappedTree::iterator it = tree.begin(); it != tree.end(); ++it) {
+            it->second = -it->first;
+            expected[it->first] = -it->first;
+        }
+        tree.find(expected.begin()->first).value() = 7;
+        expected.begin()->second = 7;
+        tree.sync();
+    }
+    {
+        MappedTree tree(path, 1);
+        CHECK(holds(tree, expected));
+    }
+
+    // As if the process died in an insert: root is garbage, and open()
+    // must rebuild the tree from the nodes.
+    poke_header(path, 2, 12345);
+    poke_header(path, 5, 1);
+    {
+        MappedTree tree(path, 1);
+        CHECK(holds(tree, expected));
+        tree.insert(-1, -1);
+        expected[-1] = -1;
+    }
+    {
+        MappedTree tree(path, 1);
+        CHECK(holds(tree, expected));
+    }
+
+    CHECK(open_throws<WideTree>(path));
+    poke_header(path, 0, 0);
+    CHECK(open_throws<MappedTree>(path));
+    remove(path.c_str());
+    return check_status();
+}
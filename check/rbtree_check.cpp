@@ -0,0 +1,495 @@
+/*******************************************************************************
+ * Name        : rbtree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks RedBlackTree against std::map, walking the tree with
+ *               valid() along the way to confirm the red-black rules, the
+ *               parent links, the cached minimum and the tombstone count. A
+ *               copy must hold the same pairs as the original and share no
+ *               nodes with it, and so must an assigned tree, even one assigned
+ *               to itself; a moved-from tree must be empty and still usable;
+ *               and swap() must trade whole contents. A clone must have the
+ *               shape of the original, and so must a parallel clone. Random
+ *               inserts, hinted inserts, erases, pop_min() calls, finds,
+ *               find_near() calls and cursor searches must give the map's
+ *               answers with the find cache, the Bloom filter and lazy erase
+ *               off and on, and with an incremental compaction under way. The
+ *               Bloom filter must account for every lookup, keep its
+ *               false-positive rate under 1%, and be rebuilt once a quarter of
+ *               its keys are stale. bulk_load() must build a tree of any size
+ *               from sorted pairs and refuse unsorted ones, as must the sorted
+ *               batch insert and erase; pop_while() must pop exactly the keys
+ *               up to its limit, in order. parallel_for_each() must visit
+ *               every pair once, and parallel_reduce() must fold in key order.
+ *               Built without -DRBTREE_INSTRUMENT, a tree must keep no
+ *               metrics.
+ ******************************************************************************/
+#include "check.h"
+#include "../rbtree.h"
+#include <atomic>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+typedef RedBlackTree<int, int> IntTree;
+typedef map<int, int> IntMap;
+
+/**
+ * Returns true if tree is a valid red-black tree holding exactly the pairs
+ * of expected.
+ */
+bool consistent(IntTree &tree, const IntMap &expected) {
+    return tree.valid() && tree.size() == expected.size()
+            && same_contents(tree.begin(), tree.end(), expected);
+}
+
+/**
+ * Inserts count random keys below range into tree and expected.
+ */
+void fill(IntTree &tree, IntMap &expected, unsigned seed, int count,
+        int range) {
+    mt19937 rng(seed);
+    while (count > 0) {
+        int key = static_cast<int>(rng() % range);
+        if (expected.insert(make_pair(key, count)).second) {
+            tree.insert(key, count);
+            --count;
+        }
+    }
+}
+
+vector<pair<int, int> > sorted_pairs(size_t n, int step) {
+    vector<pair<int, int> > pairs(n);
+    for (size_t i = 0; i < n; ++i) {
+        pairs[i] = make_pair(static_cast<int>(i) * step,
+                static_cast<int>(i) % 97);
+    }
+    return pairs;
+}
+
+void check_copies() {
+    IntTree tree;
+    IntMap expected;
+    fill(tree, expected, 29, 2000, 10000);
+    CHECK(consistent(tree, expected));
+
+    // A copy shares nothing with the original.
+    IntTree copy(tree);
+    CHECK(consistent(copy, expected));
+    IntMap changed(expected);
+    copy.insert(-1, -1);
+    changed[-1] = -1;
+    CHECK(consistent(copy, changed));
+    CHECK(consistent(tree, expected));
+
+    IntTree assigned;
+    assigned.insert(5, 5);
+    assigned = copy;
+    CHECK(consistent(assigned, changed));
+    assigned = assigned;
+    CHECK(consistent(assigned, changed));
+
+    // The moved-from tree is empty and still usable.
+    IntTree moved(std::move(assigned));
+    CHECK(consistent(moved, changed));
+    CHECK(consistent(assigned, IntMap()));
+    assigned.insert(7, 7);
+    IntMap seven;
+    seven[7] = 7;
+    CHECK(consistent(assigned, seven));
+
+    swap(moved, tree);
+    CHECK(consistent(moved, expected));
+    CHECK(consistent(tree, changed));
+    tree.swap(assigned);
+    CHECK(consistent(tree, seven));
+    CHECK(consistent(assigned, changed));
+
+    assigned.clear();
+    CHECK(consistent(assigned, IntMap()));
+    changed.clear();
+    fill(assigned, changed, 129, 500, 10000);
+    CHECK(consistent(assigned, changed));
+}
+
+/**
+ * Returns true if a and b have nodes at the same depths: the same height,
+ * leaves, inner nodes and total depth of nodes and of empty links.
+ */
+bool same_shape(const IntTree &a, const IntTree &b) {
+    return a.height() == b.height() && a.leaf_count() == b.leaf_count()
+            && a.internal_node_count() == b.internal_node_count()
+            && a.successful_search_cost() == b.successful_search_cost()
+            && a.unsuccessful_search_cost() == b.unsuccessful_search_cost();
+}
+
+void check_clones() {
+    IntTree tree;
+    IntMap expected;
+    fill(tree, expected, 30, 3000, 10000);
+
+    // A clone has the same shape, not just the same keys.
+    IntTree cloned = tree.clone();
+    CHECK(consistent(cloned, expected));
+    CHECK(cloned.to_ascii_drawing() == tree.to_ascii_drawing());
+    cloned.insert(-1, -1);
+    CHECK(consistent(tree, expected));
+    CHECK(IntTree().clone().size() == 0);
+
+    // Big enough that clone_parallel really splits the work.
+    IntTree big;
+    IntMap big_expected;
+    fill(big, big_expected, 31, 70000, 1 << 20);
+    for (unsigned threads = 1; threads <= 4; threads *= 2) {
+        IntTree parallel = big.clone_parallel(threads);
+        CHECK(consistent(parallel, big_expected));
+        CHECK(same_shape(parallel, big));
+    }
+}
+
+/**
+ * Without -DRBTREE_INSTRUMENT, which instrumentation_check is built with,
+ * the tree keeps no metrics.
+ */
+void check_uninstrumented() {
+    IntTree tree;
+    IntMap expected;
+    fill(tree, expected, 31, 100, 1000);
+    tree.find(1);
+    TreeMetrics metrics = tree.metrics();
+    CHECK(!IntTree::instrumented());
+    CHECK(metrics.counters.comparisons == 0
+            && metrics.counters.allocations == 0
+            && metrics.insert_latency.count() == 0);
+}
+
+bool found(IntTree &tree, IntTree::iterator it, const IntMap &expected,
+        int key) {
+    IntMap::const_iterator e = expected.find(key);
+    if (e == expected.end()) {
+        return it == tree.end();
+    }
+    return it != tree.end() && (*it).first == key && (*it).second == e->second;
+}
+
+/**
+ * Runs ops random operations on tree and expected, checking each result.
+ */
+void churn(IntTree &tree, IntMap &expected, unsigned seed, int ops) {
+    const int RANGE = 3000;
+    mt19937 rng(seed);
+    IntTree::cursor cursor(tree);
+    IntTree::iterator hint = tree.end();
+    bool compacting = false;
+    for (int op = 0; op < ops; ++op) {
+        int key = static_cast<int>(rng() % RANGE);
+        IntMap::iterator e = expected.find(key);
+        switch (rng() % 8) {
+        case 0:
+        case 1:
+            CHECK(tree.erase(key) == (e != expected.end()));
+            if (e != expected.end()) {
+                expected.erase(e);
+            }
+            hint = tree.end();
+            break;
+        case 2:
+            if (!expected.empty()) {
+                CHECK(tree.peek_min() == tree.begin());
+                pair<int, int> min = tree.pop_min();
+                CHECK(min.first == expected.begin()->first
+                        && min.second == expected.begin()->second);
+                expected.erase(expected.begin());
+                hint = tree.end();
+            }
+            break;
+        case 3:
+            if (e == expected.end()) {
+                // A hinted insert near a key that is already there.
+                hint = tree.find_near(hint, key + 1);
+                tree.insert(hint, make_pair(key, op));
+                expected[key] = op;
+                hint = tree.find(key);
+                break;
+            }
+            // Fall through to insert the duplicate.
+        default:
+            bool threw = false;
+            try {
+                tree.insert(key, op);
+            } catch (const tree_exception &) {
+                threw = true;
+            }
+            CHECK(threw == (e != expected.end()));
+            expected.insert(make_pair(key, op));
+            hint = tree.end();
+            break;
+        }
+
+        key = static_cast<int>(rng() % RANGE);
+        CHECK(found(tree, tree.find(key), expected, key));
+        CHECK(found(tree, tree.find_near(hint, key), expected, key));
+        CHECK(found(tree, cursor.find(key), expected, key));
+
+        if (compacting || rng() % 500 == 0) {
+            compacting = !tree.compact_step(32);
+            hint = tree.end();
+        }
+        if (op % 500 == 0 || op == ops - 1) {
+            CHECK(consistent(tree, expected));
+        }
+        if (check_failures() > 0) {
+            return;
+        }
+    }
+    while (!tree.compact_step(1000)) {
+    }
+    CHECK(consistent(tree, expected));
+}
+
+void check_options() {
+    for (int options = 0; options < 8; ++options) {
+        IntTree tree;
+        tree.set_find_cache_slots(options & 1 ? 64 : 0);
+        tree.set_bloom_filter(options & 2 ? 10 : 0);
+        tree.set_lazy_erase(options & 4 ? 0.25 : 0);
+        IntMap expected;
+        churn(tree, expected, 29 + options, 12000);
+        // Each key is looked up about four times between changes.
+        CHECK((tree.find_cache_stats().hits > 0) == ((options & 1) != 0));
+        if (options & 4) {
+            CHECK(tree.tombstone_count() > 0);
+            tree.purge_tombstones();
+            CHECK(tree.tombstone_count() == 0);
+            CHECK(consistent(tree, expected));
+        }
+        tree.compact();
+        CHECK(consistent(tree, expected));
+        tree.clear();
+        expected.clear();
+        CHECK(consistent(tree, expected));
+        churn(tree, expected, 129 + options, 2000);
+    }
+}
+
+/**
+ * Checks the Bloom filter's counters: every lookup is checked, a present
+ * key passes, and an absent one is either rejected or counted as a false
+ * positive; erasing a quarter of the keys rebuilds the filter.
+ */
+void check_bloom() {
+    const int KEYS = 4000;
+    IntTree tree;
+    tree.set_bloom_filter(10);
+    IntMap expected;
+    // Even keys only, so odd ones are certainly absent.
+    for (int key = 0; key < 2 * KEYS; key += 2) {
+        tree.insert(key, key);
+        expected[key] = key;
+    }
+    tree.reset_bloom_filter_stats();
+    uint64_t hits = 0;
+    for (int key = 0; key < 100 * KEYS; ++key) {
+        hits += tree.find(key) != tree.end();
+    }
+    BloomFilterStats stats = tree.bloom_filter_stats();
+    CHECK(hits == static_cast<uint64_t>(KEYS));
+    CHECK(stats.checks == static_cast<uint64_t>(100 * KEYS));
+    CHECK(stats.checks == stats.rejections + stats.false_positives + hits);
+    // Sized for twice the keys at 10 bits each, so well under 1%.
+    CHECK(stats.false_positive_rate() < 0.01);
+    CHECK(stats.rebuilds == 0);
+
+    // The filter goes stale once more than a quarter of the keys left
+    // have been erased, and is rebuilt from the rest.
+    vector<int> erased;
+    for (int key = 0; tree.bloom_filter_stats().rebuilds == 0; key += 2) {
+        CHECK(tree.erase(key));
+        expected.erase(key);
+        erased.push_back(key);
+        CHECK((tree.bloom_filter_stats().rebuilds == 1)
+                == (erased.size() > tree.size() / 4));
+        if (check_failures() > 0) {
+            return;
+        }
+    }
+    CHECK(erased.size() == KEYS / 5 + 1);
+    for (size_t i = 0; i < erased.size(); ++i) {
+        tree.insert(erased[i], -erased[i]);
+        expected[erased[i]] = -erased[i];
+    }
+    tree.reset_bloom_filter_stats();
+    for (size_t i = 0; i < erased.size(); ++i) {
+        CHECK(found(tree, tree.find(erased[i]), expected, erased[i]));
+    }
+    stats = tree.bloom_filter_stats();
+    CHECK(stats.checks == erased.size() && stats.rejections == 0);
+    CHECK(consistent(tree, expected));
+}
+
+void check_bulk_load() {
+    // Every size up to a few full levels, where the red level changes.
+    for (size_t n = 0; n <= 70; ++n) {
+        vector<pair<int, int> > pairs = sorted_pairs(n, 3);
+        IntTree tree;
+        tree.insert(-1, -1);
+        tree.bulk_load(pairs.begin(), pairs.end());
+        CHECK(consistent(tree, IntMap(pairs.begin(), pairs.end())));
+    }
+    vector<pair<int, int> > pairs = sorted_pairs(100000, 2);
+    IntTree tree;
+    tree.bulk_load(pairs.begin(), pairs.end());
+    IntMap expected(pairs.begin(), pairs.end());
+    CHECK(consistent(tree, expected));
+    fill(tree, expected, 41, 1000, 200000);
+    CHECK(consistent(tree, expected));
+
+    // Out of order: refused, and nothing changes.
+    swap(pairs[500], pairs[501]);
+    bool threw = false;
+    try {
+        tree.bulk_load(pairs.begin(), pairs.end());
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(consistent(tree, expected));
+}
+
+void check_pop_while() {
+    mt19937 rng(44);
+    IntTree tree;
+    IntMap expected;
+    churn(tree, expected, 44, 5000);
+    for (int limit = -1; limit < 3100 && check_failures() == 0;
+            limit += static_cast<int>(rng() % 200)) {
+        vector<pair<int, int> > popped, want;
+        while (!expected.empty() && expected.begin()->first <= limit) {
+            want.push_back(*expected.begin());
+            expected.erase(expected.begin());
+        }
+        CHECK(tree.pop_while(limit, [&](const int &key, const int &value) {
+            popped.push_back(make_pair(key, value));
+        }) == want.size());
+        CHECK(popped == want);
+        CHECK(consistent(tree, expected));
+    }
+}
+
+void check_batches() {
+    IntTree tree;
+    IntMap expected;
+    vector<pair<int, int> > pairs = sorted_pairs(5000, 2);
+    tree.bulk_load(pairs.begin(), pairs.end());
+    expected.insert(pairs.begin(), pairs.end());
+
+    // Every third key below 12000; 1667 of them are already present.
+    vector<pair<int, int> > batch;
+    vector<int> keys;
+    for (int key = 0; key < 12000; key += 3) {
+        batch.push_back(make_pair(key, -key));
+        keys.push_back(key + 1);
+    }
+    size_t fresh = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        fresh += expected.insert(batch[i]).second;
+    }
+    CHECK(tree.insert_sorted_batch(batch.begin(), batch.end()) == fresh);
+    CHECK(consistent(tree, expected));
+
+    size_t present = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        present += expected.erase(keys[i]);
+    }
+    CHECK(tree.erase_sorted_batch(keys.begin(), keys.end()) == present);
+    CHECK(consistent(tree, expected));
+
+    // Out of order: refused, and nothing changes.
+    swap(batch[0], batch[1]);
+    swap(keys[0], keys[1]);
+    bool threw = false;
+    try {
+        tree.insert_sorted_batch(batch.begin(), batch.end());
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw);
+    threw = false;
+    try {
+        tree.erase_sorted_batch(keys.begin(), keys.end());
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(consistent(tree, expected));
+}
+
+struct Run {
+    int first, last;
+    size_t count;
+    bool ordered;
+
+    bool operator==(const Run &rhs) const {
+        return first == rhs.first && last == rhs.last && count == rhs.count
+                && ordered == rhs.ordered;
+    }
+};
+
+void check_parallel() {
+    vector<pair<int, int> > pairs = sorted_pairs(70000, 2);
+    IntTree tree;
+    tree.bulk_load(pairs.begin(), pairs.end());
+    long long sum = 0;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        sum += pairs[i].first + pairs[i].second;
+    }
+
+    for (unsigned threads = 1; threads <= 4; threads *= 2) {
+        atomic<long long> visited_sum(0);
+        atomic<size_t> visited(0);
+        tree.parallel_for_each([&](const int &key, const int &value) {
+            visited_sum += key + value;
+            ++visited;
+        }, threads);
+        CHECK(visited == pairs.size() && visited_sum == sum);
+
+        // Only an in-order fold of the pieces yields one ordered run.
+        Run empty = { 0, 0, 0, true };
+        Run run = tree.parallel_reduce(empty,
+                [](const int &key, const int &) {
+                    Run r = { key, key, 1, true };
+                    return r;
+                },
+                [](const Run &a, const Run &b) {
+                    if (a.count == 0) {
+                        return b;
+                    }
+                    if (b.count == 0) {
+                        return a;
+                    }
+                    Run r = { a.first, b.last, a.count + b.count,
+                            a.ordered && b.ordered && a.last < b.first };
+                    return r;
+                }, threads);
+        Run whole = { pairs.front().first, pairs.back().first, pairs.size(),
+                true };
+        CHECK(run == whole);
+    }
+}
+
+int main() {
+    check_copies();
+    check_clones();
+    check_uninstrumented();
+    check_options();
+    check_bloom();
+    check_bulk_load();
+    check_pop_while();
+    check_batches();
+    check_parallel();
+    return check_status();
+}
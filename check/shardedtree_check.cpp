@@ -0,0 +1,203 @@
+/*******************************************************************************
+ * Name        : shardedtree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks how ShardedRedBlackTree spreads keys over its shards.
+ *               Splits chosen from a sample must give shards of about the
+ *               same size, and each shard must hold just the keys from its
+ *               split up to the next. Iteration and for_each() must step
+ *               over empty shards in key order. Four threads, each working
+ *               its own keys in every shard, must all get the answers a
+ *               std::map of their own gives them.
+ ******************************************************************************/
+#include "check.h"
+#include "../shardedtree.h"
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+typedef ShardedRedBlackTree<int, int> ShardedTree;
+
+const int RANGE = 4000;
+
+/**
+ * Runs ops random inserts, erases and finds on the keys k with
+ * k % stride == offset, and returns how many answers differed from
+ * expected.
+ */
+int mismatches(ShardedTree &tree, map<int, int> &expected, unsigned seed,
+        int ops, int stride, int offset) {
+    mt19937 rng(seed);
+    int wrong = 0;
+    for (int op = 0; op < ops; ++op) {
+        int key = static_cast<int>(rng() % (RANGE / stride)) * stride + offset;
+        if (rng() % 5 < 2) {
+            wrong += tree.erase(key) != (expected.erase(key) == 1);
+        } else {
+            bool fresh = expected.insert(make_pair(key, op)).second;
+            bool threw = false;
+            try {
+                tree.insert(key, op);
+            } catch (const tree_exception &) {
+                threw = true;
+            }
+            wrong += threw == fresh;
+        }
+        key = static_cast<int>(rng() % (RANGE / stride)) * stride + offset;
+        int value = -1;
+        map<int, int>::iterator e = expected.find(key);
+        wrong += tree.find(key, value) != (e != expected.end());
+        wrong += e != expected.end() && value != e->second;
+        wrong += tree.contains(key) != (e != expected.end());
+    }
+    return wrong;
+}
+
+/**
+ * Returns true if shard i holds exactly the keys of expected from
+ * splits[i - 1] up to splits[i].
+ */
+bool routed(const ShardedTree &tree, const vector<int> &splits,
+        const map<int, int> &expected) {
+    for (size_t i = 0; i < tree.shard_count(); ++i) {
+        map<int, int>::const_iterator lo = i == 0 ? expected.begin()
+                : expected.lower_bound(splits[i - 1]);
+        map<int, int>::const_iterator hi = i == splits.size() ? expected.end()
+                : expected.lower_bound(splits[i]);
+        if (tree.shard_size(i) != static_cast<size_t>(distance(lo, hi))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Collect {
+    map<int, int> *pairs;
+    bool *ordered;
+
+    void operator()(int key, int value) const {
+        *ordered = *ordered && (pairs->empty() || pairs->rbegin()->first < key);
+        (*pairs)[key] = value;
+    }
+};
+
+/**
+ * Returns true if both iteration and for_each() visit expected in order.
+ */
+bool walks_in_order(ShardedTree &tree, const map<int, int> &expected) {
+    map<int, int> visited;
+    bool ordered = true;
+    Collect collect = { &visited, &ordered };
+    tree.for_each(collect);
+    return tree.size() == expected.size()
+            && same_contents(tree.begin(), tree.end(), expected)
+            && ordered && visited == expected;
+}
+
+void check_splits() {
+    vector<int> sample;
+    for (int key = 0; key < RANGE; key += 7) {
+        sample.push_back(key);
+    }
+    vector<int> splits = ShardedTree::choose_splits(sample, 8);
+    ShardedTree tree(splits);
+    CHECK(splits.size() == 7 && tree.shard_count() == 8);
+
+    map<int, int> expected;
+    for (size_t i = 0; i < sample.size(); ++i) {
+        tree.insert(sample[i], 0);
+        expected[sample[i]] = 0;
+    }
+    for (size_t i = 0; i < tree.shard_count(); ++i) {
+        CHECK(8 * tree.shard_size(i) + 8 >= sample.size()
+                && 8 * tree.shard_size(i) <= sample.size() + 8);
+    }
+    for (int round = 0; round < 10 && check_failures() == 0; ++round) {
+        CHECK(mismatches(tree, expected, 42 + round, 2000, 1, 0) == 0);
+        CHECK(routed(tree, splits, expected));
+        CHECK(walks_in_order(tree, expected));
+    }
+
+    // Every key in a sample of one key repeated is the same split.
+    CHECK(ShardedTree::choose_splits(vector<int>(100, 5), 8).size() == 1);
+    CHECK(ShardedTree::choose_splits(vector<int>(), 8).empty());
+    vector<int> unsorted;
+    unsorted.push_back(2);
+    unsorted.push_back(1);
+    bool threw = false;
+    try {
+        ShardedTree bad(unsorted);
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void check_empty_shards() {
+    vector<int> splits;
+    for (int split = 10; split <= 50; split += 10) {
+        splits.push_back(split);
+    }
+    ShardedTree tree(splits);
+    map<int, int> expected;
+    CHECK(walks_in_order(tree, expected) && tree.begin() == tree.end());
+
+    // Only the shards of [20, 30) and [50, ...) hold keys.
+    for (int key = 20; key < 30; key += 3) {
+        tree.insert(key, -key);
+        expected[key] = -key;
+    }
+    tree.insert(50, -50);
+    expected[50] = -50;
+    CHECK(tree.shard_size(0) == 0 && tree.shard_size(2) == 4
+            && tree.shard_size(5) == 1);
+    CHECK(walks_in_order(tree, expected));
+    CHECK(tree.begin()->first == 20);
+
+    for (map<int, int>::iterator e = expected.begin(); e != expected.end();
+            ++e) {
+        CHECK(tree.erase(e->first));
+    }
+    CHECK(tree.size() == 0 && tree.begin() == tree.end());
+}
+
+void check_threads() {
+    vector<int> splits;
+    for (int split = RANGE / 8; split < RANGE; split += RANGE / 8) {
+        splits.push_back(split);
+    }
+    ShardedTree tree(splits);
+
+    // Thread t owns the keys k with k % THREADS == t, which fall in every
+    // shard, so the threads contend for every shard's lock.
+    const int THREADS = 4;
+    vector<map<int, int> > expected_by_thread(THREADS);
+    vector<int> wrong(THREADS);
+    vector<thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.push_back(thread([&, t] {
+            wrong[t] = mismatches(tree, expected_by_thread[t], 142 + t, 10000,
+                    THREADS, t);
+        }));
+    }
+    map<int, int> expected;
+    for (int t = 0; t < THREADS; ++t) {
+        threads[t].join();
+        CHECK(wrong[t] == 0);
+        expected.insert(expected_by_thread[t].begin(),
+                expected_by_thread[t].end());
+    }
+    CHECK(routed(tree, splits, expected));
+    CHECK(walks_in_order(tree, expected));
+}
+
+int main() {
+    check_splits();
+    check_empty_shards();
+    check_threads();
+    return check_status();
+}
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * Name        : splittree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks the value slab behind SplitRedBlackTree. A reference
+ *               to a value must stay good while the slab grows by whole
+ *               chunks around it; a slot freed by an erase must be reused by
+ *               the next insert, holding the new value, so that the slab
+ *               does not grow; and clear() must free every slot for reuse.
+ *               String values make a stale or doubly freed slot show up.
+ ******************************************************************************/
+#include "check.h"
+#include "../splittree.h"
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+typedef SplitRedBlackTree<int, string> SplitTree;
+
+string value_of(int n) {
+    ostringstream oss;
+    oss << "value " << n;
+    return oss.str();
+}
+
+int main() {
+    // Several chunks of slots.
+    const int KEYS = 5000;
+    SplitTree tree;
+    map<int, string> expected;
+    tree.insert(0, value_of(0));
+    expected[0] = value_of(0);
+    string &first = tree.find(0).value();
+    for (int key = 1; key < KEYS; ++key) {
+        tree.insert(key, value_of(key));
+        expected[key] = value_of(key);
+    }
+    CHECK(first == value_of(0));
+    first = "changed";
+    expected[0] = "changed";
+    CHECK(same_contents(tree.begin(), tree.end(), expected));
+
+    // Trade keys in and out at a constant size: only freed slots are used.
+    size_t value_bytes = tree.memory_usage().second;
+    mt19937 rng(36);
+    for (int op = 0; op < 20000; ++op) {
+        int key = static_cast<int>(rng() % (2 * KEYS));
+        map<int, string>::iterator e = expected.find(key);
+        if (e != expected.end()) {
+            CHECK(tree.erase(key));
+            expected.erase(e);
+        } else if (expected.size() < static_cast<size_t>(KEYS)) {
+            tree.insert(key, value_of(op));
+            expected[key] = value_of(op);
+        }
+        key = static_cast<int>(rng() % (2 * KEYS));
+        SplitTree::iterator it = tree.find(key);
+        e = expected.find(key);
+        CHECK(e == expected.end() ? it == tree.end()
+                : it != tree.end() && it.value() == e->second);
+        if (check_failures() > 0) {
+            return check_status();
+        }
+    }
+    CHECK(tree.memory_usage().second == value_bytes);
+    CHECK(tree.size() == expected.size());
+    CHECK(same_contents(tree.begin(), tree.end(), expected));
+    CHECK(red_black_height(tree.height(), tree.size()));
+
+    tree.clear();
+    CHECK(tree.size() == 0 && tree.begin() == tree.end());
+    for (int key = 0; key < KEYS; ++key) {
+        tree.insert(-key, value_of(-key));
+    }
+    CHECK(tree.memory_usage().second == value_bytes);
+    CHECK(tree.find(-7).value() == value_of(-7));
+    return check_status();
+}
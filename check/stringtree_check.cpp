@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * Name        : stringtree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks the key order of StringKeyTree where its inline
+ *               8-byte prefixes cannot decide it: keys built from stems of
+ *               7 to 10 bytes and endings with zero bytes and bytes above
+ *               0x7f, inserted in random order, must come back in the order
+ *               of std::string, byte for byte. Each key must be found, and
+ *               each key one byte shorter or longer must be found only if
+ *               it was inserted too.
+ ******************************************************************************/
+#include "check.h"
+#include "../stringtree.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef StringKeyTree<int> StringTree;
+
+/**
+ * Returns every stem followed by every ending of up to two bytes. Stems of
+ * 7 and 8 bytes put the first byte that differs just inside or just past
+ * the inline prefix.
+ */
+vector<string> tricky_keys() {
+    const string stems[] = { "", "a", "abcdefg", "abcdefgh", "abcdefghi",
+            "abcdefghij", string("abcdefg\0", 8), "\xff\xff\xff\xff\xff\xff"
+                    "\xff\xff" };
+    const char bytes[] = { '\0', '\x01', 'a', 'h', '\x7f', '\x80', '\xff' };
+    const size_t BYTES = sizeof(bytes);
+    vector<string> keys;
+    for (size_t s = 0; s < sizeof(stems) / sizeof(stems[0]); ++s) {
+        keys.push_back(stems[s]);
+        for (size_t i = 0; i < BYTES; ++i) {
+            keys.push_back(stems[s] + bytes[i]);
+            for (size_t j = 0; j < BYTES; ++j) {
+                keys.push_back(stems[s] + bytes[i] + bytes[j]);
+            }
+        }
+    }
+    // Stems overlap ("abcdefg" + 'h' is "abcdefgh"), so drop repeats.
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+bool has_key(StringTree &tree, const string &key,
+        const map<string, int> &expected) {
+    StringTree::iterator it = tree.find(key);
+    map<string, int>::const_iterator e = expected.find(key);
+    if (e == expected.end()) {
+        return it == tree.end();
+    }
+    return it != tree.end() && it.key() == key && it.value() == e->second;
+}
+
+int main() {
+    vector<string> keys = tricky_keys();
+    mt19937 rng(33);
+    shuffle(keys.begin(), keys.end(), rng);
+
+    // Insert every other key, so neighbours of stored keys are missing.
+    StringTree tree;
+    map<string, int> expected;
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        tree.insert(keys[i], static_cast<int>(i));
+        expected[keys[i]] = static_cast<int>(i);
+    }
+    CHECK(tree.size() == expected.size());
+    CHECK(same_contents(tree.begin(), tree.end(), expected));
+    CHECK(red_black_height(tree.height(), tree.size()));
+
+    for (size_t i = 0; i < keys.size() && check_failures() == 0; ++i) {
+        const string &key = keys[i];
+        CHECK(has_key(tree, key, expected));
+        CHECK(has_key(tree, key + '\0', expected));
+        if (!key.empty()) {
+            CHECK(has_key(tree, key.substr(0, key.size() - 1), expected));
+        }
+    }
+
+    // A duplicate is refused and changes nothing.
+    size_t memory = tree.memory_usage();
+    bool threw = false;
+    try {
+        tree.insert(expected.begin()->first, -1);
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw && tree.memory_usage() == memory);
+    CHECK(same_contents(tree.begin(), tree.end(), expected));
+    return check_status();
+}
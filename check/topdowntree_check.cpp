@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Name        : topdowntree_check.cpp
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Checks TopDownRedBlackTree, whose nodes have no parent link
+ *               and whose iterators carry their path instead. The iterator
+ *               find() returns must walk on in key order, a copy of it must
+ *               walk on its own, and ++ from end() must start over, or throw
+ *               if the tree is empty. Keys erased one at a time in random
+ *               order, with the single-pass erase moving a predecessor's pair
+ *               into an inner node, must leave the rest with their values and
+ *               the height in bounds, down to an empty tree.
+ ******************************************************************************/
+#include "check.h"
+#include "../topdowntree.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef TopDownRedBlackTree<int, int> TopDownTree;
+
+bool in_bounds(const TopDownTree &tree, const map<int, int> &expected) {
+    return tree.size() == expected.size()
+            && red_black_height(tree.height(), tree.size());
+}
+
+void check_iterators() {
+    TopDownTree tree;
+    bool threw = false;
+    try {
+        TopDownTree::iterator it = tree.end();
+        ++it;
+    } catch (const tree_exception &) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // In increasing order, the worst case for the depth of the path.
+    const int KEYS = 1 << 16;
+    for (int key = 0; key < KEYS; ++key) {
+        tree.insert(key, -key);
+    }
+    CHECK(red_black_height(tree.height(), tree.size()));
+    int next = 0;
+    for (TopDownTree::iterator it = tree.begin(); it != tree.end(); ++it) {
+        if (!CHECK(it.key() == next && it.value() == -next)) {
+            return;
+        }
+        ++next;
+    }
+    CHECK(next == KEYS);
+
+    for (int key = 0; key < KEYS; key += 4099) {
+        TopDownTree::iterator it = tree.find(key);
+        TopDownTree::iterator copy = it;
+        for (int i = 1; i < 100 && key + i < KEYS; ++i) {
+            CHECK((++it).key() == key + i);
+        }
+        CHECK(copy.key() == key && (*++copy).first == key + 1);
+    }
+    TopDownTree::iterator it = tree.end();
+    CHECK((++it).key() == 0);
+    tree.find(KEYS - 1).value() = 1;
+    CHECK(tree.find(KEYS - 1).value() == 1);
+}
+
+void check_erase() {
+    const int KEYS = 5000;
+    mt19937 rng(35);
+    vector<int> keys(KEYS);
+    for (int i = 0; i < KEYS; ++i) {
+        keys[i] = 3 * i;
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    TopDownTree tree;
+    map<int, int> expected;
+    for (int i = 0; i < KEYS; ++i) {
+        tree.insert(keys[i], i);
+        expected[keys[i]] = i;
+    }
+
+    shuffle(keys.begin(), keys.end(), rng);
+    for (int i = 0; i < KEYS; ++i) {
+        CHECK(!tree.erase(keys[i] + 1));
+        CHECK(tree.erase(keys[i]));
+        expected.erase(keys[i]);
+        CHECK(tree.find(keys[i]) == tree.end());
+        CHECK(in_bounds(tree, expected));
+        if (i % 250 == 0) {
+            CHECK(same_contents(tree.begin(), tree.end(), expected));
+        }
+        if (check_failures() > 0) {
+            return;
+        }
+    }
+    CHECK(tree.size() == 0 && tree.begin() == tree.end());
+    CHECK(!tree.erase(0));
+    tree.insert(1, 1);
+    CHECK(tree.size() == 1 && tree.begin().key() == 1);
+}
+
+int main() {
+    check_iterators();
+    check_erase();
+    return check_status();
+}
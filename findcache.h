@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * Name        : findcache.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Direct-mapped cache from key to node that a tree can consult
+ *               before descending. Under skewed lookups the few hot keys stay
+ *               in their slots and are found in O(1).
+ ******************************************************************************/
+#ifndef FINDCACHE_H_
+#define FINDCACHE_H_
+
+#include "treehash.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+struct FindCacheStats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t invalidations;
+
+	FindCacheStats() :
+			hits(0), misses(0), invalidations(0) {
+	}
+
+	double hit_rate() const {
+		uint64_t lookups = hits + misses;
+		return lookups == 0 ? 0 : (double) hits / lookups;
+	}
+};
+
+/**
+ * Each slot remembers the last node found for a key hashing to it. Only
+ * found keys are stored, so a slot is either empty or points at a live node
+ * of the tree; the tree must call invalidate() before freeing a node and
+ * flush() before freeing all of them. N needs a key() accessor.
+ */
+template<typename K, typename N>
+class FindCache {
+public:
+	FindCache() :
+			shift_(0) {
+	}
+
+	/**
+	 * A copy has the same number of slots, all empty, and fresh counters:
+	 * the nodes of the original are not the copy's.
+	 */
+	FindCache(const FindCache &other) :
+			slots_(other.slots_.size(), static_cast<N*>(NULL)),
+			shift_(other.shift_) {
+	}
+
+	/**
+	 * Sets the number of slots, rounded up to a power of two of at least 2,
+	 * and empties them. 0 turns the cache off.
+	 */
+	void resize(size_t slots) {
+		static_assert(is_hashable<K>::value,
+				"the find cache needs std::hash for the key type");
+		unsigned bits = 1;
+		while (bits < 63 && (size_t(1) << bits) < slots)
+			++bits;
+		std::vector<N*>(slots == 0 ? 0 : size_t(1) << bits,
+				static_cast<N*>(NULL)).swap(slots_);
+		shift_ = 64 - bits;
+	}
+
+	inline bool enabled() const {
+		return !slots_.empty();
+	}
+
+	size_t slots() const {
+		return slots_.size();
+	}
+
+	/**
+	 * Returns the node cached for key, or NULL on a miss.
+	 */
+	N* lookup(const K &key) {
+		N *n = slots_[slot_of(key)];
+		if (n != NULL && !(n->key() < key) && !(key < n->key())) {
+			++stats_.hits;
+			return n;
+		}
+		++stats_.misses;
+		return NULL;
+	}
+
+	/**
+	 * Remembers n as the node holding key, evicting the slot's old entry.
+	 */
+	inline void store(const K &key, N *n) {
+		slots_[slot_of(key)] = n;
+	}
+
+	/**
+	 * Forgets n, which holds key, if it is cached.
+	 */
+	void invalidate(const K &key, const N *n) {
+		N *&slot = slots_[slot_of(key)];
+		if (slot == n) {
+			slot = NULL;
+			++stats_.invalidations;
+		}
+	}
+
+	/**
+	 * Empties every slot.
+	 */
+	void flush() {
+		std::fill(slots_.begin(), slots_.end(), static_cast<N*>(NULL));
+	}
+
+	const FindCacheStats& stats() const {
+		return stats_;
+	}
+
+	void reset_stats() {
+		stats_ = FindCacheStats();
+	}
+
+	void swap(FindCache &other) {
+		slots_.swap(other.slots_);
+		std::swap(shift_, other.shift_);
+		std::swap(stats_, other.stats_);
+	}
+
+private:
+	std::vector<N*> slots_;
+	unsigned shift_;
+	FindCacheStats stats_;
+
+	FindCache& operator=(const FindCache &);
+
+	/**
+	 * The top bits of the key's hash.
+	 */
+	inline size_t slot_of(const K &key) const {
+		return static_cast<size_t>(tree_hash(key) >> shift_);
+	}
+};
+
+#endif /* FINDCACHE_H_ */
@@ -0,0 +1,502 @@
+/*******************************************************************************
+ * Name        : fixedtree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Red-black tree of at most N nodes, all stored inside the tree
+ *               object itself. Nothing is ever allocated on the heap and
+ *               nothing throws: a full tree or a duplicate key is reported by
+ *               the return value. The constructor is constexpr, so a tree
+ *               with static storage duration is ready before any code runs.
+ ******************************************************************************/
+#ifndef FIXEDTREE_H_
+#define FIXEDTREE_H_
+
+#include <cstddef>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Result of FixedRedBlackTree::insert().
+ */
+enum FixedTreeStatus {
+	FIXED_TREE_OK, FIXED_TREE_DUPLICATE, FIXED_TREE_FULL
+};
+
+template<typename K, typename V, size_t N>
+class FixedRedBlackTree;
+
+template<typename K, typename V, size_t N>
+class FixedTreeIterator {
+	typedef FixedRedBlackTree<K, V, N> tree_type;
+	typedef typename tree_type::index_type index_type;
+
+public:
+	FixedTreeIterator() noexcept :
+			index_(tree_type::NIL), tree_(NULL) {
+	}
+
+	bool operator==(const FixedTreeIterator &rhs) const noexcept {
+		return index_ == rhs.index_;
+	}
+
+	bool operator!=(const FixedTreeIterator &rhs) const noexcept {
+		return index_ != rhs.index_;
+	}
+
+	const K& key() const noexcept {
+		return tree_->payload(index_)->key;
+	}
+
+	V& value() const noexcept {
+		return tree_->payload(index_)->value;
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key. ++ from
+	 * end() moves to the first key, or stays at end() if the tree is empty.
+	 */
+	FixedTreeIterator& operator++() noexcept {
+		index_ = index_ == tree_type::NIL ?
+				tree_->first() : tree_->successor(index_);
+		return *this;
+	}
+
+	FixedTreeIterator operator++(int) noexcept {
+		FixedTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	index_type index_;
+	tree_type *tree_;
+	friend class FixedRedBlackTree<K, V, N> ;
+
+	FixedTreeIterator(index_type index, tree_type *tree) noexcept :
+			index_(index), tree_(tree) {
+	}
+};
+
+/**
+ * Red-black tree with room for N key-value pairs, for paths where neither
+ * operator new nor an exception is allowed. Every operation is noexcept and
+ * O(log N) at worst, with no allocation; K and V must be nothrow copy
+ * constructible, and comparing keys with < must not throw.
+ *
+ * Nodes link to each other by index, as in IndexedRedBlackTree, using 16-bit
+ * indices when N allows. The links of all N nodes sit in one array and the
+ * keys and values in another, constructed in place on insert and destroyed
+ * on erase; freed nodes are kept on a free list threaded through the links.
+ * Both arrays start zeroed, so the constructor is constexpr and a static
+ * tree is initialized at compile time, before any code runs.
+ *
+ * The tree cannot be copied. It is not a Tree: the statistics interface
+ * would add a virtual table and allocate for its drawing.
+ */
+template<typename K, typename V, size_t N>
+class FixedRedBlackTree {
+	static_assert(N > 0 && N < UINT32_MAX, "N must be in [1, UINT32_MAX)");
+	static_assert(std::is_nothrow_copy_constructible<K>::value
+			&& std::is_nothrow_copy_constructible<V>::value,
+			"FixedRedBlackTree needs K and V that copy without throwing");
+	static_assert(noexcept(std::declval<const K&>() < std::declval<const K&>()),
+			"FixedRedBlackTree needs a key comparison that cannot throw");
+
+public:
+	typedef typename std::conditional<(N < UINT16_MAX), uint16_t, uint32_t>::type
+			index_type;
+	typedef FixedTreeIterator<K, V, N> iterator;
+
+	// Marks a missing child or parent, and the end of the free list.
+	static const index_type NIL = N < UINT16_MAX ?
+			static_cast<index_type>(UINT16_MAX) :
+			static_cast<index_type>(UINT32_MAX);
+
+	constexpr FixedRedBlackTree() noexcept :
+			links_{}, payloads_{}, root_(NIL), free_(NIL), used_(0),
+			size_(0) {
+	}
+
+	~FixedRedBlackTree() {
+		clear();
+	}
+
+	/**
+	 * Inserts a key-value pair. Returns FIXED_TREE_DUPLICATE, changing
+	 * nothing, if key is already present, and FIXED_TREE_FULL if all N nodes
+	 * are in use.
+	 */
+	FixedTreeStatus insert(const K &key, const V &value) noexcept {
+		index_type x = root_, y = NIL;
+		bool go_left = false;
+		while (x != NIL) {
+			y = x;
+			const K &k = payload(x)->key;
+			if (key < k) {
+				go_left = true;
+				x = links_[x].left;
+			} else if (k < key) {
+				go_left = false;
+				x = links_[x].right;
+			} else {
+				return FIXED_TREE_DUPLICATE;
+			}
+		}
+		index_type z = allocate();
+		if (z == NIL)
+			return FIXED_TREE_FULL;
+		new (&payloads_[z]) Payload(key, value);
+		Links &l = links_[z];
+		l.left = l.right = NIL;
+		l.parent = y;
+		l.red = true;
+		if (y == NIL)
+			root_ = z;
+		else if (go_left)
+			links_[y].left = z;
+		else
+			links_[y].right = z;
+		++size_;
+		insert_fixup(z);
+		return FIXED_TREE_OK;
+	}
+
+	/**
+	 * Removes key, returning false if it was not present.
+	 */
+	bool erase(const K &key) noexcept {
+		index_type z = find_index(key);
+		if (z == NIL)
+			return false;
+		erase_node(z);
+		return true;
+	}
+
+	iterator find(const K &key) noexcept {
+		return iterator(find_index(key), this);
+	}
+
+	bool contains(const K &key) const noexcept {
+		return find_index(key) != NIL;
+	}
+
+	iterator begin() noexcept {
+		return iterator(first(), this);
+	}
+
+	iterator end() noexcept {
+		return iterator(NIL, this);
+	}
+
+	/**
+	 * Removes every pair. O(1) when K and V are trivially destructible;
+	 * otherwise each is destroyed in key order.
+	 */
+	void clear() noexcept {
+		if (!(std::is_trivially_destructible<K>::value
+				&& std::is_trivially_destructible<V>::value))
+			for (index_type x = first(); x != NIL; x = successor(x))
+				payload(x)->~Payload();
+		root_ = free_ = NIL;
+		used_ = 0;
+		size_ = 0;
+	}
+
+	size_t size() const noexcept {
+		return size_;
+	}
+
+	bool empty() const noexcept {
+		return size_ == 0;
+	}
+
+	bool full() const noexcept {
+		return size_ == N;
+	}
+
+	static constexpr size_t capacity() noexcept {
+		return N;
+	}
+
+	/**
+	 * Returns the height of the tree: -1 when empty, 0 for a lone root.
+	 */
+	int height() const noexcept {
+		return height(root_) - 1;
+	}
+
+private:
+	/**
+	 * A node's links and color. Zeroed links are never read: a node's are
+	 * set when it is inserted.
+	 */
+	struct Links {
+		index_type left, right, parent;
+		bool red;
+	};
+
+	struct Payload {
+		K key;
+		V value;
+
+		Payload(const K &k, const V &v) noexcept :
+				key(k), value(v) {
+		}
+	};
+
+	Links links_[N];
+	typename std::aligned_storage<sizeof(Payload), alignof(Payload)>::type
+			payloads_[N];
+	index_type root_;
+	// Head of the list of freed nodes, linked through their parent links,
+	// and the number of nodes ever handed out since the last clear().
+	index_type free_;
+	size_t used_;
+	size_t size_;
+	friend class FixedTreeIterator<K, V, N> ;
+
+	FixedRedBlackTree(const FixedRedBlackTree &);
+	FixedRedBlackTree& operator=(const FixedRedBlackTree &);
+
+	inline Payload* payload(index_type x) noexcept {
+		return reinterpret_cast<Payload*>(&payloads_[x]);
+	}
+
+	inline const Payload* payload(index_type x) const noexcept {
+		return reinterpret_cast<const Payload*>(&payloads_[x]);
+	}
+
+	/**
+	 * Returns a free node, or NIL if all N are in use.
+	 */
+	index_type allocate() noexcept {
+		if (free_ != NIL) {
+			index_type x = free_;
+			free_ = links_[x].parent;
+			return x;
+		}
+		if (used_ == N)
+			return NIL;
+		return static_cast<index_type>(used_++);
+	}
+
+	void deallocate(index_type x) noexcept {
+		payload(x)->~Payload();
+		links_[x].parent = free_;
+		free_ = x;
+	}
+
+	index_type find_index(const K &key) const noexcept {
+		index_type x = root_;
+		while (x != NIL) {
+			const K &k = payload(x)->key;
+			if (key < k)
+				x = links_[x].left;
+			else if (k < key)
+				x = links_[x].right;
+			else
+				break; // Found!
+		}
+		return x;
+	}
+
+	inline bool is_red(index_type x) const noexcept {
+		return x != NIL && links_[x].red;
+	}
+
+	index_type minimum(index_type x) const noexcept {
+		while (links_[x].left != NIL)
+			x = links_[x].left;
+		return x;
+	}
+
+	index_type first() const noexcept {
+		return root_ == NIL ? NIL : minimum(root_);
+	}
+
+	index_type successor(index_type x) const noexcept {
+		if (links_[x].right != NIL)
+			return minimum(links_[x].right);
+		index_type y = links_[x].parent;
+		while (y != NIL && x == links_[y].right) {
+			x = y;
+			y = links_[y].parent;
+		}
+		return y;
+	}
+
+	int height(index_type x) const noexcept {
+		if (x == NIL)
+			return 0;
+		int l = height(links_[x].left), r = height(links_[x].right);
+		return 1 + (l > r ? l : r);
+	}
+
+	/**
+	 * Implementation of insert fixup method described on p. 316 of CLRS.
+	 */
+	void insert_fixup(index_type z) noexcept {
+		while (is_red(links_[z].parent)) {
+			index_type p = links_[z].parent, g = links_[p].parent;
+			bool left = p == links_[g].left;
+			index_type u = left ? links_[g].right : links_[g].left;
+			if (is_red(u)) {
+				links_[p].red = links_[u].red = false;
+				links_[g].red = true;
+				z = g;
+				continue;
+			}
+			if (z == (left ? links_[p].right : links_[p].left)) {
+				z = p;
+				if (left)
+					left_rotate(z);
+				else
+					right_rotate(z);
+				p = links_[z].parent;
+			}
+			links_[p].red = false;
+			links_[g].red = true;
+			if (left)
+				right_rotate(g);
+			else
+				left_rotate(g);
+		}
+		links_[root_].red = false;
+	}
+
+	/**
+	 * Implementation of delete method described on p. 324 of CLRS, with NIL
+	 * leaves: x_parent tracks the parent of x, which may be NIL.
+	 */
+	void erase_node(index_type z) noexcept {
+		index_type y = z, x, x_parent;
+		bool y_was_red = links_[y].red;
+		if (links_[z].left == NIL) {
+			x = links_[z].right;
+			x_parent = links_[z].parent;
+			transplant(z, x);
+		} else if (links_[z].right == NIL) {
+			x = links_[z].left;
+			x_parent = links_[z].parent;
+			transplant(z, x);
+		} else {
+			y = minimum(links_[z].right);
+			y_was_red = links_[y].red;
+			x = links_[y].right;
+			if (links_[y].parent == z) {
+				x_parent = y;
+			} else {
+				x_parent = links_[y].parent;
+				transplant(y, x);
+				links_[y].right = links_[z].right;
+				links_[links_[y].right].parent = y;
+			}
+			transplant(z, y);
+			links_[y].left = links_[z].left;
+			links_[links_[y].left].parent = y;
+			links_[y].red = links_[z].red;
+		}
+		if (!y_was_red)
+			erase_fixup(x, x_parent);
+		deallocate(z);
+		--size_;
+	}
+
+	/**
+	 * Implementation of delete fixup method described on p. 326 of CLRS.
+	 */
+	void erase_fixup(index_type x, index_type x_parent) noexcept {
+		while (x != root_ && !is_red(x)) {
+			bool left = x == links_[x_parent].left;
+			index_type w = left ? links_[x_parent].right :
+					links_[x_parent].left;
+			if (links_[w].red) {
+				links_[w].red = false;
+				links_[x_parent].red = true;
+				if (left)
+					left_rotate(x_parent);
+				else
+					right_rotate(x_parent);
+				w = left ? links_[x_parent].right : links_[x_parent].left;
+			}
+			index_type inner = left ? links_[w].left : links_[w].right,
+					outer = left ? links_[w].right : links_[w].left;
+			if (!is_red(inner) && !is_red(outer)) {
+				links_[w].red = true;
+				x = x_parent;
+				x_parent = links_[x].parent;
+				continue;
+			}
+			if (!is_red(outer)) {
+				links_[inner].red = false;
+				links_[w].red = true;
+				if (left)
+					right_rotate(w);
+				else
+					left_rotate(w);
+				w = left ? links_[x_parent].right : links_[x_parent].left;
+				outer = left ? links_[w].right : links_[w].left;
+			}
+			links_[w].red = links_[x_parent].red;
+			links_[x_parent].red = false;
+			links_[outer].red = false;
+			if (left)
+				left_rotate(x_parent);
+			else
+				right_rotate(x_parent);
+			x = root_;
+		}
+		if (x != NIL)
+			links_[x].red = false;
+	}
+
+	/**
+	 * Makes v the child of u's parent in place of u. v may be NIL.
+	 */
+	void transplant(index_type u, index_type v) noexcept {
+		index_type p = links_[u].parent;
+		if (p == NIL)
+			root_ = v;
+		else if (u == links_[p].left)
+			links_[p].left = v;
+		else
+			links_[p].right = v;
+		if (v != NIL)
+			links_[v].parent = p;
+	}
+
+	/**
+	 * Implementation of left-rotate method as described on p. 313 of CLRS.
+	 */
+	void left_rotate(index_type x) noexcept {
+		index_type y = links_[x].right;
+		links_[x].right = links_[y].left;
+		if (links_[y].left != NIL)
+			links_[links_[y].left].parent = x;
+		transplant(x, y);
+		links_[y].left = x;
+		links_[x].parent = y;
+	}
+
+	/**
+	 * Implementation of right-rotate method as described on p. 313 of CLRS.
+	 */
+	void right_rotate(index_type x) noexcept {
+		index_type y = links_[x].left;
+		links_[x].left = links_[y].right;
+		if (links_[y].right != NIL)
+			links_[links_[y].right].parent = x;
+		transplant(x, y);
+		links_[y].right = x;
+		links_[x].parent = y;
+	}
+};
+
+template<typename K, typename V, size_t N>
+const typename FixedRedBlackTree<K, V, N>::index_type FixedRedBlackTree<K, V,
+		N>::NIL;
+
+#endif /* FIXEDTREE_H_ */
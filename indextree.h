@@ -0,0 +1,499 @@
+/*******************************************************************************
+ * Name        : indextree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Red-black tree whose nodes live in one std::vector and link
+ *               to each other by 32-bit index instead of by pointer. Links
+ *               take 12 bytes per node instead of 24, nodes sit next to each
+ *               other in memory, and because no link is an address the whole
+ *               tree can be copied, moved or written out as a flat array.
+ ******************************************************************************/
+#ifndef INDEXTREE_H_
+#define INDEXTREE_H_
+
+#include "rbtree.h"
+#include "tree.h"
+#include "treestats.h"
+#include <istream>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * A node of IndexedRedBlackTree. NIL marks a missing child or parent.
+ */
+template<typename K, typename V>
+struct IndexedNode {
+	static const uint32_t NIL = UINT32_MAX;
+
+	K key;
+	V value;
+	uint32_t left, right, parent;
+	unsigned char color;
+
+	IndexedNode(const K &k, const V &v, uint32_t p) :
+			key(k), value(v), left(NIL), right(NIL), parent(p), color(RED) {
+	}
+};
+
+template<typename K, typename V>
+class IndexedRedBlackTree;
+
+template<typename K, typename V>
+class IndexedTreeIterator {
+public:
+	/**
+	 * Result of operator->: references to the key and value in their node,
+	 * so that it->second = v writes through, as with RedBlackTree::iterator.
+	 */
+	class pair_proxy {
+	public:
+		const std::pair<const K&, V&>* operator->() const {
+			return &pair_;
+		}
+
+	private:
+		std::pair<const K&, V&> pair_;
+
+		pair_proxy(const K &key, V &value) :
+				pair_(key, value) {
+		}
+
+		friend class IndexedTreeIterator;
+	};
+
+	IndexedTreeIterator() :
+			index_(IndexedNode<K, V>::NIL), tree_(NULL) {
+	}
+
+	bool operator==(const IndexedTreeIterator &rhs) const {
+		return index_ == rhs.index_;
+	}
+
+	bool operator!=(const IndexedTreeIterator &rhs) const {
+		return index_ != rhs.index_;
+	}
+
+	std::pair<K, V> operator*() const {
+		return std::pair<K, V>(key(), value());
+	}
+
+	pair_proxy operator->() const {
+		return pair_proxy(key(), value());
+	}
+
+	const K& key() const {
+		return tree_->nodes_[index_].key;
+	}
+
+	V& value() const {
+		return tree_->nodes_[index_].value;
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key.
+	 */
+	IndexedTreeIterator& operator++() {
+		if (index_ == IndexedNode<K, V>::NIL) {
+			// ++ from end(). Move to the first node in order.
+			if (tree_->root_ == IndexedNode<K, V>::NIL)
+				throw tree_exception(
+						"IndexedTreeIterator operator++(): tree empty");
+			index_ = tree_->minimum(tree_->root_);
+		} else {
+			index_ = tree_->successor(index_);
+		}
+		return *this;
+	}
+
+	IndexedTreeIterator operator++(int) {
+		IndexedTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	// Positions are indices, so iterators stay valid when the node vector
+	// grows and reallocates.
+	uint32_t index_;
+	IndexedRedBlackTree<K, V> *tree_;
+	friend class IndexedRedBlackTree<K, V> ;
+
+	IndexedTreeIterator(uint32_t index, IndexedRedBlackTree<K, V> *t) :
+			index_(index), tree_(t) {
+	}
+};
+
+/**
+ * Red-black tree with the insert, find, iterator and statistics interface of
+ * RedBlackTree. Node i is nodes()[i]; nodes are never moved once inserted,
+ * so an index names the same key for the life of the tree.
+ */
+template<typename K, typename V>
+class IndexedRedBlackTree: public Tree {
+	typedef IndexedNode<K, V> node_type;
+	static const uint32_t NIL = node_type::NIL;
+
+	/**
+	 * Accessor for treestats.h.
+	 */
+	struct Access {
+		typedef uint32_t node;
+		const std::vector<node_type> *nodes;
+
+		bool is_null(node n) const {
+			return n == NIL;
+		}
+
+		node left(node n) const {
+			return (*nodes)[n].left;
+		}
+
+		node right(node n) const {
+			return (*nodes)[n].right;
+		}
+
+		const K& key(node n) const {
+			return (*nodes)[n].key;
+		}
+
+		const V& value(node n) const {
+			return (*nodes)[n].value;
+		}
+	};
+
+public:
+	typedef IndexedTreeIterator<K, V> iterator;
+
+	IndexedRedBlackTree() :
+			root_(NIL) {
+	}
+
+	IndexedRedBlackTree(std::vector<std::pair<K, V> > &elements) :
+			root_(NIL) {
+		insert_elements(elements);
+	}
+
+	/**
+	 * Makes room for n nodes so that the next inserts do not reallocate.
+	 */
+	void reserve(size_t n) {
+		nodes_.reserve(n);
+	}
+
+	/**
+	 * Inserts elements from the vector. Duplicate keys are not inserted.
+	 */
+	void insert_elements(std::vector<std::pair<K, V> > &elements) {
+		for (size_t i = 0, len = elements.size(); i < len; ++i) {
+			try {
+				insert(elements[i].first, elements[i].second);
+			} catch (const tree_exception &te) {
+				std::cerr << "Warning: " << te.what() << std::endl;
+			}
+		}
+	}
+
+	/**
+	 * Inserts a key-value pair. Throws a tree_exception on a duplicate key.
+	 */
+	void insert(const K &key, const V &value) {
+		uint32_t x = root_, y = NIL;
+		bool go_left = false;
+		while (x != NIL) {
+			y = x;
+			const K &k = nodes_[x].key;
+			if (key < k) {
+				go_left = true;
+				x = nodes_[x].left;
+			} else if (k < key) {
+				go_left = false;
+				x = nodes_[x].right;
+			} else {
+				std::ostringstream oss;
+				oss << "Attempt to insert duplicate key '" << key << "'.";
+				throw tree_exception(oss.str());
+			}
+		}
+		if (nodes_.size() >= NIL)
+			throw tree_exception("IndexedRedBlackTree: too many nodes.");
+		uint32_t z = static_cast<uint32_t>(nodes_.size());
+		nodes_.push_back(node_type(key, value, y));
+		if (y == NIL)
+			root_ = z;
+		else if (go_left)
+			nodes_[y].left = z;
+		else
+			nodes_[y].right = z;
+		insert_fixup(z);
+	}
+
+	iterator find(const K &key) {
+		uint32_t x = root_;
+		while (x != NIL) {
+			const K &k = nodes_[x].key;
+			if (key < k)
+				x = nodes_[x].left;
+			else if (k < key)
+				x = nodes_[x].right;
+			else
+				break; // Found!
+		}
+		return iterator(x, this);
+	}
+
+	iterator begin() {
+		return iterator(root_ == NIL ? NIL : minimum(root_), this);
+	}
+
+	iterator end() {
+		return iterator(NIL, this);
+	}
+
+	/**
+	 * Returns the node array. Children and parents are indices into it.
+	 */
+	const std::vector<node_type>& nodes() const {
+		return nodes_;
+	}
+
+	uint32_t root() const {
+		return root_;
+	}
+
+	/**
+	 * Writes the tree as its root index followed by the raw node array.
+	 * Requires trivially copyable keys and values; the bytes can be read
+	 * back with read() on a machine with the same layout.
+	 */
+	void write(std::ostream &out) const {
+		static_assert(std::is_trivially_copyable<node_type>::value,
+				"IndexedRedBlackTree::write needs trivially copyable K and V");
+		uint64_t count = nodes_.size();
+		out.write(reinterpret_cast<const char*>(&root_), sizeof(root_));
+		out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		if (count != 0)
+			out.write(reinterpret_cast<const char*>(&nodes_[0]),
+					count * sizeof(node_type));
+	}
+
+	/**
+	 * Replaces the contents with a tree produced by write(). Throws a
+	 * tree_exception, leaving the tree as it was, if the stream ends early
+	 * or any link points outside the node array or disagrees with the link
+	 * back. Nodes are read a chunk at a time, so a corrupt count runs into
+	 * the end of the stream before much memory is allocated.
+	 */
+	void read(std::istream &in) {
+		static_assert(std::is_trivially_copyable<node_type>::value,
+				"IndexedRedBlackTree::read needs trivially copyable K and V");
+		uint32_t root;
+		uint64_t count;
+		in.read(reinterpret_cast<char*>(&root), sizeof(root));
+		in.read(reinterpret_cast<char*>(&count), sizeof(count));
+		if (!in || count >= NIL || (count == 0) != (root == NIL)
+				|| (count != 0 && root >= count))
+			throw tree_exception("IndexedRedBlackTree: bad header.");
+		std::vector<node_type> nodes;
+		for (size_t done = 0; done < count;) {
+			size_t chunk = count - done < READ_CHUNK ?
+					count - done : READ_CHUNK;
+			nodes.resize(done + chunk, node_type(K(), V(), NIL));
+			in.read(reinterpret_cast<char*>(&nodes[done]),
+					chunk * sizeof(node_type));
+			if (!in)
+				throw tree_exception("IndexedRedBlackTree: truncated input.");
+			done += chunk;
+		}
+		for (uint32_t i = 0; i < count; ++i) {
+			if (!valid_links(nodes, i, root)) {
+				std::ostringstream oss;
+				oss << "IndexedRedBlackTree: bad link at node " << i << ".";
+				throw tree_exception(oss.str());
+			}
+		}
+		nodes_.swap(nodes);
+		root_ = root;
+	}
+
+	std::string to_ascii_drawing() {
+		return tree_ascii_drawing<K, V>(access(), root_);
+	}
+
+	int height() const {
+		return tree_height(access(), root_) - 1;
+	}
+
+	size_t size() const {
+		return nodes_.size();
+	}
+
+	size_t leaf_count() const {
+		return tree_leaf_count(access(), root_);
+	}
+
+	size_t internal_node_count() const {
+		return tree_internal_node_count(access(), root_);
+	}
+
+	size_t diameter() const {
+		return tree_diameter(access(), root_);
+	}
+
+	size_t max_width() const {
+		return tree_max_width(access(), root_);
+	}
+
+	double successful_search_cost() const {
+		return tree_successful_search_cost(access(), root_, size());
+	}
+
+	double unsuccessful_search_cost() const {
+		return tree_unsuccessful_search_cost(access(), root_, size());
+	}
+
+private:
+	// Nodes read() reads at a time.
+	static const size_t READ_CHUNK = 1 << 16;
+
+	std::vector<node_type> nodes_;
+	uint32_t root_;
+	friend class IndexedTreeIterator<K, V> ;
+
+	/**
+	 * Checks that node i of nodes links only to nodes in the array, that
+	 * its parent has it as a child and its children have it as parent, and
+	 * that only root has no parent.
+	 */
+	static bool valid_links(const std::vector<node_type> &nodes, uint32_t i,
+			uint32_t root) {
+		uint32_t count = static_cast<uint32_t>(nodes.size());
+		const node_type &n = nodes[i];
+		if ((n.parent == NIL) != (i == root))
+			return false;
+		if (n.parent != NIL && (n.parent >= count
+				|| (nodes[n.parent].left != i && nodes[n.parent].right != i)))
+			return false;
+		if (n.left != NIL && (n.left >= count || nodes[n.left].parent != i))
+			return false;
+		if (n.right != NIL && (n.right >= count || n.right == n.left
+				|| nodes[n.right].parent != i))
+			return false;
+		return true;
+	}
+
+	Access access() const {
+		Access a;
+		a.nodes = &nodes_;
+		return a;
+	}
+
+	inline unsigned char color_of(uint32_t x) const {
+		return x == NIL ? BLACK : nodes_[x].color;
+	}
+
+	uint32_t minimum(uint32_t x) const {
+		while (nodes_[x].left != NIL)
+			x = nodes_[x].left;
+		return x;
+	}
+
+	uint32_t successor(uint32_t x) const {
+		if (nodes_[x].right != NIL)
+			return minimum(nodes_[x].right);
+		uint32_t y = nodes_[x].parent;
+		while (y != NIL && x == nodes_[y].right) {
+			x = y;
+			y = nodes_[y].parent;
+		}
+		return y;
+	}
+
+	/**
+	 * Implementation of insert fixup method described on p. 316 of CLRS.
+	 */
+	void insert_fixup(uint32_t z) {
+		while (color_of(nodes_[z].parent) == RED) {
+			uint32_t p = nodes_[z].parent, g = nodes_[p].parent;
+			if (p == nodes_[g].left) {
+				uint32_t u = nodes_[g].right;
+				if (color_of(u) == RED) {
+					nodes_[p].color = nodes_[u].color = BLACK;
+					nodes_[g].color = RED;
+					z = g;
+				} else {
+					if (z == nodes_[p].right) {
+						z = p;
+						left_rotate(z);
+						p = nodes_[z].parent;
+					}
+					nodes_[p].color = BLACK;
+					nodes_[g].color = RED;
+					right_rotate(g);
+				}
+			} else {
+				uint32_t u = nodes_[g].left;
+				if (color_of(u) == RED) {
+					nodes_[p].color = nodes_[u].color = BLACK;
+					nodes_[g].color = RED;
+					z = g;
+				} else {
+					if (z == nodes_[p].left) {
+						z = p;
+						right_rotate(z);
+						p = nodes_[z].parent;
+					}
+					nodes_[p].color = BLACK;
+					nodes_[g].color = RED;
+					left_rotate(g);
+				}
+			}
+		}
+		nodes_[root_].color = BLACK;
+	}
+
+	/**
+	 * Implementation of left-rotate method as described on p. 313 of CLRS.
+	 */
+	void left_rotate(uint32_t x) {
+		uint32_t y = nodes_[x].right;
+		nodes_[x].right = nodes_[y].left;
+		if (nodes_[y].left != NIL)
+			nodes_[nodes_[y].left].parent = x;
+		replace_child(nodes_[x].parent, x, y);
+		nodes_[y].left = x;
+		nodes_[x].parent = y;
+	}
+
+	/**
+	 * Implementation of right-rotate method as described on p. 313 of CLRS.
+	 */
+	void right_rotate(uint32_t x) {
+		uint32_t y = nodes_[x].left;
+		nodes_[x].left = nodes_[y].right;
+		if (nodes_[y].right != NIL)
+			nodes_[nodes_[y].right].parent = x;
+		replace_child(nodes_[x].parent, x, y);
+		nodes_[y].right = x;
+		nodes_[x].parent = y;
+	}
+
+	/**
+	 * Makes y the child of p in place of x, or the root if p is NIL.
+	 */
+	void replace_child(uint32_t p, uint32_t x, uint32_t y) {
+		nodes_[y].parent = p;
+		if (p == NIL)
+			root_ = y;
+		else if (x == nodes_[p].left)
+			nodes_[p].left = y;
+		else
+			nodes_[p].right = y;
+	}
+};
+
+#endif /* INDEXTREE_H_ */
@@ -0,0 +1,203 @@
+/*******************************************************************************
+ * Name        : instrumentation.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Operation counters and latency histograms for the red-black
+ *               tree. They are only collected when the tree is compiled with
+ *               -DRBTREE_INSTRUMENT; otherwise the hooks expand to nothing.
+ ******************************************************************************/
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <chrono>
+#include <cstdlib>
+#include <stdint.h>
+
+/**
+ * Histogram of latencies in nanoseconds. Values below 2^SUB_BITS get a bucket
+ * each; above that every power of two is split into 2^SUB_BITS buckets, so a
+ * reported percentile is within 12.5% of the true value.
+ */
+class LatencyHistogram {
+public:
+	LatencyHistogram() {
+		reset();
+	}
+
+	void record(uint64_t ns) {
+		++buckets_[bucket_of(ns)];
+		++count_;
+		total_ += ns;
+		if (ns > max_)
+			max_ = ns;
+	}
+
+	void reset() {
+		for (size_t i = 0; i < BUCKETS; ++i)
+			buckets_[i] = 0;
+		count_ = total_ = max_ = 0;
+	}
+
+	uint64_t count() const {
+		return count_;
+	}
+
+	uint64_t max() const {
+		return max_;
+	}
+
+	double mean() const {
+		return count_ == 0 ? 0 : (double) total_ / count_;
+	}
+
+	/**
+	 * Returns an upper bound on the latency below which the fraction p of
+	 * the recorded operations fall, e.g. percentile(0.999) for p999.
+	 */
+	uint64_t percentile(double p) const {
+		if (count_ == 0)
+			return 0;
+		uint64_t rank = static_cast<uint64_t>(p * count_);
+		if (rank >= count_)
+			rank = count_ - 1;
+		uint64_t seen = 0;
+		for (size_t i = 0; i < BUCKETS; ++i) {
+			seen += buckets_[i];
+			if (seen > rank) {
+				uint64_t upper = upper_bound_of(i);
+				return upper < max_ ? upper : max_;
+			}
+		}
+		return max_;
+	}
+
+	uint64_t p50() const {
+		return percentile(0.50);
+	}
+
+	uint64_t p99() const {
+		return percentile(0.99);
+	}
+
+	uint64_t p999() const {
+		return percentile(0.999);
+	}
+
+private:
+	static const unsigned SUB_BITS = 3;
+	static const size_t SUB_BUCKETS = 1 << SUB_BITS;
+	static const size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+	uint64_t buckets_[BUCKETS];
+	uint64_t count_, total_, max_;
+
+	static size_t bucket_of(uint64_t ns) {
+		if (ns < SUB_BUCKETS)
+			return static_cast<size_t>(ns);
+		unsigned exponent = 63;
+		while (!(ns >> exponent))
+			--exponent;
+		unsigned shift = exponent - SUB_BITS;
+		return (shift + 1) * SUB_BUCKETS
+				+ static_cast<size_t>((ns >> shift) & (SUB_BUCKETS - 1));
+	}
+
+	static uint64_t upper_bound_of(size_t bucket) {
+		if (bucket < SUB_BUCKETS)
+			return bucket;
+		unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKETS) - 1;
+		uint64_t mantissa = SUB_BUCKETS + bucket % SUB_BUCKETS;
+		return ((mantissa + 1) << shift) - 1;
+	}
+};
+
+/**
+ * Event counts for one tree. A descent is one root-to-leaf walk made by find,
+ * insert or erase; its depth is the number of nodes it visited.
+ */
+struct TreeCounters {
+	uint64_t comparisons;
+	uint64_t descents;
+	uint64_t descent_depth_total;
+	uint64_t descent_depth_max;
+	uint64_t rotations;
+	uint64_t recolorings;
+	uint64_t allocations;
+	uint64_t deallocations;
+
+	TreeCounters() :
+			comparisons(0), descents(0), descent_depth_total(0),
+			descent_depth_max(0), rotations(0), recolorings(0),
+			allocations(0), deallocations(0) {
+	}
+
+	double mean_descent_depth() const {
+		return descents == 0 ? 0 : (double) descent_depth_total / descents;
+	}
+
+	inline void record_descent(uint64_t depth) {
+		++descents;
+		descent_depth_total += depth;
+		if (depth > descent_depth_max)
+			descent_depth_max = depth;
+	}
+};
+
+/**
+ * Snapshot of everything recorded for one tree.
+ */
+struct TreeMetrics {
+	TreeCounters counters;
+	LatencyHistogram insert_latency;
+	LatencyHistogram find_latency;
+	LatencyHistogram erase_latency;
+	size_t pool_capacity_bytes;
+
+	TreeMetrics() :
+			pool_capacity_bytes(0) {
+	}
+
+	void reset() {
+		counters = TreeCounters();
+		insert_latency.reset();
+		find_latency.reset();
+		erase_latency.reset();
+	}
+};
+
+/**
+ * Records the lifetime of the enclosing scope into a histogram.
+ */
+class ScopedLatency {
+public:
+	explicit ScopedLatency(LatencyHistogram &histogram) :
+			histogram_(histogram), start_(std::chrono::steady_clock::now()) {
+	}
+
+	~ScopedLatency() {
+		histogram_.record(static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(
+						std::chrono::steady_clock::now() - start_).count()));
+	}
+
+private:
+	LatencyHistogram &histogram_;
+	std::chrono::steady_clock::time_point start_;
+
+	ScopedLatency(const ScopedLatency &);
+	ScopedLatency& operator=(const ScopedLatency &);
+};
+
+#ifdef RBTREE_INSTRUMENT
+#define RBTREE_COUNT(field, n) (metrics_.counters.field += (n))
+#define RBTREE_DESCENT(depth) (metrics_.counters.record_descent(depth))
+#define RBTREE_TIME(histogram) \
+	ScopedLatency rbtree_latency_(metrics_.histogram)
+#else
+#define RBTREE_COUNT(field, n) ((void) 0)
+#define RBTREE_DESCENT(depth) ((void) 0)
+#define RBTREE_TIME(histogram) ((void) 0)
+#endif
+
+#endif /* INSTRUMENTATION_H_ */
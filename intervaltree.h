@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * Name        : intervaltree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Interval tree as described in section 14.3 of CLRS. A
+ *               red-black tree keyed on the low endpoint whose nodes also
+ *               store the largest high endpoint in their subtree.
+ ******************************************************************************/
+#ifndef INTERVALTREE_H_
+#define INTERVALTREE_H_
+
+#include "intrusivetree.h"
+#include "rbtree.h"
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+template<typename K, typename V>
+class IntervalTree;
+
+/**
+ * Node of an interval tree holding the closed interval [low, high].
+ */
+template<typename K, typename V>
+class IntervalNode {
+public:
+	IntervalNode(const K &low, const K &high, const V &value) :
+			interval_(low, high), max_high_(high), value_(value) {
+	}
+
+	inline const K& low() const {
+		return interval_.first;
+	}
+
+	inline const K& high() const {
+		return interval_.second;
+	}
+
+	/**
+	 * Returns the largest high endpoint in the subtree rooted at this node.
+	 */
+	inline const K& max_high() const {
+		return max_high_;
+	}
+
+	inline const std::pair<K, K>& interval() const {
+		return interval_;
+	}
+
+	inline V& value() {
+		return value_;
+	}
+
+	inline const V& value() const {
+		return value_;
+	}
+
+	/**
+	 * Returns true if [low, high] and [lo, hi] share at least one point.
+	 */
+	inline bool overlaps(const K &lo, const K &hi) const {
+		return !(hi < interval_.first) && !(interval_.second < lo);
+	}
+
+private:
+	std::pair<K, K> interval_;
+	K max_high_;
+	V value_;
+	RedBlackHook<IntervalNode> hook_;
+
+	friend class IntervalTree<K, V> ;
+};
+
+template<typename K, typename V>
+class IntervalTree {
+	struct IntervalOf {
+		const std::pair<K, K>& operator()(const IntervalNode<K, V> &n) const {
+			return n.interval_;
+		}
+	};
+
+	/**
+	 * Keeps max_high_ equal to the largest high endpoint in the subtree.
+	 * Called by the intrusive tree after every rotation and along the path
+	 * touched by insert and erase.
+	 */
+	struct MaxHigh {
+		void operator()(IntervalNode<K, V> *x, const IntervalNode<K, V> *l,
+				const IntervalNode<K, V> *r) const {
+			x->max_high_ = x->interval_.second;
+			if (l != NULL && x->max_high_ < l->max_high_)
+				x->max_high_ = l->max_high_;
+			if (r != NULL && x->max_high_ < r->max_high_)
+				x->max_high_ = r->max_high_;
+		}
+	};
+
+	typedef IntrusiveRedBlackTree<IntervalNode<K, V>, std::pair<K, K>,
+			&IntervalNode<K, V>::hook_, IntervalOf, std::less<std::pair<K, K> >,
+			MaxHigh> tree_type;
+
+public:
+	typedef IntervalNode<K, V> node_type;
+	typedef typename tree_type::iterator iterator;
+
+	IntervalTree() {
+	}
+
+	~IntervalTree() {
+		tree_.clear_and_dispose(Deleter());
+	}
+
+	/**
+	 * Inserts the closed interval [low, high] with its value. Throws a
+	 * tree_exception if low > high or the same interval is already present.
+	 */
+	void insert(const K &low, const K &high, const V &value) {
+		if (high < low) {
+			std::stringstream ss;
+			ss << "[" << low << ", " << high << "]";
+			throw tree_exception("Invalid interval " + ss.str() + ".");
+		}
+		node_type *n = new node_type(low, high, value);
+		if (!tree_.insert(n)) {
+			delete n;
+			std::stringstream ss;
+			ss << "[" << low << ", " << high << "]";
+			throw tree_exception(
+					"Attempt to insert duplicate interval " + ss.str() + ".");
+		}
+	}
+
+	/**
+	 * Removes the interval [low, high]. Returns false if it is not present.
+	 */
+	bool erase(const K &low, const K &high) {
+		node_type *n = tree_.erase(std::make_pair(low, high));
+		delete n;
+		return n != NULL;
+	}
+
+	/**
+	 * Returns an iterator to the interval [low, high], or end().
+	 */
+	iterator find(const K &low, const K &high) {
+		return iterator(tree_.find(std::make_pair(low, high)), &tree_);
+	}
+
+	/**
+	 * Returns some interval overlapping [lo, hi], or NULL if none does.
+	 * This is INTERVAL-SEARCH from p. 352 of CLRS and runs in O(log n).
+	 */
+	const node_type* find_any_overlapping(const K &lo, const K &hi) const {
+		const node_type *x = tree_.root();
+		while (x != NULL && !x->overlaps(lo, hi)) {
+			const node_type *l = tree_type::left(x);
+			if (l != NULL && !(l->max_high_ < lo))
+				x = l;
+			else
+				x = tree_type::right(x);
+		}
+		return x;
+	}
+
+	/**
+	 * Calls fn(node) for every interval overlapping [lo, hi], in order of
+	 * low endpoint. Subtrees whose max_high is below lo, and right subtrees
+	 * of nodes starting after hi, are never entered, so a query reporting
+	 * k intervals visits O(log n + k log(n / k)) nodes.
+	 */
+	template<typename Function>
+	void for_each_overlapping(const K &lo, const K &hi, Function fn) const {
+		for_each_overlapping(tree_.root(), lo, hi, fn);
+	}
+
+	/**
+	 * Returns every interval overlapping [lo, hi] with its value.
+	 */
+	std::vector<std::pair<std::pair<K, K>, V> > overlapping(const K &lo,
+			const K &hi) const {
+		std::vector<std::pair<std::pair<K, K>, V> > result;
+		Collector collect(result);
+		for_each_overlapping(tree_.root(), lo, hi, collect);
+		return result;
+	}
+
+	size_t size() const {
+		return tree_.size();
+	}
+
+	bool empty() const {
+		return tree_.empty();
+	}
+
+	iterator begin() const {
+		return tree_.begin();
+	}
+
+	iterator end() const {
+		return tree_.end();
+	}
+
+private:
+	tree_type tree_;
+
+	// Owns its nodes; not copyable.
+	IntervalTree(const IntervalTree &);
+	IntervalTree& operator=(const IntervalTree &);
+
+	struct Deleter {
+		void operator()(node_type *n) const {
+			delete n;
+		}
+	};
+
+	struct Collector {
+		std::vector<std::pair<std::pair<K, K>, V> > &out;
+
+		Collector(std::vector<std::pair<std::pair<K, K>, V> > &o) :
+				out(o) {
+		}
+
+		void operator()(const node_type &n) const {
+			out.push_back(std::make_pair(n.interval(), n.value()));
+		}
+	};
+
+	template<typename Function>
+	void for_each_overlapping(const node_type *x, const K &lo, const K &hi,
+			Function &fn) const {
+		if (x == NULL || x->max_high_ < lo)
+			return;
+		for_each_overlapping(tree_type::left(x), lo, hi, fn);
+		if (hi < x->low())
+			return; // Everything to the right starts even later.
+		if (!(x->high() < lo))
+			fn(*x);
+		for_each_overlapping(tree_type::right(x), lo, hi, fn);
+	}
+};
+
+#endif /* INTERVALTREE_H_ */
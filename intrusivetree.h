@@ -0,0 +1,727 @@
+/*******************************************************************************
+ * Name        : intrusivetree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Intrusive red-black tree. The links live in a RedBlackHook
+ *               embedded in the caller's own objects, so insert and erase
+ *               never allocate, and an object with several hooks can sit in
+ *               several trees at once.
+ ******************************************************************************/
+#ifndef INTRUSIVETREE_H_
+#define INTRUSIVETREE_H_
+
+#include "node.h"
+#include <cstdlib>
+#include <cstddef>
+#include <functional>
+#include <stdint.h>
+
+template<typename T>
+class RedBlackHook;
+
+template<typename T, typename K, RedBlackHook<T> T::*Hook, typename KeyOf,
+		typename Compare, typename Augment>
+class IntrusiveRedBlackTree;
+
+/**
+ * Links for one tree, embedded in the user's struct. The color is kept in the
+ * low bit of the parent pointer, so a hook costs three words. A hook that is
+ * not in any tree has the UNLINKED bit set.
+ *
+ * Example:
+ *   struct Order {
+ *       int id, time;
+ *       RedBlackHook<Order> by_id, by_time;
+ *   };
+ */
+template<typename T>
+class RedBlackHook {
+public:
+	RedBlackHook() :
+			left_(NULL), right_(NULL), parent_color_(UNLINKED) {
+	}
+
+	/**
+	 * Copying an object never copies its tree membership.
+	 */
+	RedBlackHook(const RedBlackHook &) :
+			left_(NULL), right_(NULL), parent_color_(UNLINKED) {
+	}
+
+	RedBlackHook& operator=(const RedBlackHook &) {
+		return *this;
+	}
+
+	inline bool is_linked() const {
+		return parent_color_ != UNLINKED;
+	}
+
+	inline T* left() const {
+		return left_;
+	}
+
+	inline T* right() const {
+		return right_;
+	}
+
+	inline T* parent() const {
+		return reinterpret_cast<T*>(parent_color_ & ~COLOR_MASK);
+	}
+
+	inline unsigned char color() const {
+		return static_cast<unsigned char>(parent_color_ & BLACK);
+	}
+
+private:
+	static const uintptr_t UNLINKED = 2;
+	static const uintptr_t COLOR_MASK = 3;
+
+	T *left_, *right_;
+	uintptr_t parent_color_;
+
+	template<typename U, typename, RedBlackHook<U> U::*, typename, typename,
+			typename>
+	friend class IntrusiveRedBlackTree;
+};
+
+/**
+ * Default key extractor: the object is its own key.
+ */
+template<typename T>
+struct IdentityKey {
+	const T& operator()(const T &obj) const {
+		return obj;
+	}
+};
+
+/**
+ * Default augmentation: none. An augmentation policy is called as
+ * augment(node, left, right) whenever the children of node change, and must
+ * recompute whatever node summarizes about its subtree from its own data and
+ * the (possibly NULL) children.
+ */
+struct NoAugment {
+	template<typename T>
+	void operator()(T *, const T *, const T *) const {
+	}
+};
+
+/**
+ * Iterator over an intrusive tree. Dereferences to the caller's object.
+ */
+template<typename Tree, typename T>
+class IntrusiveTreeIterator {
+public:
+	IntrusiveTreeIterator() :
+			obj_(NULL), tree_(NULL) {
+	}
+
+	IntrusiveTreeIterator(T *obj, const Tree *tree) :
+			obj_(obj), tree_(tree) {
+	}
+
+	bool operator==(const IntrusiveTreeIterator &rhs) const {
+		return obj_ == rhs.obj_;
+	}
+
+	bool operator!=(const IntrusiveTreeIterator &rhs) const {
+		return obj_ != rhs.obj_;
+	}
+
+	T& operator*() const {
+		return *obj_;
+	}
+
+	T* operator->() const {
+		return obj_;
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key.
+	 */
+	IntrusiveTreeIterator& operator++() {
+		obj_ = obj_ == NULL ? tree_->first() : tree_->next(obj_);
+		return *this;
+	}
+
+	IntrusiveTreeIterator operator++(int) {
+		IntrusiveTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+	/**
+	 * Predecrement operator. Moving back from end() yields the last object.
+	 */
+	IntrusiveTreeIterator& operator--() {
+		obj_ = obj_ == NULL ? tree_->last() : tree_->prev(obj_);
+		return *this;
+	}
+
+	IntrusiveTreeIterator operator--(int) {
+		IntrusiveTreeIterator tmp(*this);
+		operator--();
+		return tmp;
+	}
+
+private:
+	T *obj_;
+	const Tree *tree_;
+};
+
+/**
+ * Intrusive red-black tree of caller-owned T objects, linked through the hook
+ * member selected by Hook and ordered by Compare on the key returned by
+ * KeyOf. The tree never allocates or frees; the caller must keep each object
+ * alive (and its key unchanged) while it is linked.
+ *
+ * Example:
+ *   struct ById { int operator()(const Order &o) const { return o.id; } };
+ *   IntrusiveRedBlackTree<Order, int, &Order::by_id, ById> orders_by_id;
+ */
+template<typename T, typename K, RedBlackHook<T> T::*Hook,
+		typename KeyOf = IdentityKey<T>, typename Compare = std::less<K>,
+		typename Augment = NoAugment>
+class IntrusiveRedBlackTree {
+public:
+	typedef RedBlackHook<T> hook_type;
+	typedef IntrusiveTreeIterator<IntrusiveRedBlackTree, T> iterator;
+
+	IntrusiveRedBlackTree(const KeyOf &key_of = KeyOf(),
+			const Compare &comp = Compare(),
+			const Augment &augment = Augment()) :
+			root_(NULL), size_(0), key_of_(key_of), comp_(comp),
+			augment_(augment) {
+	}
+
+	/**
+	 * Unlinks every object so that their hooks can be reused.
+	 */
+	~IntrusiveRedBlackTree() {
+		clear();
+	}
+
+	/**
+	 * Returns the number of objects linked into the tree.
+	 */
+	size_t size() const {
+		return size_;
+	}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	/**
+	 * Returns the root object, or NULL if the tree is empty.
+	 */
+	T* root() const {
+		return root_;
+	}
+
+	static T* left(const T *x) {
+		return hook(x).left_;
+	}
+
+	static T* right(const T *x) {
+		return hook(x).right_;
+	}
+
+	static T* parent(const T *x) {
+		return hook(x).parent();
+	}
+
+	static unsigned char color(const T *x) {
+		return hook(x).color();
+	}
+
+	/**
+	 * Returns the smallest object in the tree, or NULL.
+	 */
+	T* first() const {
+		return root_ == NULL ? NULL : minimum(root_);
+	}
+
+	/**
+	 * Returns the largest object in the tree, or NULL.
+	 */
+	T* last() const {
+		return root_ == NULL ? NULL : maximum(root_);
+	}
+
+	/**
+	 * Returns the inorder successor of x, or NULL if x is the last object.
+	 */
+	T* next(const T *x) const {
+		if (right(x) != NULL)
+			return minimum(right(x));
+		T *p = parent(x);
+		while (p != NULL && x == right(p)) {
+			x = p;
+			p = parent(p);
+		}
+		return p;
+	}
+
+	/**
+	 * Returns the inorder predecessor of x, or NULL if x is the first object.
+	 */
+	T* prev(const T *x) const {
+		if (left(x) != NULL)
+			return maximum(left(x));
+		T *p = parent(x);
+		while (p != NULL && x == left(p)) {
+			x = p;
+			p = parent(p);
+		}
+		return p;
+	}
+
+	/**
+	 * Returns the object with the given key, or NULL if there is none.
+	 */
+	T* find(const K &key) const {
+		T *x = root_;
+		while (x != NULL) {
+			if (comp_(key, key_of_(*x))) {
+				x = left(x);
+			} else if (comp_(key_of_(*x), key)) {
+				x = right(x);
+			} else {
+				break; // Found!
+			}
+		}
+		return x;
+	}
+
+	/**
+	 * Returns the first object whose key is not less than key, or NULL.
+	 */
+	T* lower_bound(const K &key) const {
+		T *x = root_, *result = NULL;
+		while (x != NULL) {
+			if (comp_(key_of_(*x), key)) {
+				x = right(x);
+			} else {
+				result = x;
+				x = left(x);
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * Returns the first object whose key is greater than key, or NULL.
+	 */
+	T* upper_bound(const K &key) const {
+		T *x = root_, *result = NULL;
+		while (x != NULL) {
+			if (comp_(key, key_of_(*x))) {
+				result = x;
+				x = left(x);
+			} else {
+				x = right(x);
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * Links obj into the tree. Returns false, leaving obj unlinked, if an
+	 * object with an equal key is already present. obj must not already be
+	 * linked through this hook.
+	 */
+	bool insert(T &obj) {
+		return insert(&obj);
+	}
+
+	bool insert(T *obj) {
+		T *x = root_, *y = NULL;
+		bool go_left = false;
+		while (x != NULL) {
+			y = x;
+			if (comp_(key_of_(*obj), key_of_(*x))) {
+				go_left = true;
+				x = left(x);
+			} else if (comp_(key_of_(*x), key_of_(*obj))) {
+				go_left = false;
+				x = right(x);
+			} else {
+				return false;
+			}
+		}
+		link_leaf(obj, y, go_left);
+		return true;
+	}
+
+	/**
+	 * Unlinks the object with the given key. Returns it, or NULL if absent.
+	 */
+	T* erase(const K &key) {
+		T *obj = find(key);
+		if (obj != NULL)
+			erase(obj);
+		return obj;
+	}
+
+	/**
+	 * Unlinks obj, which must be linked into this tree. obj itself is not
+	 * touched apart from its hook.
+	 */
+	void erase(T &obj) {
+		erase(&obj);
+	}
+
+	void erase(T *z) {
+		T *y = z, *x, *x_parent;
+		unsigned char y_original_color = color(y);
+		if (left(z) == NULL) {
+			x = right(z);
+			x_parent = parent(z);
+			transplant(z, x);
+		} else if (right(z) == NULL) {
+			x = left(z);
+			x_parent = parent(z);
+			transplant(z, x);
+		} else {
+			y = minimum(right(z));
+			y_original_color = color(y);
+			x = right(y);
+			if (parent(y) == z) {
+				x_parent = y;
+			} else {
+				x_parent = parent(y);
+				transplant(y, right(y));
+				set_right(y, right(z));
+				set_parent(right(y), y);
+			}
+			transplant(z, y);
+			set_left(y, left(z));
+			set_parent(left(y), y);
+			set_color(y, color(z));
+		}
+		propagate(x_parent);
+		if (y_original_color == BLACK) {
+			erase_fixup(x, x_parent);
+		}
+		unlink(z);
+		--size_;
+	}
+
+	/**
+	 * Unlinks every object without visiting them in any particular order.
+	 * Runs in O(n) and uses no extra memory.
+	 */
+	void clear() {
+		clear_and_dispose(NoDispose());
+	}
+
+	/**
+	 * Like clear(), but calls dispose(obj) on each object once it has been
+	 * unlinked, e.g. to return it to the caller's pool.
+	 */
+	template<typename Disposer>
+	void clear_and_dispose(Disposer dispose) {
+		T *x = root_;
+		while (x != NULL) {
+			if (left(x) != NULL) {
+				x = left(x);
+			} else if (right(x) != NULL) {
+				x = right(x);
+			} else {
+				T *p = parent(x);
+				if (p != NULL) {
+					if (left(p) == x)
+						hook(p).left_ = NULL;
+					else
+						hook(p).right_ = NULL;
+				}
+				unlink(x);
+				dispose(x);
+				x = p;
+			}
+		}
+		root_ = NULL;
+		size_ = 0;
+	}
+
+	/**
+	 * Links a fresh object as the left or right child of y (or as the root
+	 * when y is NULL) and restores the red-black properties.
+	 * Trees that locate the insertion point themselves use this.
+	 */
+	void link_leaf(T *z, T *y, bool as_left) {
+		hook_type &hz = hook(z);
+		hz.left_ = hz.right_ = NULL;
+		hz.parent_color_ = reinterpret_cast<uintptr_t>(y) | RED;
+		if (y == NULL)
+			root_ = z;
+		else if (as_left)
+			hook(y).left_ = z;
+		else
+			hook(y).right_ = z;
+		++size_;
+		augment_(z, static_cast<const T*>(NULL), static_cast<const T*>(NULL));
+		propagate(y);
+		insert_fixup(z);
+	}
+
+	/**
+	 * Recomputes the augmentation of x and every ancestor of x. Call it after
+	 * changing data of a linked object that the augmentation depends on.
+	 */
+	void propagate(T *x) {
+		while (x != NULL) {
+			update(x);
+			x = parent(x);
+		}
+	}
+
+	/**
+	 * Returns true if obj is currently linked through this tree's hook.
+	 */
+	static bool is_linked(const T &obj) {
+		return (obj.*Hook).is_linked();
+	}
+
+	iterator begin() const {
+		return iterator(first(), this);
+	}
+
+	iterator end() const {
+		return iterator(NULL, this);
+	}
+
+	const KeyOf& key_of() const {
+		return key_of_;
+	}
+
+	const Compare& key_comp() const {
+		return comp_;
+	}
+
+	Augment& augment() {
+		return augment_;
+	}
+
+private:
+	struct NoDispose {
+		void operator()(T *) const {
+		}
+	};
+
+	T *root_;
+	size_t size_;
+	KeyOf key_of_;
+	Compare comp_;
+	Augment augment_;
+
+	// Not copyable: the hooks of the objects belong to exactly one tree.
+	IntrusiveRedBlackTree(const IntrusiveRedBlackTree &);
+	IntrusiveRedBlackTree& operator=(const IntrusiveRedBlackTree &);
+
+	inline static hook_type& hook(const T *x) {
+		return const_cast<T*>(x)->*Hook;
+	}
+
+	inline void update(T *x) {
+		augment_(x, static_cast<const T*>(left(x)),
+				static_cast<const T*>(right(x)));
+	}
+
+	T* minimum(T *x) const {
+		while (left(x) != NULL)
+			x = left(x);
+		return x;
+	}
+
+	T* maximum(T *x) const {
+		while (right(x) != NULL)
+			x = right(x);
+		return x;
+	}
+
+	inline static bool is_red(const T *x) {
+		return x != NULL && color(x) == RED;
+	}
+
+	inline static void set_left(T *x, T *l) {
+		hook(x).left_ = l;
+	}
+
+	inline static void set_right(T *x, T *r) {
+		hook(x).right_ = r;
+	}
+
+	inline static void set_parent(T *x, T *p) {
+		if (x != NULL) {
+			hook_type &h = hook(x);
+			h.parent_color_ = reinterpret_cast<uintptr_t>(p)
+					| (h.parent_color_ & hook_type::COLOR_MASK);
+		}
+	}
+
+	inline static void set_color(T *x, unsigned char c) {
+		hook_type &h = hook(x);
+		h.parent_color_ = (h.parent_color_ & ~hook_type::COLOR_MASK) | c;
+	}
+
+	inline static void unlink(T *x) {
+		hook_type &h = hook(x);
+		h.left_ = h.right_ = NULL;
+		h.parent_color_ = hook_type::UNLINKED;
+	}
+
+	/**
+	 * Replaces the subtree rooted at u with the subtree rooted at v, as on
+	 * p. 323 of CLRS.
+	 */
+	void transplant(T *u, T *v) {
+		T *p = parent(u);
+		if (p == NULL)
+			root_ = v;
+		else if (u == left(p))
+			set_left(p, v);
+		else
+			set_right(p, v);
+		set_parent(v, p);
+	}
+
+	/**
+	 * Left-rotate as described on p. 313 of CLRS.
+	 */
+	void left_rotate(T *x) {
+		T *y = right(x);
+		set_right(x, left(y));
+		set_parent(left(y), x);
+		transplant(x, y);
+		set_left(y, x);
+		set_parent(x, y);
+		update(x);
+		update(y);
+	}
+
+	/**
+	 * Right-rotate as described on p. 313 of CLRS.
+	 */
+	void right_rotate(T *x) {
+		T *y = left(x);
+		set_left(x, right(y));
+		set_parent(right(y), x);
+		transplant(x, y);
+		set_right(y, x);
+		set_parent(x, y);
+		update(x);
+		update(y);
+	}
+
+	/**
+	 * Insert fixup as described on p. 316 of CLRS.
+	 */
+	void insert_fixup(T *z) {
+		while (is_red(parent(z))) {
+			T *p = parent(z), *g = parent(p);
+			if (p == left(g)) {
+				T *uncle = right(g);
+				if (is_red(uncle)) {
+					set_color(p, BLACK);
+					set_color(uncle, BLACK);
+					set_color(g, RED);
+					z = g;
+				} else {
+					if (z == right(p)) {
+						z = p;
+						left_rotate(z);
+						p = parent(z);
+					}
+					set_color(p, BLACK);
+					set_color(g, RED);
+					right_rotate(g);
+				}
+			} else {
+				T *uncle = left(g);
+				if (is_red(uncle)) {
+					set_color(p, BLACK);
+					set_color(uncle, BLACK);
+					set_color(g, RED);
+					z = g;
+				} else {
+					if (z == left(p)) {
+						z = p;
+						right_rotate(z);
+						p = parent(z);
+					}
+					set_color(p, BLACK);
+					set_color(g, RED);
+					left_rotate(g);
+				}
+			}
+		}
+		set_color(root_, BLACK);
+	}
+
+	/**
+	 * Delete fixup as described on p. 326 of CLRS. Without a sentinel, x may
+	 * be NULL, so its parent is passed explicitly.
+	 */
+	void erase_fixup(T *x, T *x_parent) {
+		while (x != root_ && !is_red(x)) {
+			if (x == left(x_parent)) {
+				T *w = right(x_parent);
+				if (is_red(w)) {
+					set_color(w, BLACK);
+					set_color(x_parent, RED);
+					left_rotate(x_parent);
+					w = right(x_parent);
+				}
+				if (!is_red(left(w)) && !is_red(right(w))) {
+					set_color(w, RED);
+					x = x_parent;
+					x_parent = parent(x);
+				} else {
+					if (!is_red(right(w))) {
+						set_color(left(w), BLACK);
+						set_color(w, RED);
+						right_rotate(w);
+						w = right(x_parent);
+					}
+					set_color(w, color(x_parent));
+					set_color(x_parent, BLACK);
+					set_color(right(w), BLACK);
+					left_rotate(x_parent);
+					x = root_;
+				}
+			} else {
+				T *w = left(x_parent);
+				if (is_red(w)) {
+					set_color(w, BLACK);
+					set_color(x_parent, RED);
+					right_rotate(x_parent);
+					w = left(x_parent);
+				}
+				if (!is_red(right(w)) && !is_red(left(w))) {
+					set_color(w, RED);
+					x = x_parent;
+					x_parent = parent(x);
+				} else {
+					if (!is_red(left(w))) {
+						set_color(right(w), BLACK);
+						set_color(w, RED);
+						left_rotate(w);
+						w = left(x_parent);
+					}
+					set_color(w, color(x_parent));
+					set_color(x_parent, BLACK);
+					set_color(left(w), BLACK);
+					right_rotate(x_parent);
+					x = root_;
+				}
+			}
+		}
+		if (x != NULL)
+			set_color(x, BLACK);
+	}
+};
+
+#endif /* INTRUSIVETREE_H_ */
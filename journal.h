@@ -0,0 +1,663 @@
+/*******************************************************************************
+ * Name        : journal.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Write-ahead journal of the inserts and erases applied to a
+ *               RedBlackTree, with group commit, checkpointing and replay.
+ *               Replay of a sorted log (as a checkpoint writes) goes through
+ *               RedBlackTree::bulk_load, so recovery costs about one
+ *               sequential read of the file.
+ ******************************************************************************/
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include "rbtree.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * True if journal_encode() and journal_decode() can handle T: trivially
+ * copyable types, stored as their bytes, and std::string, stored with its
+ * length.
+ */
+template<typename T>
+struct is_journalable: std::integral_constant<bool,
+		std::is_trivially_copyable<T>::value> {
+};
+
+template<>
+struct is_journalable<std::string> : std::true_type {
+};
+
+template<typename T>
+inline void journal_encode(std::string &out, const T &value, std::true_type) {
+	out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Never reached at run time: MutationJournal static_asserts
+// is_journalable on K and V.
+template<typename T>
+inline void journal_encode(std::string &, const T &, std::false_type) {
+}
+
+/**
+ * Appends the bytes of value to out.
+ */
+template<typename T>
+inline void journal_encode(std::string &out, const T &value) {
+	journal_encode(out, value,
+			std::integral_constant<bool, is_journalable<T>::value>());
+}
+
+inline void journal_encode(std::string &out, const std::string &value) {
+	uint32_t length = static_cast<uint32_t>(value.size());
+	out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+	out.append(value);
+}
+
+template<typename T>
+inline bool journal_decode(const char *&p, const char *end, T &value,
+		std::true_type) {
+	if (static_cast<size_t>(end - p) < sizeof(value))
+		return false;
+	std::memcpy(static_cast<void*>(&value), p, sizeof(value));
+	p += sizeof(value);
+	return true;
+}
+
+template<typename T>
+inline bool journal_decode(const char *&, const char *, T &,
+		std::false_type) {
+	return false;
+}
+
+/**
+ * Reads a value written by journal_encode() from [p, end), advancing p.
+ * Returns false if the bytes run out first.
+ */
+template<typename T>
+inline bool journal_decode(const char *&p, const char *end, T &value) {
+	return journal_decode(p, end, value,
+			std::integral_constant<bool, is_journalable<T>::value>());
+}
+
+inline bool journal_decode(const char *&p, const char *end,
+		std::string &value) {
+	uint32_t length;
+	if (!journal_decode(p, end, length)
+			|| static_cast<size_t>(end - p) < length)
+		return false;
+	value.assign(p, length);
+	p += length;
+	return true;
+}
+
+struct JournalStats {
+	uint64_t records;
+	uint64_t bytes;
+	uint64_t syncs;
+
+	JournalStats() :
+			records(0), bytes(0), syncs(0) {
+	}
+
+	/**
+	 * Returns the average number of records made durable per fsync.
+	 */
+	double records_per_sync() const {
+		return syncs == 0 ? 0 : (double) records / syncs;
+	}
+};
+
+struct JournalReplayStats {
+	uint64_t records;
+	uint64_t bulk_loaded;
+	uint64_t skipped;
+	bool torn_tail;
+
+	JournalReplayStats() :
+			records(0), bulk_loaded(0), skipped(0), torn_tail(false) {
+	}
+};
+
+/**
+ * An append-only log of the mutations made to a RedBlackTree<K, V>. Apply a
+ * mutation to the tree, log it with log_insert() or log_erase(), and call
+ * sync() with the sequence number returned before acknowledging it.
+ *
+ * Records are buffered in memory until a sync(). The first thread to call
+ * sync() writes and fsyncs everything buffered so far. Threads that call
+ * sync() meanwhile wait for it, and the next one to go writes all the
+ * records they logged in a single fsync. Fsyncs are the slowest part of
+ * logging, so this group commit lets throughput grow with the number of
+ * writers.
+ *
+ * Each record carries a checksum. A crash can leave the last records
+ * partly written; replay() stops at the first bad record, and the journal
+ * truncates them away when it is next opened.
+ */
+template<typename K, typename V>
+class MutationJournal {
+public:
+	/**
+	 * Opens the journal at path, creating it if it does not exist. Throws a
+	 * tree_exception if it cannot be opened or was written for another key
+	 * or value layout.
+	 */
+	explicit MutationJournal(const std::string &path) :
+			path_(path), fd_(-1), appended_(0), durable_(0), flushing_(false),
+			error_(0) {
+		static_assert(is_journalable<K>::value && is_journalable<V>::value,
+				"MutationJournal needs trivially copyable or std::string "
+				"K and V");
+		open();
+	}
+
+	~MutationJournal() {
+		try {
+			sync();
+		} catch (const tree_exception &) {
+		}
+		::close(fd_);
+	}
+
+	/**
+	 * Logs the insert of key with value and returns its sequence number.
+	 */
+	uint64_t log_insert(const K &key, const V &value) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		size_t start = begin_record(INSERT);
+		journal_encode(pending_, key);
+		journal_encode(pending_, value);
+		return end_record(start);
+	}
+
+	/**
+	 * Logs the erase of key and returns its sequence number.
+	 */
+	uint64_t log_erase(const K &key) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		size_t start = begin_record(ERASE);
+		journal_encode(pending_, key);
+		return end_record(start);
+	}
+
+	/**
+	 * Returns once the record with sequence number lsn, and every record
+	 * before it, is on disk. With no argument, waits for every record
+	 * logged so far. Throws a tree_exception if a write or fsync fails.
+	 */
+	void sync(uint64_t lsn = UINT64_MAX) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (lsn > appended_)
+			lsn = appended_;
+		while (durable_ < lsn) {
+			if (error_ != 0)
+				throw_error("write " + path_, error_);
+			if (flushing_) {
+				flushed_.wait(lock);
+				continue;
+			}
+			flushing_ = true;
+			std::string batch;
+			batch.swap(pending_);
+			uint64_t last = appended_;
+			lock.unlock();
+			int error = write_fd(fd_, batch.data(), batch.size())
+					&& ::fsync(fd_) == 0 ? 0 : errno;
+			lock.lock();
+			flushing_ = false;
+			flushed_.notify_all();
+			if (error != 0) {
+				// After a failed fsync the kernel may have dropped the
+				// pages, so no later sync can be trusted either.
+				error_ = error;
+			} else {
+				durable_ = last;
+				++stats_.syncs;
+			}
+		}
+		if (error_ != 0)
+			throw_error("write " + path_, error_);
+	}
+
+	/**
+	 * Replaces the journal with one insert per key of tree, in key order,
+	 * so that replay() can bulk load it. The new log is written and synced
+	 * under a temporary name and then renamed over the old one, so a crash
+	 * leaves one or the other. No mutation may be logged meanwhile, and any
+	 * logged but not yet applied to tree must be synced first. If the
+	 * directory cannot be synced after the rename, the journal keeps the new
+	 * log but fails every later sync().
+	 */
+	void checkpoint(RedBlackTree<K, V> &tree) {
+		sync();
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (flushing_)
+			flushed_.wait(lock);
+		std::string tmp = path_ + ".tmp";
+		int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0)
+			throw_error("create " + tmp, errno);
+		std::string chunk = header();
+		bool ok = true;
+		for (typename RedBlackTree<K, V>::iterator it = tree.begin();
+				ok && it != tree.end(); ++it) {
+			size_t start = chunk.size();
+			chunk.push_back(static_cast<char>(INSERT));
+			chunk.append(RECORD_HEADER, '\0');
+			journal_encode(chunk, it->first);
+			journal_encode(chunk, it->second);
+			seal(chunk, start);
+			if (chunk.size() >= CHUNK_BYTES) {
+				ok = write_fd(fd, chunk.data(), chunk.size());
+				chunk.clear();
+			}
+		}
+		ok = ok && write_fd(fd, chunk.data(), chunk.size())
+				&& ::fsync(fd) == 0
+				&& std::rename(tmp.c_str(), path_.c_str()) == 0;
+		if (!ok) {
+			int error = errno;
+			::close(fd);
+			std::remove(tmp.c_str());
+			throw_error("checkpoint " + path_, error);
+		}
+		// The new log is now the one at path_, whether or not the rename
+		// reaches the disk, so records must go to it from here on.
+		::close(fd_);
+		fd_ = fd;
+		pending_.clear();
+		durable_ = appended_;
+		if (!sync_directory()) {
+			// A crash could still bring back the old log, so no later sync
+			// can promise anything either.
+			error_ = errno;
+			throw_error("checkpoint " + path_, error_);
+		}
+	}
+
+	/**
+	 * Rebuilds tree from the journal at path. While the log is a run of
+	 * inserts in increasing key order and tree is empty, the pairs are
+	 * collected and bulk loaded in O(n); the rest of the log is applied one
+	 * record at a time. Inserts of keys already present and erases of keys
+	 * that are not are counted as skipped.
+	 */
+	static JournalReplayStats replay(const std::string &path,
+			RedBlackTree<K, V> &tree) {
+		static_assert(is_journalable<K>::value && is_journalable<V>::value,
+				"MutationJournal needs trivially copyable or std::string "
+				"K and V");
+		JournalReplayStats stats;
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			if (errno == ENOENT)
+				return stats;
+			throw_error("open " + path, errno);
+		}
+		Replayer replayer(tree, stats);
+		off_t valid;
+		int error = 0;
+		bool ok = scan(fd, replayer, valid, stats.torn_tail, error);
+		::close(fd);
+		if (error != 0)
+			throw_error("read " + path, error);
+		if (!ok)
+			throw tree_exception("MutationJournal: '" + path
+					+ "' has a bad header.");
+		replayer.finish();
+		return stats;
+	}
+
+	const std::string& path() const {
+		return path_;
+	}
+
+	JournalStats stats() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return stats_;
+	}
+
+private:
+	enum Op {
+		INSERT = 1, ERASE = 2
+	};
+
+	// Each record is: op (1 byte), payload length (4), checksum (4), then
+	// the payload. The checksum covers the op and the payload.
+	static const size_t RECORD_HEADER = 8;
+	static const size_t CHUNK_BYTES = 1 << 20;
+	static const uint32_t MAGIC = 0x4c4e524a; // "JRNL"
+
+	std::string path_;
+	int fd_;
+	std::string pending_;
+	uint64_t appended_;
+	uint64_t durable_;
+	bool flushing_;
+	int error_;
+	JournalStats stats_;
+	mutable std::mutex mutex_;
+	std::condition_variable flushed_;
+
+	MutationJournal(const MutationJournal &);
+	MutationJournal& operator=(const MutationJournal &);
+
+	/**
+	 * Opens path_ for appending, writing the header if the file is new and
+	 * cutting off any partly written records at the end.
+	 */
+	void open() {
+		fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+		if (fd_ < 0)
+			throw_error("open " + path_, errno);
+		off_t size = ::lseek(fd_, 0, SEEK_END);
+		if (size == 0) {
+			std::string h = header();
+			if (!write_fd(fd_, h.data(), h.size()) || ::fsync(fd_) != 0) {
+				int error = errno;
+				::close(fd_);
+				throw_error("write " + path_, error);
+			}
+			return;
+		}
+		IgnoreRecord ignore;
+		off_t valid;
+		bool torn;
+		int error = 0;
+		::lseek(fd_, 0, SEEK_SET);
+		bool ok = scan(fd_, ignore, valid, torn, error);
+		if (error == 0 && ok && torn && (::ftruncate(fd_, valid) != 0
+				|| ::fsync(fd_) != 0))
+			error = errno;
+		if (error != 0 || !ok) {
+			::close(fd_);
+			if (error != 0)
+				throw_error("recover " + path_, error);
+			throw tree_exception("MutationJournal: '" + path_
+					+ "' has a bad header.");
+		}
+		::lseek(fd_, valid, SEEK_SET);
+	}
+
+	/**
+	 * Reads the journal open at fd from the start, a chunk at a time, and
+	 * calls on_record(op, key, value) for each whole, valid record. Sets
+	 * valid to the length of the header and those records, and torn if
+	 * anything follows them. A record whose length runs past the end of the
+	 * file counts as torn, so a garbage length is never allocated for.
+	 * Returns false if the header is bad; error is set if a read fails.
+	 */
+	template<typename F>
+	static bool scan(int fd, F &on_record, off_t &valid, bool &torn,
+			int &error) {
+		valid = 0;
+		torn = false;
+		struct stat st;
+		if (::fstat(fd, &st) != 0) {
+			error = errno;
+			return true;
+		}
+		std::vector<char> buffer(CHUNK_BYTES);
+		size_t begin = 0, end = 0;
+		bool eof = false;
+		while (true) {
+			const char *p = buffer.data() + begin;
+			const char *stop = buffer.data() + end;
+			size_t length = 0;
+			bool whole = valid == 0 ?
+					static_cast<size_t>(stop - p) >= header().size() :
+					record_length(p, stop, length);
+			if (!whole) {
+				if (eof) {
+					torn = p != stop;
+					return valid != 0 || p == stop;
+				}
+				// valid is the offset of p in the file.
+				if (length > static_cast<size_t>(st.st_size - valid)) {
+					torn = true;
+					return true;
+				}
+				// Move the partial record to the front, growing the buffer
+				// if it does not fit, and read more after it.
+				std::memmove(buffer.data(), p, stop - p);
+				end -= begin;
+				begin = 0;
+				if (length > buffer.size())
+					buffer.resize(length);
+				ssize_t got = ::read(fd, buffer.data() + end,
+						buffer.size() - end);
+				if (got < 0) {
+					if (errno == EINTR)
+						continue;
+					error = errno;
+					return true;
+				}
+				end += got;
+				eof = got == 0;
+				continue;
+			}
+			if (valid == 0) {
+				if (!check_header(p, stop))
+					return false;
+				begin += header().size();
+				valid = header().size();
+				continue;
+			}
+			const char *q = p;
+			char op;
+			K key;
+			V value;
+			if (!decode_record(q, p + length, op, key, value)) {
+				torn = true;
+				return true;
+			}
+			on_record(op, key, value);
+			begin += length;
+			valid += length;
+		}
+	}
+
+	/**
+	 * The work of replay(): collects the leading sorted run of inserts for
+	 * bulk_load() and applies everything after it one record at a time.
+	 */
+	struct Replayer {
+		RedBlackTree<K, V> &tree;
+		JournalReplayStats &stats;
+		std::vector<std::pair<K, V> > run;
+		bool sorted;
+
+		Replayer(RedBlackTree<K, V> &t, JournalReplayStats &s) :
+				tree(t), stats(s), sorted(t.size() == 0) {
+		}
+
+		void operator()(char op, const K &key, const V &value) {
+			++stats.records;
+			if (sorted && op == INSERT
+					&& (run.empty() || run.back().first < key)) {
+				run.push_back(std::pair<K, V>(key, value));
+				return;
+			}
+			finish();
+			if (op == ERASE) {
+				stats.skipped += !tree.erase(key);
+				return;
+			}
+			try {
+				tree.insert(key, value);
+			} catch (const tree_exception &) {
+				++stats.skipped;
+			}
+		}
+
+		/**
+		 * Bulk loads the run collected so far, if any.
+		 */
+		void finish() {
+			if (!sorted)
+				return;
+			sorted = false;
+			if (run.empty())
+				return;
+			stats.bulk_loaded = run.size();
+			tree.bulk_load(run.begin(), run.end());
+			std::vector<std::pair<K, V> >().swap(run);
+		}
+	};
+
+	/**
+	 * Callback for scan() when only the valid length is wanted.
+	 */
+	struct IgnoreRecord {
+		void operator()(char, const K &, const V &) const {
+		}
+	};
+
+	static std::string header() {
+		std::string h;
+		uint32_t layout[3] = { MAGIC, key_layout<K>(), key_layout<V>() };
+		h.append(reinterpret_cast<const char*>(layout), sizeof(layout));
+		return h;
+	}
+
+	/**
+	 * Identifies how a type is stored: its size, or 0 for a string.
+	 */
+	template<typename T>
+	static uint32_t key_layout() {
+		return std::is_same<T, std::string>::value ?
+				0 : static_cast<uint32_t>(sizeof(T));
+	}
+
+	static bool check_header(const char *&p, const char *stop) {
+		std::string h = header();
+		if (static_cast<size_t>(stop - p) < h.size()
+				|| std::memcmp(p, h.data(), h.size()) != 0)
+			return false;
+		p += h.size();
+		return true;
+	}
+
+	/**
+	 * Sets length to the size of the record at p if all of it is in
+	 * [p, stop).
+	 */
+	static bool record_length(const char *p, const char *stop,
+			size_t &length) {
+		if (static_cast<size_t>(stop - p) < 1 + RECORD_HEADER)
+			return false;
+		uint32_t payload;
+		std::memcpy(&payload, p + 1, sizeof(payload));
+		length = 1 + RECORD_HEADER + payload;
+		return static_cast<size_t>(stop - p) >= length;
+	}
+
+	/**
+	 * Checks and decodes the whole record in [p, stop).
+	 */
+	static bool decode_record(const char *&p, const char *stop, char &op,
+			K &key, V &value) {
+		uint32_t checksum;
+		std::memcpy(&checksum, p + 5, sizeof(checksum));
+		const char *payload = p + 1 + RECORD_HEADER;
+		if (checksum != fnv1a(p, 1, fnv1a(payload, stop - payload)))
+			return false;
+		op = *p;
+		p = payload;
+		if (!journal_decode(p, stop, key))
+			return false;
+		if (op == INSERT)
+			return journal_decode(p, stop, value) && p == stop;
+		return op == ERASE && p == stop;
+	}
+
+	size_t begin_record(Op op) {
+		size_t start = pending_.size();
+		pending_.push_back(static_cast<char>(op));
+		pending_.append(RECORD_HEADER, '\0');
+		return start;
+	}
+
+	uint64_t end_record(size_t start) {
+		seal(pending_, start);
+		++stats_.records;
+		stats_.bytes += pending_.size() - start;
+		return ++appended_;
+	}
+
+	/**
+	 * Fills in the length and checksum of the record that starts at start
+	 * and runs to the end of out.
+	 */
+	static void seal(std::string &out, size_t start) {
+		uint32_t payload = static_cast<uint32_t>(out.size() - start - 1
+				- RECORD_HEADER);
+		const char *p = out.data() + start;
+		uint32_t checksum = fnv1a(p, 1,
+				fnv1a(p + 1 + RECORD_HEADER, payload));
+		out.replace(start + 1, sizeof(payload),
+				reinterpret_cast<const char*>(&payload), sizeof(payload));
+		out.replace(start + 5, sizeof(checksum),
+				reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+	}
+
+	static uint32_t fnv1a(const char *p, size_t n,
+			uint32_t h = 2166136261u) {
+		for (size_t i = 0; i < n; ++i)
+			h = (h ^ static_cast<unsigned char>(p[i])) * 16777619u;
+		return h;
+	}
+
+	/**
+	 * Syncs the directory holding path_, so that a rename into it is on
+	 * disk.
+	 */
+	bool sync_directory() const {
+		size_t slash = path_.rfind('/');
+		std::string dir = slash == std::string::npos ? "." :
+				slash == 0 ? "/" : path_.substr(0, slash);
+		int fd = ::open(dir.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		bool ok = ::fsync(fd) == 0;
+		int error = errno;
+		::close(fd);
+		errno = error;
+		return ok;
+	}
+
+	static bool write_fd(int fd, const char *p, size_t n) {
+		while (n > 0) {
+			ssize_t wrote = ::write(fd, p, n);
+			if (wrote < 0) {
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+			p += wrote;
+			n -= wrote;
+		}
+		return true;
+	}
+
+	static void throw_error(const std::string &what, int error) {
+		throw tree_exception("MutationJournal: cannot " + what + ": "
+				+ std::strerror(error) + ".");
+	}
+};
+
+#endif /* JOURNAL_H_ */
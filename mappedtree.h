@@ -0,0 +1,715 @@
+/*******************************************************************************
+ * Name        : mappedtree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Red-black tree whose nodes live in a memory-mapped file and
+ *               link to each other by byte offset into the file instead of
+ *               by pointer. Inserts, finds and iteration work on the mapped
+ *               pages in place; the file grows in large extents, and
+ *               reopening it maps it again with no rebuild or reload, unless
+ *               the last writer died mid-insert.
+ ******************************************************************************/
+#ifndef MAPPEDTREE_H_
+#define MAPPEDTREE_H_
+
+#include "rbtree.h"
+#include "tree.h"
+#include "treestats.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdint.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * A node of MappedRedBlackTree. Links are byte offsets from the start of the
+ * file; NIL, offset 0, falls inside the header, so no node is ever there.
+ */
+template<typename K, typename V>
+struct MappedNode {
+	static const uint64_t NIL = 0;
+
+	K key;
+	V value;
+	uint64_t left, right, parent;
+	unsigned char color;
+
+	MappedNode(const K &k, const V &v, uint64_t p) :
+			key(k), value(v), left(NIL), right(NIL), parent(p), color(RED) {
+	}
+};
+
+template<typename K, typename V>
+class MappedRedBlackTree;
+
+template<typename K, typename V>
+class MappedTreeIterator {
+public:
+	/**
+	 * Result of operator->. Keys and values are not stored as a std::pair,
+	 * so it holds a pair of references to them: it->second = v updates the
+	 * value in the mapped file, as value() does.
+	 */
+	class pair_proxy {
+	public:
+		const std::pair<const K&, V&>* operator->() const {
+			return &pair_;
+		}
+
+	private:
+		std::pair<const K&, V&> pair_;
+
+		pair_proxy(const K &key, V &value) :
+				pair_(key, value) {
+		}
+
+		friend class MappedTreeIterator;
+	};
+
+	MappedTreeIterator() :
+			offset_(MappedNode<K, V>::NIL), tree_(NULL) {
+	}
+
+	bool operator==(const MappedTreeIterator &rhs) const {
+		return offset_ == rhs.offset_;
+	}
+
+	bool operator!=(const MappedTreeIterator &rhs) const {
+		return offset_ != rhs.offset_;
+	}
+
+	std::pair<K, V> operator*() const {
+		return std::pair<K, V>(key(), value());
+	}
+
+	pair_proxy operator->() const {
+		return pair_proxy(key(), value());
+	}
+
+	const K& key() const {
+		return tree_->node(offset_).key;
+	}
+
+	/**
+	 * Returns the value in the mapped file; assigning to it updates the
+	 * file in place.
+	 */
+	V& value() const {
+		return tree_->node(offset_).value;
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key.
+	 */
+	MappedTreeIterator& operator++() {
+		if (offset_ == MappedNode<K, V>::NIL) {
+			// ++ from end(). Move to the first node in order.
+			if (tree_->root() == MappedNode<K, V>::NIL)
+				throw tree_exception(
+						"MappedTreeIterator operator++(): tree empty");
+			offset_ = tree_->minimum(tree_->root());
+		} else {
+			offset_ = tree_->successor(offset_);
+		}
+		return *this;
+	}
+
+	MappedTreeIterator operator++(int) {
+		MappedTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	// Positions are offsets, so iterators stay valid when the file grows
+	// and is mapped at a new address.
+	uint64_t offset_;
+	MappedRedBlackTree<K, V> *tree_;
+	friend class MappedRedBlackTree<K, V> ;
+
+	MappedTreeIterator(uint64_t offset, MappedRedBlackTree<K, V> *t) :
+			offset_(offset), tree_(t) {
+	}
+};
+
+/**
+ * Red-black tree with the insert, find, iterator and statistics interface of
+ * IndexedRedBlackTree, kept in a file mapped with MAP_SHARED. The file holds
+ * a small header (layout, root offset, node count, end of the last node)
+ * followed by the nodes in insertion order; nothing in it is an address, so
+ * it can be mapped anywhere. Opening an existing file checks the header and
+ * maps it, in O(1); pages are read in by the kernel as they are touched.
+ *
+ * When the nodes reach the end of the file, it is extended by extent bytes
+ * at once and mapped again, possibly at a new address; iterators hold
+ * offsets and stay valid. The new blocks are allocated before they are
+ * mapped, so a full disk is reported as an exception rather than a SIGBUS
+ * on the first store. K and V must be trivially copyable, and a file can
+ * only be reopened with the same K and V on a machine with the same layout.
+ *
+ * Changes reach the file through the page cache, so they survive the
+ * process exiting or crashing. An insert sets a flag in the header before
+ * touching any node and clears it once the node is linked and the tree
+ * rebalanced. Nodes are only ever appended, and the count covers only
+ * finished inserts, so if the process dies mid-insert, the next open finds
+ * the flag set and relinks the counted nodes into a balanced tree, in
+ * O(n log n), dropping the unfinished one. sync() writes everything to
+ * disk; a machine crash between syncs can lose or tear pages, which this
+ * does not repair.
+ */
+template<typename K, typename V>
+class MappedRedBlackTree: public Tree {
+	typedef MappedNode<K, V> node_type;
+	static const uint64_t NIL = node_type::NIL;
+	static const uint32_t MAGIC = 0x50414d52; // "RMAP"
+
+	static_assert(std::is_trivially_copyable<K>::value
+			&& std::is_trivially_copyable<V>::value,
+			"MappedRedBlackTree needs trivially copyable K and V");
+
+	/**
+	 * The start of the file.
+	 */
+	struct Header {
+		uint32_t magic, key_size, value_size, node_size;
+		uint64_t root, end, size;
+		// Nonzero from the start to the end of an insert.
+		uint64_t inserting;
+	};
+
+	// Offset of the first node: the header, padded to node alignment.
+	static const uint64_t FIRST = (sizeof(Header) + alignof(node_type) - 1)
+			/ alignof(node_type) * alignof(node_type);
+
+	/**
+	 * Accessor for treestats.h.
+	 */
+	struct Access {
+		typedef uint64_t node;
+		const MappedRedBlackTree *tree;
+
+		bool is_null(node n) const {
+			return n == NIL;
+		}
+
+		node left(node n) const {
+			return tree->node(n).left;
+		}
+
+		node right(node n) const {
+			return tree->node(n).right;
+		}
+
+		const K& key(node n) const {
+			return tree->node(n).key;
+		}
+
+		const V& value(node n) const {
+			return tree->node(n).value;
+		}
+	};
+
+public:
+	typedef MappedTreeIterator<K, V> iterator;
+
+	// Default growth step of the file: 16 MiB.
+	static const size_t DEFAULT_EXTENT = size_t(1) << 24;
+
+	/**
+	 * Opens the tree stored at path, creating the file if it does not exist,
+	 * and repairs it if an insert was cut short. The file grows extent bytes
+	 * at a time, rounded up to whole pages. Throws a tree_exception if the
+	 * file cannot be opened, grown or mapped, or was written for another key
+	 * or value layout.
+	 */
+	explicit MappedRedBlackTree(const std::string &path,
+			size_t extent = DEFAULT_EXTENT) :
+			path_(path), fd_(-1), base_(NULL), mapped_(0), extent_(extent) {
+		size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+		extent_ = (std::max(extent_, size_t(FIRST + sizeof(node_type)))
+				+ page - 1) / page * page;
+		open();
+	}
+
+	/**
+	 * Unmaps and closes the file. Changes not yet synced are written back by
+	 * the kernel in its own time.
+	 */
+	~MappedRedBlackTree() {
+		::munmap(base_, mapped_);
+		::close(fd_);
+	}
+
+	/**
+	 * Inserts a key-value pair. Throws a tree_exception on a duplicate key,
+	 * or if the file cannot grow.
+	 */
+	void insert(const K &key, const V &value) {
+		uint64_t x = header().root, y = NIL;
+		bool go_left = false;
+		while (x != NIL) {
+			y = x;
+			const K &k = node(x).key;
+			if (key < k) {
+				go_left = true;
+				x = node(x).left;
+			} else if (k < key) {
+				go_left = false;
+				x = node(x).right;
+			} else {
+				std::ostringstream oss;
+				oss << "Attempt to insert duplicate key '" << key << "'.";
+				throw tree_exception(oss.str());
+			}
+		}
+		// Growing may move the mapping, so no reference into it is held
+		// across this.
+		uint64_t z = allocate();
+		begin_insert();
+		header().end = z + sizeof(node_type);
+		new (&node(z)) node_type(key, value, y);
+		if (y == NIL)
+			header().root = z;
+		else if (go_left)
+			node(y).left = z;
+		else
+			node(y).right = z;
+		insert_fixup(z);
+		++header().size;
+		end_insert();
+	}
+
+	iterator find(const K &key) {
+		uint64_t x = header().root;
+		while (x != NIL) {
+			const K &k = node(x).key;
+			if (key < k)
+				x = node(x).left;
+			else if (k < key)
+				x = node(x).right;
+			else
+				break; // Found!
+		}
+		return iterator(x, this);
+	}
+
+	iterator begin() {
+		uint64_t root = header().root;
+		return iterator(root == NIL ? NIL : minimum(root), this);
+	}
+
+	iterator end() {
+		return iterator(NIL, this);
+	}
+
+	/**
+	 * Writes every change made so far to disk, returning once it is there.
+	 * Throws a tree_exception if the write fails.
+	 */
+	void sync() {
+		if (::msync(base_, mapped_, MS_SYNC) != 0)
+			throw_error("sync " + path_, errno);
+	}
+
+	/**
+	 * Returns the length of the file in bytes, including the unused space
+	 * at the end of the last extent.
+	 */
+	size_t file_size() const {
+		return mapped_;
+	}
+
+	std::string to_ascii_drawing() {
+		return tree_ascii_drawing<K, V>(access(), root());
+	}
+
+	int height() const {
+		return tree_height(access(), root()) - 1;
+	}
+
+	size_t size() const {
+		return static_cast<size_t>(header().size);
+	}
+
+	size_t leaf_count() const {
+		return tree_leaf_count(access(), root());
+	}
+
+	size_t internal_node_count() const {
+		return tree_internal_node_count(access(), root());
+	}
+
+	size_t diameter() const {
+		return tree_diameter(access(), root());
+	}
+
+	size_t max_width() const {
+		return tree_max_width(access(), root());
+	}
+
+	double successful_search_cost() const {
+		return tree_successful_search_cost(access(), root(), size());
+	}
+
+	double unsuccessful_search_cost() const {
+		return tree_unsuccessful_search_cost(access(), root(), size());
+	}
+
+private:
+	std::string path_;
+	int fd_;
+	char *base_;
+	// Bytes mapped, which is the length of the file, and the growth step.
+	size_t mapped_, extent_;
+	friend class MappedTreeIterator<K, V> ;
+
+	MappedRedBlackTree(const MappedRedBlackTree &);
+	MappedRedBlackTree& operator=(const MappedRedBlackTree &);
+
+	inline Header& header() {
+		return *reinterpret_cast<Header*>(base_);
+	}
+
+	inline const Header& header() const {
+		return *reinterpret_cast<const Header*>(base_);
+	}
+
+	inline node_type& node(uint64_t x) {
+		return *reinterpret_cast<node_type*>(base_ + x);
+	}
+
+	inline const node_type& node(uint64_t x) const {
+		return *reinterpret_cast<const node_type*>(base_ + x);
+	}
+
+	uint64_t root() const {
+		return header().root;
+	}
+
+	Access access() const {
+		Access a;
+		a.tree = this;
+		return a;
+	}
+
+	/**
+	 * Opens path_ and maps it, writing a header if the file is new and
+	 * checking the one there otherwise.
+	 */
+	void open() {
+		fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+		if (fd_ < 0)
+			throw_error("open " + path_, errno);
+		struct stat st;
+		if (::fstat(fd_, &st) != 0) {
+			int error = errno;
+			::close(fd_);
+			throw_error("open " + path_, error);
+		}
+		size_t length = static_cast<size_t>(st.st_size);
+		bool fresh = length == 0;
+		int error = 0;
+		if (fresh) {
+			length = extent_;
+			error = reserve(0, length);
+		}
+		if (error == 0 && length >= sizeof(Header))
+			error = map(length);
+		if (error != 0 || length < sizeof(Header)) {
+			::close(fd_);
+			if (error != 0)
+				throw_error("map " + path_, error);
+			throw tree_exception("MappedRedBlackTree: '" + path_
+					+ "' has a bad header.");
+		}
+		Header &h = header();
+		if (fresh) {
+			h.magic = MAGIC;
+			h.key_size = sizeof(K);
+			h.value_size = sizeof(V);
+			h.node_size = sizeof(node_type);
+			h.root = NIL;
+			h.end = FIRST;
+			h.size = 0;
+			h.inserting = 0;
+		} else if (!valid_header(h, length)) {
+			::munmap(base_, mapped_);
+			::close(fd_);
+			throw tree_exception("MappedRedBlackTree: '" + path_
+					+ "' has a bad header.");
+		} else if (h.inserting != 0) {
+			repair();
+		}
+	}
+
+	/**
+	 * Checks that h was written for this K and V and describes nodes that
+	 * fit in a file of length bytes. An insert cut short leaves end and
+	 * root unreliable; repair() rebuilds them from size.
+	 */
+	static bool valid_header(const Header &h, size_t length) {
+		if (h.magic != MAGIC || h.key_size != sizeof(K)
+				|| h.value_size != sizeof(V)
+				|| h.node_size != sizeof(node_type) || length < FIRST
+				|| h.size > (length - FIRST) / sizeof(node_type))
+			return false;
+		if (h.inserting != 0)
+			return true;
+		return h.end == FIRST + h.size * sizeof(node_type)
+				&& (h.root == NIL) == (h.size == 0)
+				&& (h.root == NIL || (h.root >= FIRST && h.root < h.end
+						&& (h.root - FIRST) % sizeof(node_type) == 0));
+	}
+
+	/**
+	 * Marks the start of an insert. The fence keeps the compiler from
+	 * moving any store to a node above the flag; stores that were made
+	 * reach the page cache in order even if the process dies.
+	 */
+	void begin_insert() {
+		header().inserting = 1;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+	}
+
+	void end_insert() {
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		header().inserting = 0;
+	}
+
+	/**
+	 * Rebuilds the tree from the first size nodes after an insert was cut
+	 * short: any node past them is dropped, and the rest are sorted by key
+	 * and relinked into a balanced tree with the black leaves of
+	 * RedBlackTree::bulk_load. Their keys and values were written before
+	 * they were counted, so only links and colors are rebuilt.
+	 */
+	void repair() {
+		Header &h = header();
+		size_t n = static_cast<size_t>(h.size);
+		std::vector<uint64_t> nodes(n);
+		for (size_t i = 0; i < n; ++i)
+			nodes[i] = FIRST + i * sizeof(node_type);
+		std::sort(nodes.begin(), nodes.end(), KeyOrder(this));
+		int red_depth = 0;
+		while ((size_t(2) << red_depth) - 1 <= n)
+			++red_depth;
+		h.root = relink(nodes, 0, n, NIL, 0, red_depth);
+		h.end = FIRST + n * sizeof(node_type);
+		h.inserting = 0;
+	}
+
+	/**
+	 * Orders node offsets by key.
+	 */
+	struct KeyOrder {
+		const MappedRedBlackTree *tree;
+
+		explicit KeyOrder(const MappedRedBlackTree *t) :
+				tree(t) {
+		}
+
+		bool operator()(uint64_t a, uint64_t b) const {
+			return tree->node(a).key < tree->node(b).key;
+		}
+	};
+
+	/**
+	 * Links nodes[first, first + n), in key order, into a balanced subtree
+	 * under parent and returns its root. Nodes at red_depth, the only
+	 * partly filled level, are red; all others are black.
+	 */
+	uint64_t relink(const std::vector<uint64_t> &nodes, size_t first,
+			size_t n, uint64_t parent, int depth, int red_depth) {
+		if (n == 0)
+			return NIL;
+		size_t left_count = (n - 1) / 2;
+		uint64_t x = nodes[first + left_count];
+		node_type &nx = node(x);
+		nx.parent = parent;
+		nx.color = depth == red_depth ? RED : BLACK;
+		nx.left = relink(nodes, first, left_count, x, depth + 1, red_depth);
+		nx.right = relink(nodes, first + left_count + 1, n - 1 - left_count,
+				x, depth + 1, red_depth);
+		return x;
+	}
+
+	/**
+	 * Allocates the blocks for bytes [from, to) of the file, extending it to
+	 * to, so that no later store to them can fail. Falls back to writing
+	 * zeros where the file system cannot preallocate. Returns 0 or an error
+	 * number.
+	 */
+	int reserve(size_t from, size_t to) {
+		int error = ::posix_fallocate(fd_, static_cast<off_t>(from),
+				static_cast<off_t>(to - from));
+		if (error != EOPNOTSUPP && error != EINVAL)
+			return error;
+		std::vector<char> zeros(std::min<size_t>(to - from, 1 << 16));
+		while (from < to) {
+			ssize_t wrote = ::pwrite(fd_, zeros.data(),
+					std::min(zeros.size(), to - from),
+					static_cast<off_t>(from));
+			if (wrote < 0) {
+				if (errno == EINTR)
+					continue;
+				return errno;
+			}
+			from += wrote;
+		}
+		return 0;
+	}
+
+	/**
+	 * Maps the first length bytes of the file, replacing the current
+	 * mapping if there is one. Returns 0, or errno with the old mapping
+	 * left in place.
+	 */
+	int map(size_t length) {
+		void *p = ::mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+				fd_, 0);
+		if (p == MAP_FAILED)
+			return errno;
+		if (base_ != NULL)
+			::munmap(base_, mapped_);
+		base_ = static_cast<char*>(p);
+		mapped_ = length;
+		return 0;
+	}
+
+	/**
+	 * Returns the offset of room for one more node at the end, first
+	 * extending the file by an extent if it is full.
+	 */
+	uint64_t allocate() {
+		uint64_t z = header().end;
+		if (z + sizeof(node_type) > mapped_) {
+			size_t length = mapped_ + extent_;
+			int error = reserve(mapped_, length);
+			if (error == 0)
+				error = map(length);
+			if (error != 0)
+				throw_error("grow " + path_, error);
+		}
+		return z;
+	}
+
+	inline unsigned char color_of(uint64_t x) const {
+		return x == NIL ? BLACK : node(x).color;
+	}
+
+	uint64_t minimum(uint64_t x) const {
+		while (node(x).left != NIL)
+			x = node(x).left;
+		return x;
+	}
+
+	uint64_t successor(uint64_t x) const {
+		if (node(x).right != NIL)
+			return minimum(node(x).right);
+		uint64_t y = node(x).parent;
+		while (y != NIL && x == node(y).right) {
+			x = y;
+			y = node(y).parent;
+		}
+		return y;
+	}
+
+	/**
+	 * Implementation of insert fixup method described on p. 316 of CLRS.
+	 */
+	void insert_fixup(uint64_t z) {
+		while (color_of(node(z).parent) == RED) {
+			uint64_t p = node(z).parent, g = node(p).parent;
+			if (p == node(g).left) {
+				uint64_t u = node(g).right;
+				if (color_of(u) == RED) {
+					node(p).color = node(u).color = BLACK;
+					node(g).color = RED;
+					z = g;
+				} else {
+					if (z == node(p).right) {
+						z = p;
+						left_rotate(z);
+						p = node(z).parent;
+					}
+					node(p).color = BLACK;
+					node(g).color = RED;
+					right_rotate(g);
+				}
+			} else {
+				uint64_t u = node(g).left;
+				if (color_of(u) == RED) {
+					node(p).color = node(u).color = BLACK;
+					node(g).color = RED;
+					z = g;
+				} else {
+					if (z == node(p).left) {
+						z = p;
+						right_rotate(z);
+						p = node(z).parent;
+					}
+					node(p).color = BLACK;
+					node(g).color = RED;
+					left_rotate(g);
+				}
+			}
+		}
+		node(header().root).color = BLACK;
+	}
+
+	/**
+	 * Implementation of left-rotate method as described on p. 313 of CLRS.
+	 */
+	void left_rotate(uint64_t x) {
+		uint64_t y = node(x).right;
+		node(x).right = node(y).left;
+		if (node(y).left != NIL)
+			node(node(y).left).parent = x;
+		replace_child(node(x).parent, x, y);
+		node(y).left = x;
+		node(x).parent = y;
+	}
+
+	/**
+	 * Implementation of right-rotate method as described on p. 313 of CLRS.
+	 */
+	void right_rotate(uint64_t x) {
+		uint64_t y = node(x).left;
+		node(x).left = node(y).right;
+		if (node(y).right != NIL)
+			node(node(y).right).parent = x;
+		replace_child(node(x).parent, x, y);
+		node(y).right = x;
+		node(x).parent = y;
+	}
+
+	/**
+	 * Makes y the child of p in place of x, or the root if p is NIL.
+	 */
+	void replace_child(uint64_t p, uint64_t x, uint64_t y) {
+		node(y).parent = p;
+		if (p == NIL)
+			header().root = y;
+		else if (x == node(p).left)
+			node(p).left = y;
+		else
+			node(p).right = y;
+	}
+
+	static void throw_error(const std::string &what, int error) {
+		throw tree_exception("MappedRedBlackTree: cannot " + what + ": "
+				+ std::strerror(error) + ".");
+	}
+};
+
+#endif /* MAPPEDTREE_H_ */
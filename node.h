@@ -56,11 +56,11 @@ public:
         return kv_pair_;
     }
 
-    inline K key() const {
+    inline const K& key() const {
         return kv_pair_.first;
     }
 
-    inline V value() const {
+    inline const V& value() const {
         return kv_pair_.second;
     }
 
@@ -80,10 +80,10 @@ class RedBlackNode : public Node<K, V> {
 public:
     typedef unsigned char color_t;
 
-    RedBlackNode() : color_(RED) { }
+    RedBlackNode() : color_(RED), dead_(false) { }
 
     RedBlackNode(const K &key, const V &value) :
-        Node<K, V>(key, value), color_(RED) { }
+        Node<K, V>(key, value), color_(RED), dead_(false) { }
 
     ~RedBlackNode() { }
 
@@ -107,8 +107,19 @@ public:
         color_ = color;
     }
 
+    // A dead node is a tombstone left by a lazy erase: still linked into
+    // the tree, but no longer holding a live key.
+    inline bool dead() const {
+        return dead_;
+    }
+
+    inline void set_dead(bool dead) {
+        dead_ = dead;
+    }
+
 private:
     color_t color_;
+    bool dead_;
 };
 
 #endif /* NODE_H_ */
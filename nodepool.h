@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * Name        : nodepool.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Slab allocator for tree nodes. Nodes are carved out of large
+ *               contiguous slabs and recycled through a free list, so a tree
+ *               can hand out runs of adjacent nodes and drop all of them at
+ *               once.
+ ******************************************************************************/
+#ifndef NODEPOOL_H_
+#define NODEPOOL_H_
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+/**
+ * Storage for objects of type T. The pool only hands out raw memory; the
+ * caller constructs with placement new and must destroy an object before
+ * giving its slot back with deallocate().
+ */
+template<typename T>
+class NodePool {
+public:
+	NodePool() :
+			free_(NULL), slab_(0), cursor_(NULL), end_(NULL), capacity_(0) {
+	}
+
+	~NodePool() {
+		release();
+	}
+
+	/**
+	 * Returns storage for one T, reusing freed slots first.
+	 */
+	void* allocate() {
+		if (free_ != NULL) {
+			Slot *s = free_;
+			free_ = s->next;
+			return s;
+		}
+		if (cursor_ == end_)
+			next_slab(0);
+		return cursor_++;
+	}
+
+	/**
+	 * Returns storage for n adjacent T's, from the current slab if it has
+	 * room and from a new slab of exactly n slots otherwise.
+	 */
+	void* allocate_block(size_t n) {
+		reserve(n);
+		Slot *block = cursor_;
+		cursor_ += n;
+		return block;
+	}
+
+	/**
+	 * Makes sure the next n allocations that do not hit the free list come
+	 * from one contiguous run of slots.
+	 */
+	void reserve(size_t n) {
+		if (static_cast<size_t>(end_ - cursor_) < n)
+			next_slab(n);
+	}
+
+	/**
+	 * Gives back a slot whose object has already been destroyed.
+	 */
+	void deallocate(void *p) {
+		Slot *s = static_cast<Slot*>(p);
+		s->next = free_;
+		free_ = s;
+	}
+
+	/**
+	 * Marks every slot unused while keeping the slabs for reuse. All objects
+	 * must have been destroyed (or be trivially destructible).
+	 */
+	void reset() {
+		free_ = NULL;
+		slab_ = 0;
+		if (slabs_.empty()) {
+			cursor_ = end_ = NULL;
+		} else {
+			cursor_ = slabs_[0].first;
+			end_ = cursor_ + slabs_[0].second;
+		}
+	}
+
+	/**
+	 * Frees every slab. All objects must have been destroyed.
+	 */
+	void release() {
+		for (size_t i = 0; i < slabs_.size(); ++i)
+			delete[] slabs_[i].first;
+		slabs_.clear();
+		free_ = NULL;
+		slab_ = 0;
+		cursor_ = end_ = NULL;
+		capacity_ = 0;
+	}
+
+	/**
+	 * Returns true if p points into one of this pool's slabs.
+	 */
+	bool owns(const void *p) const {
+		const Slot *s = static_cast<const Slot*>(p);
+		for (size_t i = 0; i < slabs_.size(); ++i)
+			if (s >= slabs_[i].first && s < slabs_[i].first + slabs_[i].second)
+				return true;
+		return false;
+	}
+
+	/**
+	 * Returns the number of slots held across all slabs.
+	 */
+	size_t capacity() const {
+		return capacity_;
+	}
+
+	void swap(NodePool &other) {
+		slabs_.swap(other.slabs_);
+		std::swap(free_, other.free_);
+		std::swap(slab_, other.slab_);
+		std::swap(cursor_, other.cursor_);
+		std::swap(end_, other.end_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+private:
+	static const size_t MIN_SLAB = 64;
+	static const size_t MAX_SLAB = 65536;
+
+	union Slot {
+		Slot *next;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	std::vector<std::pair<Slot*, size_t> > slabs_;
+	Slot *free_;
+	size_t slab_;
+	Slot *cursor_, *end_;
+	size_t capacity_;
+
+	// Slabs are owned by exactly one pool.
+	NodePool(const NodePool &);
+	NodePool& operator=(const NodePool &);
+
+	/**
+	 * Moves the bump pointer to a slab with at least min_slots free slots.
+	 * Slabs left over from before a reset() are reused in order; otherwise a
+	 * new slab is allocated, growing geometrically up to MAX_SLAB slots.
+	 */
+	void next_slab(size_t min_slots) {
+		size_t next = cursor_ == NULL ? 0 : slab_ + 1;
+		if (next < slabs_.size() && slabs_[next].second >= min_slots) {
+			slab_ = next;
+		} else {
+			size_t n = capacity_ < MIN_SLAB ? MIN_SLAB :
+						capacity_ > MAX_SLAB ? MAX_SLAB : capacity_;
+			if (n < min_slots)
+				n = min_slots;
+			Slot *slab = new Slot[n];
+			try {
+				slabs_.insert(slabs_.begin() + next, std::make_pair(slab, n));
+			} catch (...) {
+				delete[] slab;
+				throw;
+			}
+			capacity_ += n;
+			slab_ = next;
+		}
+		cursor_ = slabs_[slab_].first;
+		end_ = cursor_ + slabs_[slab_].second;
+	}
+};
+
+#endif /* NODEPOOL_H_ */
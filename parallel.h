@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Name        : parallel.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Minimal helper for running independent tasks on a fixed
+ *               number of threads.
+ ******************************************************************************/
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * Returns threads, or the hardware concurrency (at least 1) when it is 0.
+ */
+inline unsigned resolve_thread_count(unsigned threads) {
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	return threads == 0 ? 1 : threads;
+}
+
+/**
+ * Calls fn(i) for every i in [0, tasks) using up to threads threads (0 means
+ * one per hardware thread). Tasks are handed out through a shared counter,
+ * so a thread that finishes early takes the next pending task. The calling
+ * thread takes part. If any call throws, the remaining tasks are skipped and
+ * the first exception is rethrown once every thread has joined. If a thread
+ * cannot be started, no further tasks are handed out and its exception is
+ * rethrown once the threads already started have joined.
+ */
+template<typename Function>
+void parallel_for(size_t tasks, unsigned threads, Function fn) {
+	threads = resolve_thread_count(threads);
+	if (threads > tasks)
+		threads = static_cast<unsigned>(tasks);
+	if (threads <= 1) {
+		for (size_t i = 0; i < tasks; ++i)
+			fn(i);
+		return;
+	}
+
+	std::atomic<size_t> next(0);
+	std::atomic<bool> failed(false);
+	std::exception_ptr error;
+	std::atomic_flag error_lock = ATOMIC_FLAG_INIT;
+	auto worker = [&]() {
+		size_t i;
+		while (!failed.load() && (i = next.fetch_add(1)) < tasks) {
+			try {
+				fn(i);
+			} catch (...) {
+				if (!error_lock.test_and_set())
+					error = std::current_exception();
+				failed.store(true);
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	pool.reserve(threads - 1);
+	try {
+		for (unsigned t = 1; t < threads; ++t)
+			pool.emplace_back(worker);
+	} catch (...) {
+		// A thread could not be started. The ones that were must still be
+		// joined before the pool goes away.
+		failed.store(true);
+		for (size_t t = 0; t < pool.size(); ++t)
+			pool[t].join();
+		throw;
+	}
+	worker();
+	for (size_t t = 0; t < pool.size(); ++t)
+		pool[t].join();
+	if (error)
+		std::rethrow_exception(error);
+}
+
+#endif /* PARALLEL_H_ */
@@ -10,7 +10,12 @@
 #ifndef RBTREE_H_
 #define RBTREE_H_
 
+#include "bloomfilter.h"
+#include "findcache.h"
+#include "instrumentation.h"
 #include "node.h"
+#include "nodepool.h"
+#include "parallel.h"
 #include "tree.h"
 #include "treeprinter.h"
 #include <iostream>
@@ -20,11 +25,16 @@
 #include <sstream>
 #include <algorithm>
 #include <utility>
+#include <type_traits>
+#include <new>
 
-// Forward declaration
+// Forward declarations
 template<typename K, typename V>
 class RedBlackTree;
 
+template<typename K, typename V>
+class RedBlackTreeCursor;
+
 /**
  * tree_exception class
  * Demonstrates how you can write your own custom exceptions in C++.
@@ -89,46 +99,47 @@ public:
 		Node<K, V> *p;
 
 		if (node_ptr == NULL) {
-			// ++ from end(). Get the root of the tree.
-			node_ptr = tree->root_;
+			// ++ from end(). Move to the smallest value in the tree, which
+			// is the first node in an inorder traversal. The tree keeps
+			// track of it.
+			node_ptr = tree->leftmost_;
 
 			// Error, ++ requested for an empty tree.
 			if (node_ptr == NULL)
 				throw tree_exception(
 						"RedBlackTreeIterator operator++(): tree empty");
-
-			// Move to the smallest value in the tree, which is the first node
-			// in an inorder traversal.
-			while (node_ptr->left() != NULL) {
-				node_ptr = node_ptr->left();
-			}
 		} else {
-			if (node_ptr->right() != NULL) {
-				// Successor is the leftmost node of right subtree.
-				node_ptr = node_ptr->right();
-
-				while (node_ptr->left() != NULL) {
-					node_ptr = node_ptr->left();
-				}
-			} else {
-				// Have already processed the left subtree, and
-				// there is no right subtree. Move up the tree,
-				// looking for a parent for which node_ptr is a left child,
-				// stopping if the parent becomes NULL (or in this case,
-				// root_parent_. A non-NULL parent is the successor. If parent
-				// is NULL, the original node was the last node inorder, and
-				// its successor is the end of the list.
-				p = node_ptr->parent();
-				while (p != NULL && node_ptr == p->right()) {
+			// Tombstones left by lazy erases are stepped over.
+			do {
+				if (node_ptr->right() != NULL) {
+					// Successor is the leftmost node of right subtree.
+					node_ptr = node_ptr->right();
+
+					while (node_ptr->left() != NULL) {
+						node_ptr = node_ptr->left();
+					}
+				} else {
+					// Have already processed the left subtree, and
+					// there is no right subtree. Move up the tree,
+					// looking for a parent for which node_ptr is a left
+					// child, stopping if the parent becomes NULL (or in this
+					// case, root_parent_. A non-NULL parent is the
+					// successor. If parent is NULL, the original node was
+					// the last node inorder, and its successor is the end of
+					// the list.
+					p = node_ptr->parent();
+					while (p != NULL && node_ptr == p->right()) {
+						node_ptr = p;
+						p = p->parent();
+					}
+
+					// If we were previously at the rightmost node in
+					// the tree, node_ptr = NULL, and the iterator specifies
+					// the end of the list.
 					node_ptr = p;
-					p = p->parent();
 				}
-
-				// If we were previously at the rightmost node in
-				// the tree, node_ptr = NULL, and the iterator specifies
-				// the end of the list.
-				node_ptr = p;
-			}
+			} while (node_ptr != NULL
+					&& static_cast<RedBlackNode<K, V>*>(node_ptr)->dead());
 		}
 
 		return *this;
@@ -153,6 +164,7 @@ private:
 	Node<K, V> *node_ptr;
 	RedBlackTree<K, V> *tree;
 	friend class RedBlackTree<K, V> ;
+	friend class RedBlackTreeCursor<K, V> ;
 
 	/**
 	 * Constructor used to construct an iterator return value from a tree
@@ -163,16 +175,75 @@ private:
 	}
 };
 
+/**
+ * Remembers where its last search in a tree ended, and starts the next one
+ * there: find() climbs from that node only as far as needed and descends
+ * again, so lookups d keys from the previous one cost O(log d). Made for
+ * lookups with locality, such as a merge against a sorted stream.
+ *
+ * The cursor stays put across inserts and lazy erases. Anything that frees
+ * or moves nodes (an eager erase, clear(), compaction, assignment) sends
+ * its next search back to the root, so it never has to be reset by hand.
+ */
+template<typename K, typename V>
+class RedBlackTreeCursor {
+public:
+	/**
+	 * Constructor. A cursor must be bound to a tree before use.
+	 */
+	RedBlackTreeCursor() :
+			node_(NULL), tree_(NULL), epoch_(0) {
+	}
+
+	/**
+	 * Constructor to create a cursor whose first search starts at the root
+	 * of tree.
+	 */
+	explicit RedBlackTreeCursor(RedBlackTree<K, V> &tree) :
+			node_(NULL), tree_(&tree), epoch_(tree.epoch_) {
+	}
+
+	/**
+	 * Searches for key near the previous search. Returns an iterator
+	 * pointing at it if found, otherwise end().
+	 */
+	RedBlackTreeIterator<K, V> find(const K &key) {
+		if (epoch_ != tree_->epoch_) {
+			node_ = NULL;
+			epoch_ = tree_->epoch_;
+		}
+		RedBlackNode<K, V> *n = tree_->find_near_node(node_, key, node_);
+		return RedBlackTreeIterator<K, V>(n, tree_);
+	}
+
+	/**
+	 * Sends the next search back to the root.
+	 */
+	void reset() {
+		node_ = NULL;
+	}
+
+private:
+	// The last node visited, or NULL to start at the root, and the tree's
+	// epoch when it was visited.
+	RedBlackNode<K, V> *node_;
+	RedBlackTree<K, V> *tree_;
+	size_t epoch_;
+};
+
 template<typename K, typename V>
 class RedBlackTree: public Tree {
 public:
 	typedef RedBlackTreeIterator<K, V> iterator;
+	typedef RedBlackTreeCursor<K, V> cursor;
 
 	/**
 	 * Constructor to create an empty red-black tree.
 	 */
 	RedBlackTree() :
-			root_(NULL), size_(0) {
+			root_(NULL), leftmost_(NULL), size_(0), dead_(0),
+			max_dead_fraction_(0), compacting_(false), compact_cursor_(NULL),
+			epoch_(0) {
 	}
 
 	/**
@@ -180,15 +251,234 @@ public:
 	 * vector.
 	 */
 	RedBlackTree(std::vector<std::pair<K, V> > &elements) :
-			root_(NULL), size_(0) {
+			root_(NULL), leftmost_(NULL), size_(0), dead_(0),
+			max_dead_fraction_(0), compacting_(false), compact_cursor_(NULL),
+			epoch_(0) {
 		insert_elements(elements);
 	}
 
+	/**
+	 * Copy constructor. Clones the structure and colors of other node by
+	 * node in O(n), without re-running insert and fixup. The copies are laid
+	 * out in preorder in one contiguous block. Tombstones are copied too.
+	 * The copy's find cache has the same size as other's but starts empty;
+	 * its Bloom filter is a copy of other's.
+	 */
+	RedBlackTree(const RedBlackTree &other) :
+			Tree(other), root_(NULL), leftmost_(NULL), size_(0), dead_(0),
+			max_dead_fraction_(other.max_dead_fraction_),
+			find_cache_(other.find_cache_),
+			bloom_(other.bloom_), compacting_(false), compact_cursor_(NULL),
+			epoch_(0) {
+		if (other.root_ == NULL)
+			return;
+		RedBlackNode<K, V> *block = static_cast<RedBlackNode<K, V>*>(
+				pool_.allocate_block(other.node_count()));
+		RedBlackNode<K, V> *out = block;
+		try {
+			root_ = copy_into(other.root_, NULL, out);
+		} catch (...) {
+			destroy_nodes(block, out);
+			root_ = NULL;
+			throw;
+		}
+		leftmost_ = first_live(leftmost(root_));
+		size_ = other.size_;
+		dead_ = other.dead_;
+	}
+
+	/**
+	 * Move constructor. Steals the nodes of other in O(1) and leaves it
+	 * empty. Iterators into other must not be used afterwards.
+	 */
+	RedBlackTree(RedBlackTree &&other) :
+			Tree(other), root_(other.root_), leftmost_(other.leftmost_),
+			size_(other.size_), dead_(other.dead_),
+			max_dead_fraction_(other.max_dead_fraction_),
+			compacting_(other.compacting_),
+			compact_cursor_(other.compact_cursor_), epoch_(0) {
+		++other.epoch_;
+		other.root_ = NULL;
+		other.leftmost_ = NULL;
+		other.size_ = other.dead_ = 0;
+		other.compacting_ = false;
+		other.compact_cursor_ = NULL;
+		pool_.swap(other.pool_);
+		compact_pool_.swap(other.compact_pool_);
+		find_cache_.swap(other.find_cache_);
+		bloom_.swap(other.bloom_);
+	}
+
+	/**
+	 * Copy and move assignment. other is copied or moved into the parameter,
+	 * then swapped in; the old nodes are freed with the parameter.
+	 */
+	RedBlackTree& operator=(RedBlackTree other) {
+		swap(other);
+		return *this;
+	}
+
 	/**
 	 * Destructor.
 	 */
 	~RedBlackTree() {
-		delete_tree(root_);
+		clear();
+	}
+
+	/**
+	 * Exchanges the contents of two trees in O(1).
+	 */
+	void swap(RedBlackTree &other) {
+		std::swap(root_, other.root_);
+		std::swap(leftmost_, other.leftmost_);
+		std::swap(size_, other.size_);
+		std::swap(dead_, other.dead_);
+		std::swap(max_dead_fraction_, other.max_dead_fraction_);
+		pool_.swap(other.pool_);
+		compact_pool_.swap(other.compact_pool_);
+		std::swap(compacting_, other.compacting_);
+		std::swap(compact_cursor_, other.compact_cursor_);
+		find_cache_.swap(other.find_cache_);
+		bloom_.swap(other.bloom_);
+		++epoch_;
+		++other.epoch_;
+	}
+
+	/**
+	 * Deletes every node, leaving the tree empty. The node storage is kept
+	 * for the next inserts. When K and V are trivially destructible this is
+	 * O(1); otherwise each node is destroyed in O(n) with no recursion and no
+	 * extra memory: left children are rotated up until the node at the top
+	 * has none, then it is destroyed and its right child taken.
+	 */
+	void clear() {
+		if (!(std::is_trivially_destructible<K>::value
+				&& std::is_trivially_destructible<V>::value)) {
+			Node<K, V> *n = root_;
+			while (n != NULL) {
+				Node<K, V> *l = n->left();
+				if (l != NULL) {
+					n->set_left(l->right());
+					l->set_right(n);
+					n = l;
+				} else {
+					Node<K, V> *r = n->right();
+					n->~Node();
+					n = r;
+				}
+			}
+		}
+		pool_.reset();
+		if (compacting_)
+			end_compaction();
+		find_cache_.flush();
+		bloom_.clear();
+		root_ = leftmost_ = NULL;
+		size_ = dead_ = 0;
+		++epoch_;
+	}
+
+	/**
+	 * Returns a structural copy of the tree with all nodes in one contiguous
+	 * block, in O(n).
+	 */
+	RedBlackTree clone() const {
+		return RedBlackTree(*this);
+	}
+
+	/**
+	 * Like clone(), but splits the work across threads threads (0 means one
+	 * per hardware thread). The top few levels are copied first; the
+	 * subtrees hanging below them are then sized and copied concurrently,
+	 * each into its own range of the shared block. Small trees are cloned
+	 * serially.
+	 */
+	RedBlackTree clone_parallel(unsigned threads = 0) const {
+		threads = resolve_thread_count(threads);
+		if (threads == 1 || node_count() < PARALLEL_CLONE_MIN)
+			return clone();
+
+		// Cut the tree at a depth giving about four subtrees per thread.
+		int depth = 1;
+		while ((1u << depth) < 4 * threads)
+			++depth;
+		std::vector<const RedBlackNode<K, V>*> top, frontier;
+		split_at_depth(root_, 0, depth, top, frontier);
+
+		std::vector<size_t> offsets(frontier.size() + 1);
+		parallel_for(frontier.size(), threads, SubtreeCounter(frontier,
+				offsets));
+		offsets[0] = top.size();
+		for (size_t i = 1; i < offsets.size(); ++i)
+			offsets[i] += offsets[i - 1];
+
+		RedBlackTree copy;
+		RedBlackNode<K, V> *block = static_cast<RedBlackNode<K, V>*>(
+				copy.pool_.allocate_block(node_count()));
+		RedBlackNode<K, V> *out = block;
+		std::vector<RedBlackNode<K, V>*> parents(frontier.size()),
+				ends(frontier.size());
+		for (size_t i = 0; i < frontier.size(); ++i)
+			ends[i] = block + offsets[i];
+		try {
+			size_t next = 0;
+			copy.root_ = copy_top(root_, NULL, 0, depth, out, block, offsets,
+					parents, next);
+			parallel_for(frontier.size(), threads, SubtreeCopier(frontier,
+					parents, ends));
+		} catch (...) {
+			destroy_nodes(block, out);
+			for (size_t i = 0; i < frontier.size(); ++i)
+				destroy_nodes(block + offsets[i], ends[i]);
+			copy.root_ = NULL;
+			throw;
+		}
+		copy.leftmost_ = first_live(leftmost(copy.root_));
+		copy.size_ = size_;
+		copy.dead_ = dead_;
+		copy.max_dead_fraction_ = max_dead_fraction_;
+		FindCache<K, RedBlackNode<K, V> >(find_cache_).swap(copy.find_cache_);
+		KeyBloomFilter<K>(bloom_).swap(copy.bloom_);
+		return copy;
+	}
+
+	/**
+	 * Calls fn(key, value) for every pair, on up to threads threads (0 means
+	 * one per hardware thread), so fn must be safe to call concurrently.
+	 * As in clone_parallel(), the tree is cut into the nodes above a depth
+	 * and the subtrees hanging below them, and each thread takes the next
+	 * piece when it finishes one. Pairs within a subtree are visited in key
+	 * order; pieces run in no particular order. The tree must not change
+	 * meanwhile. Small trees are walked on the calling thread.
+	 */
+	template<typename F>
+	void parallel_for_each(F fn, unsigned threads = 0) const {
+		std::vector<Piece> pieces;
+		threads = cut_in_order(threads, pieces);
+		parallel_for(pieces.size(), threads, PieceVisitor<F>(pieces, fn));
+	}
+
+	/**
+	 * Returns combine(... combine(combine(identity, map(k1, v1)),
+	 * map(k2, v2)) ..., map(kn, vn)) over the pairs in key order, computed
+	 * on up to threads threads. The tree is cut as in parallel_for_each();
+	 * each piece is folded from identity in key order, and the partial
+	 * results are combined in key order. So combine must be associative,
+	 * with identity as its identity, but need not be commutative. map and
+	 * combine must be safe to call concurrently.
+	 */
+	template<typename T, typename Map, typename Combine>
+	T parallel_reduce(const T &identity, Map map, Combine combine,
+			unsigned threads = 0) const {
+		std::vector<Piece> pieces;
+		threads = cut_in_order(threads, pieces);
+		std::vector<Partial<T> > partials(pieces.size(), Partial<T>(identity));
+		parallel_for(pieces.size(), threads,
+				PieceReducer<T, Map, Combine>(pieces, partials, map, combine));
+		T result = identity;
+		for (size_t i = 0; i < partials.size(); ++i)
+			result = combine(result, partials[i].value);
+		return result;
 	}
 
 	/**
@@ -209,56 +499,20 @@ public:
 	 * Inserts a key-value pair into the red black tree.
 	 * const iterator &it indicates where to start the search for the place to
 	 * insert the node. If it == end(), the search starts at the root.
+	 * Otherwise it climbs from it only as far as needed to take in the key,
+	 * so a hint d keys away costs O(log d) rather than O(log n). Any hint
+	 * gives the right result.
 	 */
 	void insert(const iterator &it, const std::pair<K, V> &key_value) {
-		K key = key_value.first;
-		V value = key_value.second;
-		Node<K, V> *x, *y;
-		RedBlackNode<K, V> *insertedNode = new RedBlackNode<K, V>(key, value);
-		if (root_ != NULL && is_duplicate(root_, insertedNode)) {
-			std::stringstream ss;
-			ss << key;
-			std::string str_key = ss.str();
-			delete insertedNode;
-			tree_exception e(
-					"Attempt to insert duplicate key '" + str_key + "'.");
-			throw e;
-		}
-		if (it != end()) {
-			x = it.node_ptr;
-			y = x->parent();
-		} else {
-			x = root_;
-			y = NULL;
-		}
-		while (x != NULL) {
-			y = x;
-			if (x->key() > key) {
-				x = x->left();
-			} else {
-				x = x->right();
-			}
-		}
-		if (y == NULL)
-			root_ = insertedNode;
-		else if (insertedNode->key() < y->key())
-			y->set_left(insertedNode);
-		else
-			y->set_right(insertedNode);
-		insertedNode->set_parent(y);
-		size_++;
-		//TODO
-		//CALL FIXUP
-		insert_fixup(insertedNode);
-	}
-
-	bool is_duplicate(Node<K, V> *nodeStart, Node<K, V> *nodeSearch) {
-		if (nodeStart == NULL)
-			return false;
-		if (nodeSearch->value() == nodeStart->value())
-			return true;
-		return (is_duplicate(nodeStart->left(), nodeSearch)
-				or is_duplicate(nodeStart->right(), nodeSearch));
+		RBTREE_TIME(insert_latency);
+		RedBlackNode<K, V> *start = it != end() ?
+				finger(static_cast<RedBlackNode<K, V>*>(it.node_ptr),
+						key_value.first) : root_;
+		bool found;
+		RedBlackNode<K, V> *n = insert_below(start, key_value.first,
+				key_value.second, found);
+		if (found)
+			revive(n, key_value.second);
 	}
 
 	/**
@@ -269,6 +523,111 @@ public:
 		insert(e, std::pair<K, V>(key, value));
 	}
 
+	/**
+	 * Inserts the key-value pairs in [first, last), which must be in
+	 * strictly increasing key order, and returns how many were inserted.
+	 * Keys already in the tree are skipped. Each search starts from the
+	 * node inserted before it (a finger search), so m pairs landing
+	 * among n keys cost O(m log(n / m + 1)) comparisons rather than
+	 * O(m log n). Throws a tree_exception, leaving the tree unchanged, if
+	 * the keys are out of order.
+	 */
+	template<typename Iterator>
+	size_t insert_sorted_batch(Iterator first, Iterator last) {
+		check_sorted(first, last, "insert_sorted_batch",
+				PairKey<Iterator>());
+		RedBlackNode<K, V> *n = NULL;
+		size_t inserted = 0;
+		for (; first != last; ++first) {
+			RedBlackNode<K, V> *start = n == NULL ?
+					root_ : finger(n, first->first);
+			bool found;
+			n = insert_below(start, first->first, first->second, found);
+			if (!found) {
+				++inserted;
+			} else if (n->dead()) {
+				revive(n, first->second);
+				++inserted;
+			}
+		}
+		return inserted;
+	}
+
+	/**
+	 * Removes the keys in [first, last), which must be in strictly
+	 * increasing order, and returns how many were present. Each search
+	 * starts from where the one before it ended, as in
+	 * insert_sorted_batch(). Throws a tree_exception, leaving the tree
+	 * unchanged, if the keys are out of order.
+	 */
+	template<typename Iterator>
+	size_t erase_sorted_batch(Iterator first, Iterator last) {
+		check_sorted(first, last, "erase_sorted_batch", Key<Iterator>());
+		RedBlackNode<K, V> *n = NULL;
+		size_t erased = 0;
+		for (; first != last; ++first) {
+			RedBlackNode<K, V> *start = n == NULL ?
+					root_ : finger(n, *first);
+			RedBlackNode<K, V> *z = find_below(start, *first, n);
+			if (z == NULL || z->dead())
+				continue;
+			// The next search starts from z's successor, which a purge
+			// would not free, since it is live.
+			n = first_live(next_node(z));
+			if (max_dead_fraction_ > 0)
+				bury(z);
+			else
+				erase_at(z);
+			++erased;
+		}
+		return erased;
+	}
+
+	/**
+	 * Replaces the contents with the key-value pairs in [first, last), which
+	 * must be in strictly increasing key order, in O(n) and without any
+	 * fixup. The pairs are read once, front to back, into one contiguous
+	 * block of nodes in key order. Throws a tree_exception, leaving the tree
+	 * unchanged, if the keys are out of order.
+	 */
+	template<typename Iterator>
+	void bulk_load(Iterator first, Iterator last) {
+		check_sorted(first, last, "bulk_load", PairKey<Iterator>());
+		size_t n = std::distance(first, last);
+		RedBlackTree loaded;
+		if (n > 0) {
+			RedBlackNode<K, V> *block = static_cast<RedBlackNode<K, V>*>(
+					loaded.pool_.allocate_block(n));
+			RedBlackNode<K, V> *out = block;
+			// Every level above red_depth is full, so making the nodes on
+			// it red leaves one black height on every path.
+			int red_depth = 0;
+			while ((size_t(2) << red_depth) - 1 <= n)
+				++red_depth;
+			try {
+				loaded.root_ = build_balanced(first, n, NULL, 0, red_depth,
+						out);
+			} catch (...) {
+				destroy_nodes(block, out);
+				throw;
+			}
+			loaded.size_ = n;
+		}
+		std::swap(root_, loaded.root_);
+		std::swap(size_, loaded.size_);
+		std::swap(dead_, loaded.dead_);
+		leftmost_ = leftmost(root_);
+		pool_.swap(loaded.pool_);
+		// Any nodes in the compaction block are now loaded's to destroy.
+		loaded.compact_pool_.swap(compact_pool_);
+		compacting_ = false;
+		compact_cursor_ = NULL;
+		find_cache_.flush();
+		++epoch_;
+		if (bloom_.enabled())
+			rebuild_bloom_filter();
+	}
+
 	/**
 	 * Returns an ASCII representation of the red-black tree.
 	 */
@@ -285,7 +644,8 @@ public:
 	}
 
 	/**
-	 * Returns the number of nodes in the red-black tree.
+	 * Returns the number of keys in the red-black tree, not counting
+	 * tombstones.
 	 */
 	size_t size() const {
 		return size_;
@@ -327,12 +687,22 @@ public:
 		return max_width;
 	}
 
+	/**
+	 * Returns the number of nodes on each level, root level first.
+	 */
+	std::vector<size_t> level_widths() const {
+		std::vector<size_t> widths;
+		count_levels(root_, 0, widths);
+		return widths;
+	}
+
 	/**
 	 * Returns the successful search cost, i.e. the average number of nodes
 	 * visited to find a key that is present.
 	 */
 	double successful_search_cost() const {
-		return size_ == 0 ? 0 : 1 + (double) sum_levels() / size_;
+		return root_ == NULL ?
+				0 : 1 + (double) sum_levels() / node_count();
 	}
 
 	/**
@@ -345,39 +715,380 @@ public:
 
 	/**
 	 * Searches for item. If found, returns an iterator pointing
-	 * at it in the tree; otherwise, returns end().
+	 * at it in the tree; otherwise, returns end(). With the Bloom filter
+	 * on, most absent keys are rejected before descending; with the find
+	 * cache on, a cached key is returned without descending.
 	 */
 	iterator find(const K &key) {
-		Node<K, V> *x = root_;
-		while (x != NULL) {
-			K current_key = x->key();
-			if (key == current_key) {
-				break; // Found!
-			} else if (key < current_key) {
-				x = x->left();
+		RBTREE_TIME(find_latency);
+		if (bloom_.enabled() && !bloom_.may_contain(key))
+			return end();
+		RedBlackNode<K, V> *n =
+				find_cache_.enabled() ? find_cache_.lookup(key) : NULL;
+		if (n == NULL) {
+			n = static_cast<RedBlackNode<K, V>*>(find_node(key));
+			if (n != NULL && n->dead())
+				n = NULL;
+			if (n == NULL) {
+				if (bloom_.enabled())
+					bloom_.record_false_positive();
+			} else if (find_cache_.enabled()) {
+				find_cache_.store(key, n);
+			}
+		}
+		return iterator(n, this);
+	}
+
+	/**
+	 * Searches for key starting from hint rather than the root: climbs from
+	 * hint only as far as needed to take in key, then descends, so a key d
+	 * positions from hint is found in O(log d). If hint == end(), the search
+	 * starts at the root. Any hint gives the right result. Returns an
+	 * iterator pointing at key if found, otherwise end(). To keep the
+	 * position from one search to the next, use a cursor.
+	 */
+	iterator find_near(const iterator &hint, const K &key) {
+		RedBlackNode<K, V> *last;
+		return iterator(
+				find_near_node(
+						static_cast<RedBlackNode<K, V>*>(hint.node_ptr), key,
+						last), this);
+	}
+
+	/**
+	 * Removes key, returning false if it was not present. The node is
+	 * unlinked and the tree relinked around it; no key-value pair moves to
+	 * another node, so iterators to the remaining keys stay valid. With lazy
+	 * erase on, the node is left in place as a tombstone instead.
+	 */
+	bool erase(const K &key) {
+		RBTREE_TIME(erase_latency);
+		RedBlackNode<K, V> *z = static_cast<RedBlackNode<K, V>*>(find_node(
+				key));
+		if (z == NULL || z->dead())
+			return false;
+		if (max_dead_fraction_ > 0)
+			bury(z);
+		else
+			erase_at(z);
+		return true;
+	}
+
+	/**
+	 * Returns an iterator to the smallest key, or end() if the tree is
+	 * empty, in O(1): the leftmost node is kept up to date by every insert
+	 * and erase.
+	 */
+	iterator peek_min() {
+		return iterator(leftmost_, this);
+	}
+
+	/**
+	 * Removes and returns the pair with the smallest key, in O(1) amortized
+	 * time with no search. Throws a tree_exception if the tree is empty.
+	 */
+	std::pair<K, V> pop_min() {
+		RBTREE_TIME(erase_latency);
+		if (leftmost_ == NULL)
+			throw tree_exception("pop_min(): tree empty");
+		std::pair<K, V> min(leftmost_->key(), leftmost_->value());
+		erase_at(leftmost_);
+		return min;
+	}
+
+	/**
+	 * Removes every pair whose key is at most limit, calling fn(key, value)
+	 * on each in key order first, and returns how many were removed. Used
+	 * with expiry times as keys, this pops everything due by limit.
+	 *
+	 * Rather than erasing the pairs one by one, the tree is split at limit
+	 * in one descent. The subtrees left of the path are dropped whole; the
+	 * nodes right of the path and their right subtrees are joined back
+	 * bottom-up by black height, and the joins' fixups together cost
+	 * O(log n). The whole call is O(m + log n) for m pairs removed. If fn
+	 * throws, the remaining pairs are still removed, without calling it,
+	 * and the exception is rethrown.
+	 */
+	template<typename F>
+	size_t pop_while(const K &limit, F fn) {
+		RBTREE_TIME(erase_latency);
+		if (leftmost_ == NULL || limit < leftmost_->key())
+			return 0;
+		// Along the path: the expired nodes, whose left subtrees go with
+		// them, and the kept nodes, with the black height of their
+		// children.
+		RedBlackNode<K, V> *expired[MAX_DEPTH], *kept[MAX_DEPTH];
+		int kept_height[MAX_DEPTH];
+		size_t expired_count = 0, kept_count = 0;
+		int height = 0;
+		for (RedBlackNode<K, V> *n = root_; n != NULL; n = n->left())
+			height += is_black(n);
+		for (RedBlackNode<K, V> *n = root_; n != NULL;) {
+			height -= is_black(n);
+			if (limit < n->key()) {
+				kept_height[kept_count] = height;
+				kept[kept_count++] = n;
+				n = n->left();
 			} else {
-				x = x->right();
+				// Cut off the rest of the path, leaving n and its left
+				// subtree as one piece to drop.
+				expired[expired_count++] = n;
+				RedBlackNode<K, V> *next = n->right();
+				n->set_right(NULL);
+				n = next;
 			}
 		}
-		return iterator(static_cast<RedBlackNode<K, V>*>(x), this);
+
+		RedBlackNode<K, V> *rest = NULL;
+		int rest_height = 0;
+		while (kept_count > 0) {
+			--kept_count;
+			RedBlackNode<K, V> *k = kept[kept_count];
+			rest = join(rest, rest_height, k, k->right(),
+					kept_height[kept_count]);
+		}
+		if (rest != NULL && rest->color() == RED)
+			recolor(rest, BLACK);
+		root_ = rest;
+		leftmost_ = first_live(leftmost(root_));
+
+		// Frees the dropped pieces in key order, as clear() does: left
+		// children are rotated up until the node on top has none.
+		std::exception_ptr error;
+		size_t removed = 0, buried = 0;
+		for (size_t i = 0; i < expired_count; ++i) {
+			RedBlackNode<K, V> *n = expired[i];
+			while (n != NULL) {
+				RedBlackNode<K, V> *l = n->left();
+				if (l != NULL) {
+					n->set_left(l->right());
+					l->set_right(n);
+					n = l;
+					continue;
+				}
+				if (n->dead()) {
+					++buried;
+				} else {
+					++removed;
+					if (!error) {
+						try {
+							fn(n->key(), n->value());
+						} catch (...) {
+							error = std::current_exception();
+						}
+					}
+				}
+				if (find_cache_.enabled())
+					find_cache_.invalidate(n->key(), n);
+				if (n == compact_cursor_)
+					compact_cursor_ = NULL;
+				RedBlackNode<K, V> *r = n->right();
+				free_node(n);
+				n = r;
+			}
+		}
+		size_ -= removed;
+		dead_ -= buried;
+		if (bloom_.enabled()) {
+			bool rebuild = false;
+			for (size_t i = 0; i < removed; ++i)
+				rebuild = bloom_.erase(size_) || rebuild;
+			if (rebuild)
+				rebuild_bloom_filter();
+		}
+		if (error)
+			std::rethrow_exception(error);
+		return removed;
 	}
 
 	/**
-	 * Return an iterators pointing to the first item in order.
+	 * Puts a direct-mapped cache of slots entries (rounded up to a power of
+	 * two) in front of find(), for workloads where a few keys take most of
+	 * the lookups. 0, the default, turns it off. Needs std::hash<K>.
 	 */
-	iterator begin() {
-		RedBlackNode<K, V> *curr = root_;
+	void set_find_cache_slots(size_t slots) {
+		find_cache_.resize(slots);
+	}
+
+	size_t find_cache_slots() const {
+		return find_cache_.slots();
+	}
+
+	/**
+	 * Returns the hits, misses and erase invalidations of the find cache.
+	 */
+	FindCacheStats find_cache_stats() const {
+		return find_cache_.stats();
+	}
+
+	void reset_find_cache_stats() {
+		find_cache_.reset_stats();
+	}
+
+	/**
+	 * Keeps a blocked Bloom filter alongside the tree, so that find()
+	 * answers most absent keys without descending. Each rebuild sizes it at
+	 * bits_per_key bits for twice the current keys; 10 bits per key keep
+	 * false positives under 1%, not counting recently erased keys. 0, the
+	 * default, turns it off. Needs std::hash<K>.
+	 */
+	void set_bloom_filter(double bits_per_key) {
+		bloom_.configure(bits_per_key);
+		if (bloom_.enabled())
+			rebuild_bloom_filter();
+	}
+
+	double bloom_filter_bits_per_key() const {
+		return bloom_.bits_per_key();
+	}
+
+	size_t bloom_filter_bytes() const {
+		return bloom_.bytes();
+	}
+
+	/**
+	 * Returns the checks, rejections, false positives and rebuilds of the
+	 * Bloom filter.
+	 */
+	BloomFilterStats bloom_filter_stats() const {
+		return bloom_.stats();
+	}
+
+	void reset_bloom_filter_stats() {
+		bloom_.reset_stats();
+	}
+
+	/**
+	 * Turns on lazy erase: erase() then only marks the node dead, with no
+	 * rotations, leaving a tombstone that find(), the iterators and size()
+	 * skip and that an insert of the same key brings back. Its pair is
+	 * destroyed when the tombstone is purged. Once tombstones make up more
+	 * than max_dead_fraction of the nodes, purge_tombstones() runs, so each
+	 * erase costs O(log n + 1 / max_dead_fraction) amortized. 0, the
+	 * default, turns it off and purges any tombstones left. The shape
+	 * statistics count tombstones, since searches still pass through them.
+	 */
+	void set_lazy_erase(double max_dead_fraction) {
+		max_dead_fraction_ = max_dead_fraction > 0 ? max_dead_fraction : 0;
+		if (dead_ > max_dead_fraction_ * node_count())
+			purge_tombstones();
+	}
+
+	double lazy_erase_threshold() const {
+		return max_dead_fraction_;
+	}
+
+	size_t tombstone_count() const {
+		return dead_;
+	}
 
-		// if the tree is not empty, the first node
-		// in order is the farthest node left from root
-		if (curr != NULL) {
-			while (curr->left() != NULL) {
-				curr = static_cast<RedBlackNode<K, V>*>(curr->left());
+	/**
+	 * Frees every tombstone and rebalances the live nodes into the shape
+	 * bulk_load() builds, in O(n) with no allocation and O(log n) stack:
+	 * the nodes are threaded into a list in key order through their right
+	 * links, walking them as clear() does, and relinked from the list. No
+	 * pair moves to another node, so iterators to live keys stay valid.
+	 */
+	void purge_tombstones() {
+		RedBlackNode<K, V> *head = NULL, *tail = NULL, *n = root_;
+		while (n != NULL) {
+			RedBlackNode<K, V> *l = n->left();
+			if (l != NULL) {
+				n->set_left(l->right());
+				l->set_right(n);
+				n = l;
+				continue;
+			}
+			RedBlackNode<K, V> *r = n->right();
+			if (n->dead()) {
+				// Everything before the cursor has been compacted.
+				if (n == compact_cursor_)
+					compact_cursor_ = tail;
+				free_node(n);
+			} else {
+				if (tail == NULL)
+					head = n;
+				else
+					tail->set_right(n);
+				tail = n;
 			}
+			n = r;
 		}
+		if (tail != NULL)
+			tail->set_right(NULL);
+		int red_depth = 0;
+		while ((size_t(2) << red_depth) - 1 <= size_)
+			++red_depth;
+		root_ = relink_balanced(head, size_, NULL, 0, red_depth);
+		leftmost_ = leftmost(root_);
+		dead_ = 0;
+		if (bloom_.enabled())
+			rebuild_bloom_filter();
+	}
+
+	/**
+	 * Moves every node into one new contiguous block, in preorder, so that
+	 * the nodes near the root share cache lines and a node's left child sits
+	 * right after it. Use after heavy churn has scattered the nodes over
+	 * the pool. Takes O(n), invalidates all iterators, and supersedes any
+	 * incremental compaction in progress.
+	 */
+	void compact() {
+		RedBlackTree copy(*this);
+		std::swap(root_, copy.root_);
+		std::swap(leftmost_, copy.leftmost_);
+		pool_.swap(copy.pool_);
+		// The old nodes, wherever they are, are destroyed with copy.
+		copy.compact_pool_.swap(compact_pool_);
+		compacting_ = false;
+		compact_cursor_ = NULL;
+		find_cache_.flush();
+		++epoch_;
+	}
 
-		// build return value using private constructor
-		return iterator(curr, this);
+	/**
+	 * Does one bounded slice of an incremental compaction: visits up to
+	 * max_nodes nodes in key order, moving each one that is not yet in the
+	 * new block there. The first call reserves a block for the whole tree.
+	 * The tree may be used and changed freely between calls; nodes inserted
+	 * meanwhile are allocated in the new block. Returns true once every
+	 * node has moved and the old storage is freed, leaving the nodes laid
+	 * out in key order. Iterators to moved nodes are invalidated.
+	 */
+	bool compact_step(size_t max_nodes) {
+		if (!compacting_) {
+			compact_pool_.reserve(node_count());
+			compacting_ = true;
+			compact_cursor_ = NULL;
+		}
+		RedBlackNode<K, V> *n = compact_cursor_ == NULL ?
+				leftmost(root_) : next_node(compact_cursor_);
+		for (; n != NULL && max_nodes > 0; --max_nodes) {
+			if (!compact_pool_.owns(n))
+				n = relocate(n);
+			compact_cursor_ = n;
+			n = next_node(n);
+		}
+		if (n != NULL)
+			return false;
+		pool_.swap(compact_pool_);
+		end_compaction();
+		return true;
+	}
+
+	/**
+	 * Returns true between the first and last compact_step() of an
+	 * incremental compaction.
+	 */
+	bool compacting() const {
+		return compacting_;
+	}
+
+	/**
+	 * Return an iterators pointing to the first item in order.
+	 */
+	iterator begin() {
+		return iterator(leftmost_, this);
 	}
 
 	/**
@@ -387,30 +1098,886 @@ public:
 		return iterator(NULL, this);
 	}
 
+	/**
+	 * Returns a snapshot of the counters and latency histograms recorded
+	 * since construction or the last reset_metrics(). Everything is zero
+	 * unless the tree was compiled with -DRBTREE_INSTRUMENT.
+	 */
+	TreeMetrics metrics() const {
+		TreeMetrics snapshot;
+#ifdef RBTREE_INSTRUMENT
+		snapshot = metrics_;
+#endif
+		snapshot.pool_capacity_bytes = pool_.capacity()
+				* sizeof(RedBlackNode<K, V>);
+		return snapshot;
+	}
+
+	/**
+	 * Zeroes the counters and histograms, e.g. after exporting them.
+	 */
+	void reset_metrics() {
+#ifdef RBTREE_INSTRUMENT
+		metrics_.reset();
+#endif
+	}
+
+	/**
+	 * Returns true if the tree was compiled with -DRBTREE_INSTRUMENT.
+	 */
+	static bool instrumented() {
+#ifdef RBTREE_INSTRUMENT
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * Returns true if the root is black, no red node has a red child, every
+	 * path down from a node passes the same number of black nodes, each
+	 * child links back to its parent, the keys ascend, and size(),
+	 * tombstone_count() and peek_min() agree with the nodes. Takes O(n);
+	 * meant for tests.
+	 */
+	bool valid() const {
+		size_t live = 0, dead = 0;
+		const RedBlackNode<K, V> *first = NULL, *last = NULL;
+		return (root_ == NULL
+				|| (root_->parent() == NULL && root_->color() == BLACK))
+				&& black_height(root_, live, dead, first, last) > 0
+				&& live == size_ && dead == dead_ && first == leftmost_;
+	}
+
 private:
+	// Trees smaller than this are not worth starting threads for.
+	static const size_t PARALLEL_CLONE_MIN = 1 << 16;
+	// Bound on the height of a red-black tree that fits in memory.
+	static const size_t MAX_DEPTH = 2 * 8 * sizeof(void*);
+
 	RedBlackNode<K, V> *root_;
-	size_t size_;
+	// The smallest live node, and the live and dead node counts.
+	RedBlackNode<K, V> *leftmost_;
+	size_t size_, dead_;
+	// Lazy erase purges tombstones past this fraction of the nodes; 0 when
+	// it is off.
+	double max_dead_fraction_;
+	NodePool<RedBlackNode<K, V> > pool_;
+	FindCache<K, RedBlackNode<K, V> > find_cache_;
+	KeyBloomFilter<K> bloom_;
+	// State of an incremental compaction: the block nodes are moving into,
+	// and the last node moved (NULL before the first).
+	NodePool<RedBlackNode<K, V> > compact_pool_;
+	bool compacting_;
+	RedBlackNode<K, V> *compact_cursor_;
+	// Bumped whenever nodes may have been freed or moved, so that cursors
+	// know their last node can no longer be trusted.
+	size_t epoch_;
+#ifdef RBTREE_INSTRUMENT
+	TreeMetrics metrics_;
+#endif
 	friend class RedBlackTreeIterator<K, V> ;
+	friend class RedBlackTreeCursor<K, V> ;
+
+	/**
+	 * Returns the node holding key, or NULL.
+	 */
+	Node<K, V>* find_node(const K &key) {
+		RedBlackNode<K, V> *last;
+		return find_below(root_, key, last);
+	}
 
 	/**
-	 * Deletes all nodes from the red-black tree.
+	 * Searches the subtree rooted at x for key, returning its node or NULL.
+	 * last is set to the last node visited.
 	 */
-	void delete_tree(Node<K, V> *n) {
-		// TODO
-		if(n != NULL){
-			delete_tree(n->left());
-			delete_tree(n->right());
-			delete n;
+	RedBlackNode<K, V>* find_below(RedBlackNode<K, V> *x, const K &key,
+			RedBlackNode<K, V> *&last) {
+		size_t depth = 0;
+		last = x;
+		while (x != NULL) {
+			last = x;
+			++depth;
+			RBTREE_COUNT(comparisons, 1);
+			if (key < x->key()) {
+				x = x->left();
+			} else {
+				RBTREE_COUNT(comparisons, 1);
+				if (x->key() < key)
+					x = x->right();
+				else
+					break; // Found!
+			}
 		}
+		RBTREE_DESCENT(depth);
+		return x;
+	}
+
+	/**
+	 * Searches for key from hint, or from the root if hint is NULL, and
+	 * returns its node if live, otherwise NULL. last is set to the last node
+	 * visited; a key rejected by the Bloom filter leaves it at hint.
+	 */
+	RedBlackNode<K, V>* find_near_node(RedBlackNode<K, V> *hint, const K &key,
+			RedBlackNode<K, V> *&last) {
+		RBTREE_TIME(find_latency);
+		last = hint;
+		if (bloom_.enabled() && !bloom_.may_contain(key))
+			return NULL;
+		RedBlackNode<K, V> *n = find_below(
+				hint == NULL ? root_ : finger(hint, key), key, last);
+		if (n != NULL && n->dead())
+			n = NULL;
+		if (n == NULL && bloom_.enabled())
+			bloom_.record_false_positive();
+		return n;
 	}
 
+	/**
+	 * Inserts key below x, which must be the root or a node whose subtree
+	 * spans key, and returns its node. If key is already there, found is
+	 * set and nothing is inserted.
+	 */
+	RedBlackNode<K, V>* insert_below(RedBlackNode<K, V> *x, const K &key,
+			const V &value, bool &found) {
+		RedBlackNode<K, V> *y = x == NULL ? NULL : x->parent();
+		// Duplicates are detected on the way down, so no node is allocated
+		// for them.
+		bool go_left = false, all_left = x == root_;
+		size_t depth = 0;
+		found = false;
+		while (x != NULL) {
+			y = x;
+			++depth;
+			RBTREE_COUNT(comparisons, 1);
+			if (key < x->key()) {
+				go_left = true;
+				x = x->left();
+			} else {
+				RBTREE_COUNT(comparisons, 1);
+				if (x->key() < key) {
+					go_left = all_left = false;
+					x = x->right();
+				} else {
+					RBTREE_DESCENT(depth);
+					found = true;
+					return x;
+				}
+			}
+		}
+		RBTREE_DESCENT(depth);
+		RedBlackNode<K, V> *insertedNode = new_node(key, value);
+		if (y == NULL)
+			root_ = insertedNode;
+		else if (go_left)
+			y->set_left(insertedNode);
+		else
+			y->set_right(insertedNode);
+		insertedNode->set_parent(y);
+		// A descent from the root that only went left ends at the new
+		// minimum; any other has to compare.
+		if (all_left || leftmost_ == NULL || key < leftmost_->key())
+			leftmost_ = insertedNode;
+		size_++;
+		insert_fixup(insertedNode);
+		if (bloom_.enabled() && bloom_.insert(key, size_))
+			rebuild_bloom_filter();
+		return insertedNode;
+	}
+
+	/**
+	 * Returns the lowest node on the path from n up to the root whose
+	 * subtree spans key, to start a search for key near n. n's own key is
+	 * one bound, so the climb stops at the first ancestor on the far side
+	 * of key, after O(log d) steps for a key d positions from n's.
+	 */
+	RedBlackNode<K, V>* finger(RedBlackNode<K, V> *n, const K &key) {
+		RBTREE_COUNT(comparisons, 2);
+		bool right = n->key() < key;
+		if (!right && !(key < n->key()))
+			return n;
+		for (RedBlackNode<K, V> *p = n->parent(); p != NULL;
+				n = p, p = p->parent()) {
+			if (n != (right ? p->left() : p->right()))
+				continue;
+			RBTREE_COUNT(comparisons, 1);
+			if (right ? !(p->key() < key) : !(key < p->key())) {
+				RBTREE_COUNT(comparisons, 1);
+				return (right ? key < p->key() : p->key() < key) ? n : p;
+			}
+		}
+		return n;
+	}
+
+	/**
+	 * Read the key at an iterator over pairs, or over keys.
+	 */
+	template<typename Iterator>
+	struct PairKey {
+		auto operator()(Iterator it) const -> decltype((it->first)) {
+			return it->first;
+		}
+	};
+
+	template<typename Iterator>
+	struct Key {
+		auto operator()(Iterator it) const -> decltype(*it) {
+			return *it;
+		}
+	};
+
+	/**
+	 * Throws a tree_exception naming caller if the keys in [first, last),
+	 * as read by key, are not in strictly increasing order.
+	 */
+	template<typename Iterator, typename KeyOf>
+	static void check_sorted(Iterator first, Iterator last,
+			const char *caller, KeyOf key) {
+		for (Iterator prev = first, it = first; it != last; prev = it) {
+			if (++it != last && !(key(prev) < key(it))) {
+				std::stringstream ss;
+				ss << key(it);
+				throw tree_exception(std::string(caller) + ": key '"
+						+ ss.str() + "' is out of order.");
+			}
+		}
+	}
+
+	/**
+	 * Refills the Bloom filter from every key, sized for twice the tree.
+	 */
+	void rebuild_bloom_filter() {
+		bloom_.rebuild(begin(), end(), size_);
+	}
+
+	void throw_duplicate(const K &key) const {
+		std::stringstream ss;
+		ss << key;
+		throw tree_exception("Attempt to insert duplicate key '" + ss.str()
+				+ "'.");
+	}
+
+	/**
+	 * Sets the color of a node during fixup, counting the change.
+	 */
+	inline void recolor(RedBlackNode<K, V> *n, unsigned char color) {
+		RBTREE_COUNT(recolorings, 1);
+		n->set_color(color);
+	}
+
+	/**
+	 * Constructs a node in storage taken from the pool.
+	 */
+	RedBlackNode<K, V>* new_node(const K &key, const V &value) {
+		// While compacting, new nodes go straight into the new block.
+		NodePool<RedBlackNode<K, V> > &pool =
+				compacting_ ? compact_pool_ : pool_;
+		void *p = pool.allocate();
+		RBTREE_COUNT(allocations, 1);
+		try {
+			return new (p) RedBlackNode<K, V>(key, value);
+		} catch (...) {
+			pool.deallocate(p);
+			throw;
+		}
+	}
+
+	/**
+	 * Moves n into the compaction block: the key-value pair is copied into
+	 * a new node, which takes n's place and color in the tree, and n is
+	 * freed. Returns the new node.
+	 */
+	RedBlackNode<K, V>* relocate(RedBlackNode<K, V> *n) {
+		++epoch_;
+		void *p = compact_pool_.allocate();
+		RedBlackNode<K, V> *m;
+		try {
+			m = new (p) RedBlackNode<K, V>(n->key(), n->value());
+		} catch (...) {
+			compact_pool_.deallocate(p);
+			throw;
+		}
+		RedBlackNode<K, V> *parent = n->parent(), *l = n->left(),
+				*r = n->right();
+		m->set_color(n->color());
+		m->set_dead(n->dead());
+		m->set_parent(parent);
+		m->set_left(l);
+		m->set_right(r);
+		if (parent == NULL)
+			root_ = m;
+		else if (parent->left() == n)
+			parent->set_left(m);
+		else
+			parent->set_right(m);
+		if (l != NULL)
+			l->set_parent(m);
+		if (r != NULL)
+			r->set_parent(m);
+		if (find_cache_.enabled())
+			find_cache_.invalidate(n->key(), n);
+		if (n == leftmost_)
+			leftmost_ = m;
+		n->~RedBlackNode();
+		pool_.deallocate(n);
+		return m;
+	}
+
+	/**
+	 * Removes z from the tree, keeping the find cache, the compaction
+	 * cursor, the cached minimum and the Bloom filter in step.
+	 */
+	void erase_at(RedBlackNode<K, V> *z) {
+		if (find_cache_.enabled())
+			find_cache_.invalidate(z->key(), z);
+		if (z == compact_cursor_)
+			compact_cursor_ = prev_node(z);
+		// The minimum has no left child, so its successor is its right
+		// child (a red leaf, if any) or its parent: O(1), plus any
+		// tombstones stepped over.
+		if (z == leftmost_)
+			leftmost_ = first_live(next_node(z));
+		erase_node(z);
+		if (bloom_.enabled() && bloom_.erase(size_))
+			rebuild_bloom_filter();
+	}
+
+	/**
+	 * Turns z into a tombstone, keeping the same things in step as
+	 * erase_at(), and purges the tombstones once there are too many.
+	 */
+	void bury(RedBlackNode<K, V> *z) {
+		if (find_cache_.enabled())
+			find_cache_.invalidate(z->key(), z);
+		z->set_dead(true);
+		if (z == leftmost_)
+			leftmost_ = first_live(next_node(z));
+		--size_;
+		++dead_;
+		if (dead_ > max_dead_fraction_ * node_count())
+			purge_tombstones();
+		else if (bloom_.enabled() && bloom_.erase(size_))
+			rebuild_bloom_filter();
+	}
+
+	/**
+	 * Called by insert when key is already in n. Throws a tree_exception
+	 * unless n is a tombstone, which is brought back holding value.
+	 */
+	void revive(RedBlackNode<K, V> *n, const V &value) {
+		if (!n->dead())
+			throw_duplicate(n->key());
+		n->set_value(value);
+		n->set_dead(false);
+		--dead_;
+		++size_;
+		if (leftmost_ == NULL || n->key() < leftmost_->key())
+			leftmost_ = n;
+		if (bloom_.enabled() && bloom_.insert(n->key(), size_))
+			rebuild_bloom_filter();
+	}
+
+	/**
+	 * Joins l, k and r, where every key in l is less than k's and every key
+	 * in r greater, and returns the root of the result. l_height and
+	 * r_height are the black heights of l and r; l_height is updated to
+	 * that of the result. k is hung, red, on the right spine of l (or the
+	 * left spine of r), whichever is taller, at the black node whose black
+	 * height matches the shorter, and join_fixup() repairs the tree above
+	 * it: O(|l_height - r_height| + 1) amortized.
+	 */
+	RedBlackNode<K, V>* join(RedBlackNode<K, V> *l, int &l_height,
+			RedBlackNode<K, V> *k, RedBlackNode<K, V> *r, int r_height) {
+		if (l != NULL) {
+			l->set_parent(NULL);
+			if (l->color() == RED) {
+				recolor(l, BLACK);
+				++l_height;
+			}
+		}
+		if (r != NULL) {
+			r->set_parent(NULL);
+			if (r->color() == RED) {
+				recolor(r, BLACK);
+				++r_height;
+			}
+		}
+		recolor(k, RED);
+		if (l_height == r_height) {
+			link(k, l, r, NULL);
+			return k;
+		}
+		bool into_left = l_height > r_height;
+		RedBlackNode<K, V> *top = into_left ? l : r, *parent = NULL,
+				*c = top;
+		int height = into_left ? l_height : r_height;
+		int target = into_left ? r_height : l_height;
+		l_height = height;
+		while (c != NULL && (c->color() == RED || height != target)) {
+			height -= is_black(c);
+			parent = c;
+			c = into_left ? c->right() : c->left();
+		}
+		if (into_left) {
+			link(k, c, r, parent);
+			parent->set_right(k);
+		} else {
+			link(k, l, c, parent);
+			parent->set_left(k);
+		}
+		// The rotations below update root_ when they reach the top.
+		RedBlackNode<K, V> *saved_root = root_;
+		root_ = top;
+		if (join_fixup(k))
+			++l_height;
+		top = root_;
+		root_ = saved_root;
+		return top;
+	}
+
+	/**
+	 * RB-INSERT-FIXUP from p. 316 of CLRS, for the tree rooted at root_ and
+	 * a red node z whose parent may be red. Returns true if it ended by
+	 * blackening a red root, which adds one to the black height.
+	 */
+	bool join_fixup(RedBlackNode<K, V> *z) {
+		while (z->parent() != NULL && z->parent()->color() == RED) {
+			RedBlackNode<K, V> *p = z->parent(), *g = p->parent();
+			bool left = p == g->left();
+			RedBlackNode<K, V> *uncle = left ? g->right() : g->left();
+			if (uncle != NULL && uncle->color() == RED) {
+				recolor(p, BLACK);
+				recolor(uncle, BLACK);
+				recolor(g, RED);
+				z = g;
+				continue;
+			}
+			if (z == (left ? p->right() : p->left())) {
+				z = p;
+				if (left)
+					left_rotate(z);
+				else
+					right_rotate(z);
+				p = z->parent();
+			}
+			recolor(p, BLACK);
+			recolor(g, RED);
+			if (left)
+				right_rotate(g);
+			else
+				left_rotate(g);
+		}
+		if (root_->color() == RED) {
+			recolor(root_, BLACK);
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Makes l and r the children of k and parent its parent.
+	 */
+	static void link(RedBlackNode<K, V> *k, RedBlackNode<K, V> *l,
+			RedBlackNode<K, V> *r, RedBlackNode<K, V> *parent) {
+		k->set_parent(parent);
+		k->set_left(l);
+		k->set_right(r);
+		if (l != NULL)
+			l->set_parent(k);
+		if (r != NULL)
+			r->set_parent(k);
+	}
+
+	/**
+	 * Frees the storage the nodes have left and forgets the compaction.
+	 */
+	void end_compaction() {
+		compact_pool_.release();
+		compacting_ = false;
+		compact_cursor_ = NULL;
+	}
+
+	inline size_t node_count() const {
+		return size_ + dead_;
+	}
+
+	static RedBlackNode<K, V>* leftmost(RedBlackNode<K, V> *n) {
+		if (n != NULL)
+			while (n->left() != NULL)
+				n = n->left();
+		return n;
+	}
+
+	/**
+	 * Returns n, or the first node after it that is not a tombstone, or
+	 * NULL.
+	 */
+	static RedBlackNode<K, V>* first_live(RedBlackNode<K, V> *n) {
+		while (n != NULL && n->dead())
+			n = next_node(n);
+		return n;
+	}
+
+	/**
+	 * Returns the in-order successor of n, or NULL.
+	 */
+	static RedBlackNode<K, V>* next_node(RedBlackNode<K, V> *n) {
+		if (n->right() != NULL)
+			return leftmost(n->right());
+		RedBlackNode<K, V> *p = n->parent();
+		while (p != NULL && n == p->right()) {
+			n = p;
+			p = p->parent();
+		}
+		return p;
+	}
+
+	/**
+	 * Returns the in-order predecessor of n, or NULL.
+	 */
+	static RedBlackNode<K, V>* prev_node(RedBlackNode<K, V> *n) {
+		if (n->left() != NULL) {
+			n = n->left();
+			while (n->right() != NULL)
+				n = n->right();
+			return n;
+		}
+		RedBlackNode<K, V> *p = n->parent();
+		while (p != NULL && n == p->left()) {
+			n = p;
+			p = p->parent();
+		}
+		return p;
+	}
+
+	/**
+	 * Destroys a node and returns its storage to the pool.
+	 */
+	void free_node(Node<K, V> *n) {
+		RBTREE_COUNT(deallocations, 1);
+		++epoch_;
+		n->~Node();
+		if (compacting_ && compact_pool_.owns(n))
+			compact_pool_.deallocate(n);
+		else
+			pool_.deallocate(n);
+	}
+
+	/**
+	 * Copies the subtree rooted at n, colors included, into consecutive
+	 * nodes starting at out, in preorder. out is advanced past each node
+	 * once it has been constructed, so after an exception [start, out) are
+	 * exactly the nodes that need destroying.
+	 */
+	static RedBlackNode<K, V>* copy_into(const RedBlackNode<K, V> *n,
+			RedBlackNode<K, V> *parent, RedBlackNode<K, V> *&out) {
+		if (n == NULL)
+			return NULL;
+		RedBlackNode<K, V> *copy = new (out) RedBlackNode<K, V>(n->key(),
+				n->value());
+		++out;
+		copy->set_color(n->color());
+		copy->set_dead(n->dead());
+		copy->set_parent(parent);
+		copy->set_left(copy_into(n->left(), copy, out));
+		copy->set_right(copy_into(n->right(), copy, out));
+		return copy;
+	}
+
+	/**
+	 * Builds a subtree from the next n pairs at it, which is advanced past
+	 * them, constructing its nodes in key order at out. The middle pair
+	 * becomes the root, so the nodes at red_depth, the only level that may
+	 * be partly filled, are leaves and are colored red.
+	 */
+	template<typename Iterator>
+	static RedBlackNode<K, V>* build_balanced(Iterator &it, size_t n,
+			RedBlackNode<K, V> *parent, int depth, int red_depth,
+			RedBlackNode<K, V> *&out) {
+		if (n == 0)
+			return NULL;
+		size_t left_count = (n - 1) / 2;
+		RedBlackNode<K, V> *left = build_balanced(it, left_count, NULL,
+				depth + 1, red_depth, out);
+		RedBlackNode<K, V> *node = new (out) RedBlackNode<K, V>(it->first,
+				it->second);
+		++out;
+		++it;
+		node->set_color(depth == red_depth ? RED : BLACK);
+		node->set_parent(parent);
+		node->set_left(left);
+		if (left != NULL)
+			left->set_parent(node);
+		node->set_right(build_balanced(it, n - 1 - left_count, node,
+				depth + 1, red_depth, out));
+		return node;
+	}
+
+	/**
+	 * Like build_balanced(), but takes the next n nodes of a list linked
+	 * through their right pointers, advancing list past them, and relinks
+	 * them in place.
+	 */
+	static RedBlackNode<K, V>* relink_balanced(RedBlackNode<K, V> *&list,
+			size_t n, RedBlackNode<K, V> *parent, int depth, int red_depth) {
+		if (n == 0)
+			return NULL;
+		size_t left_count = (n - 1) / 2;
+		RedBlackNode<K, V> *left = relink_balanced(list, left_count, NULL,
+				depth + 1, red_depth);
+		RedBlackNode<K, V> *node = list;
+		list = list->right();
+		node->set_color(depth == red_depth ? RED : BLACK);
+		node->set_parent(parent);
+		node->set_left(left);
+		if (left != NULL)
+			left->set_parent(node);
+		node->set_right(relink_balanced(list, n - 1 - left_count, node,
+				depth + 1, red_depth));
+		return node;
+	}
+
+	/**
+	 * Destroys the constructed nodes in [first, last).
+	 */
+	static void destroy_nodes(RedBlackNode<K, V> *first,
+			RedBlackNode<K, V> *last) {
+		for (; first != last; ++first)
+			first->~RedBlackNode();
+	}
+
+	/**
+	 * Returns the number of nodes in the subtree rooted at n.
+	 */
+	static size_t count_nodes(const Node<K, V> *n) {
+		return n == NULL ?
+				0 : 1 + count_nodes(n->left()) + count_nodes(n->right());
+	}
+
+	/**
+	 * Collects, in preorder, the nodes above the given depth into top and
+	 * the non-null subtrees rooted at that depth into frontier.
+	 */
+	static void split_at_depth(const RedBlackNode<K, V> *n, int level,
+			int depth, std::vector<const RedBlackNode<K, V>*> &top,
+			std::vector<const RedBlackNode<K, V>*> &frontier) {
+		if (n == NULL)
+			return;
+		if (level == depth) {
+			frontier.push_back(n);
+			return;
+		}
+		top.push_back(n);
+		split_at_depth(n->left(), level + 1, depth, top, frontier);
+		split_at_depth(n->right(), level + 1, depth, top, frontier);
+	}
+
+	/**
+	 * Copies the nodes above depth into consecutive nodes at out, in the
+	 * same preorder as split_at_depth(). A child at depth is linked to the
+	 * slot its subtree will be copied to, block + offsets[next], before that
+	 * subtree exists, and its parent's copy is recorded in parents[next].
+	 */
+	static RedBlackNode<K, V>* copy_top(const RedBlackNode<K, V> *n,
+			RedBlackNode<K, V> *parent, int level, int depth,
+			RedBlackNode<K, V> *&out, RedBlackNode<K, V> *block,
+			const std::vector<size_t> &offsets,
+			std::vector<RedBlackNode<K, V>*> &parents, size_t &next) {
+		if (n == NULL)
+			return NULL;
+		if (level == depth) {
+			parents[next] = parent;
+			return block + offsets[next++];
+		}
+		RedBlackNode<K, V> *copy = new (out) RedBlackNode<K, V>(n->key(),
+				n->value());
+		++out;
+		copy->set_color(n->color());
+		copy->set_dead(n->dead());
+		copy->set_parent(parent);
+		copy->set_left(copy_top(n->left(), copy, level + 1, depth, out,
+				block, offsets, parents, next));
+		copy->set_right(copy_top(n->right(), copy, level + 1, depth, out,
+				block, offsets, parents, next));
+		return copy;
+	}
+
+	/**
+	 * A piece of the tree for parallel_for_each() and parallel_reduce(): a
+	 * whole subtree, or a single node above the cut.
+	 */
+	struct Piece {
+		const RedBlackNode<K, V> *node;
+		bool whole;
+
+		Piece(const RedBlackNode<K, V> *n, bool w) :
+				node(n), whole(w) {
+		}
+	};
+
+	/**
+	 * Holds one piece's partial result in its own object, where a
+	 * std::vector<bool> would pack neighbours into one word.
+	 */
+	template<typename T>
+	struct Partial {
+		T value;
+
+		explicit Partial(const T &v) :
+				value(v) {
+		}
+	};
+
+	/**
+	 * Cuts the tree into pieces in key order, with about four subtrees per
+	 * thread, and returns the number of threads to use. A small tree is
+	 * one piece, for one thread.
+	 */
+	unsigned cut_in_order(unsigned threads, std::vector<Piece> &pieces) const {
+		threads = resolve_thread_count(threads);
+		if (threads == 1 || node_count() < PARALLEL_CLONE_MIN) {
+			if (root_ != NULL)
+				pieces.push_back(Piece(root_, true));
+			return 1;
+		}
+		int depth = 1;
+		while ((1u << depth) < 4 * threads)
+			++depth;
+		cut_in_order(root_, 0, depth, pieces);
+		return threads;
+	}
+
+	static void cut_in_order(const RedBlackNode<K, V> *n, int level,
+			int depth, std::vector<Piece> &pieces) {
+		if (n == NULL)
+			return;
+		if (level == depth) {
+			pieces.push_back(Piece(n, true));
+			return;
+		}
+		cut_in_order(n->left(), level + 1, depth, pieces);
+		pieces.push_back(Piece(n, false));
+		cut_in_order(n->right(), level + 1, depth, pieces);
+	}
+
+	/**
+	 * Calls fn on the live pairs of the subtree rooted at n, in key order.
+	 */
+	template<typename F>
+	static void visit_in_order(const RedBlackNode<K, V> *n, F &fn) {
+		for (; n != NULL; n = n->right()) {
+			visit_in_order(n->left(), fn);
+			if (!n->dead())
+				fn(n->key(), n->value());
+		}
+	}
+
+	/**
+	 * Task for parallel_for_each(): visits piece i.
+	 */
+	template<typename F>
+	struct PieceVisitor {
+		const std::vector<Piece> &pieces;
+		F &fn;
+
+		PieceVisitor(const std::vector<Piece> &p, F &f) :
+				pieces(p), fn(f) {
+		}
+
+		void operator()(size_t i) const {
+			const RedBlackNode<K, V> *n = pieces[i].node;
+			if (pieces[i].whole)
+				visit_in_order(n, fn);
+			else if (!n->dead())
+				fn(n->key(), n->value());
+		}
+	};
+
+	/**
+	 * Task for parallel_reduce(): folds piece i into partials[i].
+	 */
+	template<typename T, typename Map, typename Combine>
+	struct PieceReducer {
+		const std::vector<Piece> &pieces;
+		std::vector<Partial<T> > &partials;
+		Map &map;
+		Combine &combine;
+
+		PieceReducer(const std::vector<Piece> &p,
+				std::vector<Partial<T> > &r, Map &m, Combine &c) :
+				pieces(p), partials(r), map(m), combine(c) {
+		}
+
+		/**
+		 * Adds one pair to the running result.
+		 */
+		struct Fold {
+			T &result;
+			Map &map;
+			Combine &combine;
+
+			void operator()(const K &key, const V &value) const {
+				result = combine(result, map(key, value));
+			}
+		};
+
+		void operator()(size_t i) const {
+			T result = partials[i].value;
+			Fold fold = { result, map, combine };
+			const RedBlackNode<K, V> *n = pieces[i].node;
+			if (pieces[i].whole)
+				visit_in_order(n, fold);
+			else if (!n->dead())
+				fold(n->key(), n->value());
+			partials[i].value = result;
+		}
+	};
+
+	/**
+	 * Task for clone_parallel(): counts the nodes of frontier subtree i.
+	 */
+	struct SubtreeCounter {
+		const std::vector<const RedBlackNode<K, V>*> &frontier;
+		std::vector<size_t> &sizes;
+
+		SubtreeCounter(const std::vector<const RedBlackNode<K, V>*> &f,
+				std::vector<size_t> &s) :
+				frontier(f), sizes(s) {
+		}
+
+		void operator()(size_t i) const {
+			sizes[i + 1] = count_nodes(frontier[i]);
+		}
+	};
+
+	/**
+	 * Task for clone_parallel(): copies frontier subtree i to ends[i], which
+	 * copy_top() already linked to parents[i]. ends[i] is advanced as nodes
+	 * are constructed.
+	 */
+	struct SubtreeCopier {
+		const std::vector<const RedBlackNode<K, V>*> &frontier;
+		const std::vector<RedBlackNode<K, V>*> &parents;
+		std::vector<RedBlackNode<K, V>*> &ends;
+
+		SubtreeCopier(const std::vector<const RedBlackNode<K, V>*> &f,
+				const std::vector<RedBlackNode<K, V>*> &p,
+				std::vector<RedBlackNode<K, V>*> &e) :
+				frontier(f), parents(p), ends(e) {
+		}
+
+		void operator()(size_t i) const {
+			copy_into(frontier[i], parents[i], ends[i]);
+		}
+	};
+
 	/**
 	 * Implementation of insert fixup method described on p. 316 of CLRS.
 	 */
 	void insert_fixup(RedBlackNode<K, V> *z) {
 		RedBlackNode<K, V> *parent = z->parent();
 		if (parent == NULL) {
-			z->set_color(BLACK);
+			recolor(z, BLACK);
 			return;
 		}
 		if ((parent->color() == RED
@@ -419,7 +1986,7 @@ private:
 								&& parent->right()->color() == RED)))
 				|| root_->color() != BLACK) {
 			if (parent->parent() == NULL) {
-				root_->set_color(BLACK);
+				recolor(root_, BLACK);
 				return;
 			}
 
@@ -435,9 +2002,9 @@ private:
 			//Violation Case 1
 			//Here the node being inserted has a red uncle
 			if (uncle != NULL && uncle->color() == RED) {
-				parent->set_color(BLACK);
-				uncle->set_color(BLACK);
-				grandparent->set_color(RED);
+				recolor(parent, BLACK);
+				recolor(uncle, BLACK);
+				recolor(grandparent, RED);
 				z = grandparent;
 				insert_fixup(z);
 			}
@@ -454,8 +2021,8 @@ private:
 				else if ((uncle == NULL
 						|| (uncle != NULL && uncle->color() == BLACK))
 						&& parent->left() == z) {
-					parent->set_color(BLACK);
-					grandparent->set_color(RED);
+					recolor(parent, BLACK);
+					recolor(grandparent, RED);
 					right_rotate(grandparent);
 					insert_fixup(z);
 				}
@@ -471,8 +2038,8 @@ private:
 				}
 				//case 3b: z's uncle is black and z is a right child
 				else {
-					parent->set_color(BLACK);
-					grandparent->set_color(RED);
+					recolor(parent, BLACK);
+					recolor(grandparent, RED);
 					left_rotate(grandparent);
 					insert_fixup(z);
 				}
@@ -480,13 +2047,133 @@ private:
 		}
 		// Last line below
 		//last step, set root color to black
-		root_->set_color(BLACK);
+		recolor(root_, BLACK);
+	}
+
+	/**
+	 * Implementation of delete method described on p. 324 of CLRS, with
+	 * NULL leaves: x_parent tracks the parent of x, which may be NULL.
+	 */
+	void erase_node(RedBlackNode<K, V> *z) {
+		RedBlackNode<K, V> *y = z, *x, *x_parent;
+		unsigned char y_original_color = y->color();
+		if (z->left() == NULL) {
+			x = z->right();
+			x_parent = z->parent();
+			transplant(z, z->right());
+		} else if (z->right() == NULL) {
+			x = z->left();
+			x_parent = z->parent();
+			transplant(z, z->left());
+		} else {
+			y = z->right();
+			while (y->left() != NULL)
+				y = y->left();
+			y_original_color = y->color();
+			x = y->right();
+			if (y->parent() == z) {
+				x_parent = y;
+			} else {
+				x_parent = y->parent();
+				transplant(y, y->right());
+				y->set_right(z->right());
+				y->right()->set_parent(y);
+			}
+			transplant(z, y);
+			y->set_left(z->left());
+			y->left()->set_parent(y);
+			recolor(y, z->color());
+		}
+		if (y_original_color == BLACK)
+			erase_fixup(x, x_parent);
+		free_node(z);
+		size_--;
+	}
+
+	/**
+	 * Implementation of transplant method described on p. 323 of CLRS.
+	 */
+	void transplant(RedBlackNode<K, V> *u, RedBlackNode<K, V> *v) {
+		if (u->parent() == NULL)
+			root_ = v;
+		else if (u == u->parent()->left())
+			u->parent()->set_left(v);
+		else
+			u->parent()->set_right(v);
+		if (v != NULL)
+			v->set_parent(u->parent());
+	}
+
+	static inline bool is_black(const RedBlackNode<K, V> *n) {
+		return n == NULL || n->color() == BLACK;
+	}
+
+	/**
+	 * Implementation of delete fixup method described on p. 326 of CLRS.
+	 */
+	void erase_fixup(RedBlackNode<K, V> *x, RedBlackNode<K, V> *x_parent) {
+		while (x != root_ && is_black(x)) {
+			if (x == x_parent->left()) {
+				RedBlackNode<K, V> *w = x_parent->right();
+				if (w->color() == RED) {
+					recolor(w, BLACK);
+					recolor(x_parent, RED);
+					left_rotate(x_parent);
+					w = x_parent->right();
+				}
+				if (is_black(w->left()) && is_black(w->right())) {
+					recolor(w, RED);
+					x = x_parent;
+					x_parent = x->parent();
+				} else {
+					if (is_black(w->right())) {
+						recolor(w->left(), BLACK);
+						recolor(w, RED);
+						right_rotate(w);
+						w = x_parent->right();
+					}
+					recolor(w, x_parent->color());
+					recolor(x_parent, BLACK);
+					recolor(w->right(), BLACK);
+					left_rotate(x_parent);
+					x = root_;
+				}
+			} else {
+				RedBlackNode<K, V> *w = x_parent->left();
+				if (w->color() == RED) {
+					recolor(w, BLACK);
+					recolor(x_parent, RED);
+					right_rotate(x_parent);
+					w = x_parent->left();
+				}
+				if (is_black(w->left()) && is_black(w->right())) {
+					recolor(w, RED);
+					x = x_parent;
+					x_parent = x->parent();
+				} else {
+					if (is_black(w->left())) {
+						recolor(w->right(), BLACK);
+						recolor(w, RED);
+						left_rotate(w);
+						w = x_parent->left();
+					}
+					recolor(w, x_parent->color());
+					recolor(x_parent, BLACK);
+					recolor(w->left(), BLACK);
+					right_rotate(x_parent);
+					x = root_;
+				}
+			}
+		}
+		if (x != NULL)
+			recolor(x, BLACK);
 	}
 
 	/**
 	 * Implementation of left-rotate method as described on p. 313 of CLRS.
 	 */
 	void left_rotate(Node<K, V> *x) {
+		RBTREE_COUNT(rotations, 1);
 		RedBlackNode<K, V> *y = static_cast<RedBlackNode<K, V>*>(x->right());
 		x->set_right(y->left());
 		if (y->left() != NULL)
@@ -506,6 +2193,7 @@ private:
 	 * Implementation of right-rotate method as described on p. 313 of CLRS.
 	 */
 	void right_rotate(Node<K, V> *x) {
+		RBTREE_COUNT(rotations, 1);
 		RedBlackNode<K, V> *y = static_cast<RedBlackNode<K, V>*>(x->left());
 		x->set_left(y->right());
 		if (y->right() != NULL)
@@ -597,6 +2285,17 @@ private:
 					+ widthHelper(node->right(), level - 1);
 	}
 
+	static void count_levels(const Node<K, V> *node, size_t level,
+			std::vector<size_t> &widths) {
+		if (node == NULL)
+			return;
+		if (widths.size() <= level)
+			widths.push_back(0);
+		++widths[level];
+		count_levels(node->left(), level + 1, widths);
+		count_levels(node->right(), level + 1, widths);
+	}
+
 	/**
 	 * Helper function called by width.
 	 */
@@ -670,6 +2369,42 @@ private:
 		return sum_null_levels(node->left(), level + 1)
 				+ sum_null_levels(node->right(), level + 1);
 	}
+
+	/**
+	 * The walk behind valid(). Returns the black height of the subtree at
+	 * n, counting the NULL leaves, or -1 if a rule is broken in it. Visits
+	 * the nodes in order, counting the live and dead ones and keeping the
+	 * first live node and the last node visited.
+	 */
+	static int black_height(const RedBlackNode<K, V> *n, size_t &live,
+			size_t &dead, const RedBlackNode<K, V> *&first,
+			const RedBlackNode<K, V> *&last) {
+		if (n == NULL)
+			return 1;
+		const RedBlackNode<K, V> *l = n->left(), *r = n->right();
+		if ((l != NULL && l->parent() != n) || (r != NULL && r->parent() != n)
+				|| (n->color() == RED && !(is_black(l) && is_black(r))))
+			return -1;
+		int lh = black_height(l, live, dead, first, last);
+		if (lh < 0 || (last != NULL && !(last->key() < n->key())))
+			return -1;
+		last = n;
+		if (n->dead())
+			++dead;
+		else if (live++ == 0)
+			first = n;
+		if (black_height(r, live, dead, first, last) != lh)
+			return -1;
+		return lh + (n->color() == BLACK);
+	}
 };
 
+/**
+ * Exchanges the contents of two red-black trees in O(1).
+ */
+template<typename K, typename V>
+inline void swap(RedBlackTree<K, V> &a, RedBlackTree<K, V> &b) {
+	a.swap(b);
+}
+
 #endif /* RBTREE_H_ */
@@ -0,0 +1,356 @@
+/*******************************************************************************
+ * Name        : shardedtree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Concurrent map that splits the key space into ranges, each
+ *               held by its own RedBlackTree behind its own lock, so threads
+ *               working on different ranges do not contend. Keys stay in
+ *               order across shards, so iteration is still sorted.
+ ******************************************************************************/
+#ifndef SHARDEDTREE_H_
+#define SHARDEDTREE_H_
+
+#include "rbtree.h"
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+template<typename K, typename V>
+class ShardedRedBlackTree;
+
+/**
+ * Walks the shards in order, and each shard's tree in order. Not safe while
+ * another thread writes; ShardedRedBlackTree::for_each() is.
+ */
+template<typename K, typename V>
+class ShardedTreeIterator {
+public:
+	ShardedTreeIterator() :
+			tree_(NULL), shard_(0) {
+	}
+
+	bool operator==(const ShardedTreeIterator &rhs) const {
+		return shard_ == rhs.shard_ && (it_ == rhs.it_);
+	}
+
+	bool operator!=(const ShardedTreeIterator &rhs) const {
+		return !(*this == rhs);
+	}
+
+	std::pair<K, V> operator*() const {
+		return *it_;
+	}
+
+	std::pair<K, V>* operator->() const {
+		return it_.operator->();
+	}
+
+	ShardedTreeIterator& operator++() {
+		++it_;
+		skip_empty();
+		return *this;
+	}
+
+	ShardedTreeIterator operator++(int) {
+		ShardedTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	typedef typename RedBlackTree<K, V>::iterator tree_iterator;
+
+	ShardedRedBlackTree<K, V> *tree_;
+	size_t shard_;
+	tree_iterator it_;
+	friend class ShardedRedBlackTree<K, V> ;
+
+	ShardedTreeIterator(ShardedRedBlackTree<K, V> *tree, size_t shard,
+			tree_iterator it) :
+			tree_(tree), shard_(shard), it_(it) {
+		skip_empty();
+	}
+
+	/**
+	 * Moves past the end of each shard to the start of the next, leaving
+	 * end() as shard count with a null tree iterator.
+	 */
+	void skip_empty() {
+		while (shard_ < tree_->shards_.size()
+				&& it_ == tree_->shards_[shard_]->tree.end()) {
+			if (++shard_ < tree_->shards_.size())
+				it_ = tree_->shards_[shard_]->tree.begin();
+			else
+				it_ = tree_iterator();
+		}
+	}
+};
+
+/**
+ * Shard i holds the keys in [splits[i - 1], splits[i]); the first and last
+ * shards are open-ended. A key's shard is found by binary search over the
+ * splits, then the key is looked up in that shard's tree under that shard's
+ * mutex, so operations on different shards run in parallel. Splits can be
+ * chosen from a sample of the keys with choose_splits().
+ *
+ * The Tree statistics describe the shards as a forest. They are taken one
+ * shard at a time, each under its lock, so they are exact only when no
+ * thread is writing. Counts add up. Height and diameter are those of the
+ * tallest and widest shard. Widths add up level by level. Search costs are
+ * averaged over all keys (or all null links) and leave out the binary
+ * search over the splits.
+ */
+template<typename K, typename V>
+class ShardedRedBlackTree: public Tree {
+public:
+	typedef ShardedTreeIterator<K, V> iterator;
+
+	/**
+	 * Creates splits.size() + 1 empty shards. Throws a tree_exception if the
+	 * splits are not in strictly increasing order.
+	 */
+	explicit ShardedRedBlackTree(const std::vector<K> &splits) :
+			splits_(splits) {
+		for (size_t i = 1; i < splits_.size(); ++i) {
+			if (!(splits_[i - 1] < splits_[i])) {
+				std::stringstream ss;
+				ss << splits_[i];
+				throw tree_exception("ShardedRedBlackTree: split '" + ss.str()
+						+ "' is out of order.");
+			}
+		}
+		shards_.reserve(splits_.size() + 1);
+		try {
+			for (size_t i = 0; i <= splits_.size(); ++i)
+				shards_.push_back(new Shard());
+		} catch (...) {
+			release();
+			throw;
+		}
+	}
+
+	~ShardedRedBlackTree() {
+		release();
+	}
+
+	/**
+	 * Returns up to shards - 1 splits that divide sample into ranges of
+	 * about the same number of keys.
+	 */
+	static std::vector<K> choose_splits(std::vector<K> sample,
+			size_t shards) {
+		std::sort(sample.begin(), sample.end());
+		std::vector<K> splits;
+		for (size_t i = 1; i < shards && !sample.empty(); ++i) {
+			const K &split = sample[i * sample.size() / shards];
+			if (splits.empty() || splits.back() < split)
+				splits.push_back(split);
+		}
+		return splits;
+	}
+
+	/**
+	 * Inserts a key-value pair. Throws a tree_exception on a duplicate key.
+	 */
+	void insert(const K &key, const V &value) {
+		Shard &s = shard_for(key);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.tree.insert(key, value);
+	}
+
+	/**
+	 * Copies the value stored under key to value. Returns false if key is
+	 * not present.
+	 */
+	bool find(const K &key, V &value) {
+		Shard &s = shard_for(key);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		typename RedBlackTree<K, V>::iterator it = s.tree.find(key);
+		if (it == s.tree.end())
+			return false;
+		value = it->second;
+		return true;
+	}
+
+	bool contains(const K &key) {
+		Shard &s = shard_for(key);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		return s.tree.find(key) != s.tree.end();
+	}
+
+	/**
+	 * Removes key, returning false if it was not present.
+	 */
+	bool erase(const K &key) {
+		Shard &s = shard_for(key);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		return s.tree.erase(key);
+	}
+
+	/**
+	 * Calls f(key, value) for every pair in key order, holding each shard's
+	 * lock while visiting it. Each shard is seen as of one moment, but
+	 * different shards may be seen at different moments.
+	 */
+	template<typename F>
+	void for_each(F f) {
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			RedBlackTree<K, V> &tree = shards_[i]->tree;
+			for (typename RedBlackTree<K, V>::iterator it = tree.begin();
+					it != tree.end(); ++it)
+				f(it->first, it->second);
+		}
+	}
+
+	iterator begin() {
+		return iterator(this, 0, shards_[0]->tree.begin());
+	}
+
+	iterator end() {
+		return iterator(this, shards_.size(),
+				typename RedBlackTree<K, V>::iterator());
+	}
+
+	size_t shard_count() const {
+		return shards_.size();
+	}
+
+	/**
+	 * Returns the number of keys in shard i.
+	 */
+	size_t shard_size(size_t i) const {
+		std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+		return shards_[i]->tree.size();
+	}
+
+	/**
+	 * Returns the ASCII drawing of each non-empty shard, one after another.
+	 */
+	std::string to_ascii_drawing() {
+		std::string drawing;
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			if (shards_[i]->tree.size() == 0)
+				continue;
+			if (!drawing.empty())
+				drawing += "\n\n";
+			drawing += shards_[i]->tree.to_ascii_drawing();
+		}
+		return drawing.empty() ? "Root is null." : drawing;
+	}
+
+	int height() const {
+		int height = -1;
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			height = std::max(height, shards_[i]->tree.height());
+		}
+		return height;
+	}
+
+	size_t size() const {
+		return sum(&RedBlackTree<K, V>::size);
+	}
+
+	size_t leaf_count() const {
+		return sum(&RedBlackTree<K, V>::leaf_count);
+	}
+
+	size_t internal_node_count() const {
+		return sum(&RedBlackTree<K, V>::internal_node_count);
+	}
+
+	size_t diameter() const {
+		size_t diameter = 0;
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			diameter = std::max(diameter, shards_[i]->tree.diameter());
+		}
+		return diameter;
+	}
+
+	size_t max_width() const {
+		std::vector<size_t> widths;
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			std::vector<size_t> w = shards_[i]->tree.level_widths();
+			if (widths.size() < w.size())
+				widths.resize(w.size());
+			for (size_t j = 0; j < w.size(); ++j)
+				widths[j] += w[j];
+		}
+		return widths.empty() ? 0 : *std::max_element(widths.begin(),
+				widths.end());
+	}
+
+	double successful_search_cost() const {
+		double total = 0;
+		size_t keys = 0;
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			size_t n = shards_[i]->tree.size();
+			total += n * shards_[i]->tree.successful_search_cost();
+			keys += n;
+		}
+		return keys == 0 ? 0 : total / keys;
+	}
+
+	double unsuccessful_search_cost() const {
+		double total = 0;
+		size_t links = 0;
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			size_t n = shards_[i]->tree.size();
+			if (n == 0)
+				continue;
+			total += (n + 1) * shards_[i]->tree.unsuccessful_search_cost();
+			links += n + 1;
+		}
+		return links == 0 ? 0 : total / links;
+	}
+
+private:
+	/**
+	 * The padding keeps the locks of shards allocated next to each other
+	 * off the same cache line.
+	 */
+	struct Shard {
+		mutable std::mutex mutex;
+		RedBlackTree<K, V> tree;
+		char padding[64];
+	};
+
+	std::vector<K> splits_;
+	std::vector<Shard*> shards_;
+	friend class ShardedTreeIterator<K, V> ;
+
+	ShardedRedBlackTree(const ShardedRedBlackTree &);
+	ShardedRedBlackTree& operator=(const ShardedRedBlackTree &);
+
+	inline Shard& shard_for(const K &key) {
+		return *shards_[std::upper_bound(splits_.begin(), splits_.end(), key)
+				- splits_.begin()];
+	}
+
+	size_t sum(size_t (RedBlackTree<K, V>::*count)() const) const {
+		size_t total = 0;
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+			total += (shards_[i]->tree.*count)();
+		}
+		return total;
+	}
+
+	void release() {
+		for (size_t i = 0; i < shards_.size(); ++i)
+			delete shards_[i];
+		shards_.clear();
+	}
+};
+
+#endif /* SHARDEDTREE_H_ */
@@ -0,0 +1,433 @@
+/*******************************************************************************
+ * Name        : splittree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Red-black tree that keeps keys and values apart. Nodes hold
+ *               the key, the links and a 32-bit handle; values live in a
+ *               separate slab. A descent only touches nodes, so with large
+ *               values it reads a fraction of the cache lines, and the value
+ *               is fetched once when the key is found.
+ ******************************************************************************/
+#ifndef SPLITTREE_H_
+#define SPLITTREE_H_
+
+#include "intrusivetree.h"
+#include "nodepool.h"
+#include "rbtree.h"
+#include "tree.h"
+#include "treestats.h"
+#include <new>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Store for values addressed by 32-bit handles. Values are placed in chunks
+ * of CHUNK slots that never move, so references stay valid as the slab
+ * grows; freed handles are reused first.
+ */
+template<typename V>
+class ValueSlab {
+public:
+	ValueSlab() :
+			used_(0) {
+	}
+
+	~ValueSlab() {
+		// Every live value must have been released by the owner.
+		for (size_t i = 0; i < chunks_.size(); ++i)
+			delete[] chunks_[i];
+	}
+
+	/**
+	 * Copies value into a free slot and returns its handle.
+	 */
+	uint32_t allocate(const V &value) {
+		bool reuse = !free_.empty();
+		uint32_t h = reuse ? free_.back() : grow();
+		new (slot(h)) V(value);
+		if (reuse)
+			free_.pop_back();
+		else
+			++used_;
+		return h;
+	}
+
+	/**
+	 * Destroys the value with handle h and makes h available again. Does
+	 * not throw: grow() reserved room in free_ for every handle.
+	 */
+	void deallocate(uint32_t h) {
+		(*this)[h].~V();
+		free_.push_back(h);
+	}
+
+	inline V& operator[](uint32_t h) {
+		return *reinterpret_cast<V*>(slot(h));
+	}
+
+	inline const V& operator[](uint32_t h) const {
+		return *reinterpret_cast<const V*>(
+				chunks_[h >> CHUNK_BITS][h & (CHUNK - 1)].storage);
+	}
+
+	/**
+	 * Returns the bytes held by the slab.
+	 */
+	size_t capacity_bytes() const {
+		return chunks_.size() * CHUNK * sizeof(Slot);
+	}
+
+private:
+	static const unsigned CHUNK_BITS = 10;
+	static const uint32_t CHUNK = 1u << CHUNK_BITS;
+
+	struct Slot {
+		alignas(V) unsigned char storage[sizeof(V)];
+	};
+
+	std::vector<Slot*> chunks_;
+	std::vector<uint32_t> free_;
+	uint32_t used_;
+
+	// Values are owned by exactly one slab.
+	ValueSlab(const ValueSlab &);
+	ValueSlab& operator=(const ValueSlab &);
+
+	/**
+	 * Returns the first never-used handle, adding a chunk if it needs one.
+	 */
+	uint32_t grow() {
+		if (used_ == UINT32_MAX)
+			throw tree_exception("ValueSlab: too many values.");
+		if ((used_ >> CHUNK_BITS) == chunks_.size()) {
+			// free_ must never need to grow in deallocate(), which runs
+			// from the tree's destructor.
+			size_t handles = (chunks_.size() + 1) * CHUNK;
+			if (free_.capacity() < handles)
+				free_.reserve(2 * handles);
+			Slot *chunk = new Slot[CHUNK];
+			try {
+				chunks_.push_back(chunk);
+			} catch (...) {
+				delete[] chunk;
+				throw;
+			}
+		}
+		return used_;
+	}
+
+	inline void* slot(uint32_t h) {
+		return chunks_[h >> CHUNK_BITS][h & (CHUNK - 1)].storage;
+	}
+};
+
+template<typename K, typename V>
+class SplitRedBlackTree;
+
+/**
+ * A node of SplitRedBlackTree: the key, the handle of its value and the
+ * tree links. Its size does not depend on V.
+ */
+template<typename K>
+class SplitNode {
+public:
+	SplitNode(const K &key, uint32_t value) :
+			key_(key), value_(value) {
+	}
+
+	inline const K& key() const {
+		return key_;
+	}
+
+	inline uint32_t value_handle() const {
+		return value_;
+	}
+
+private:
+	K key_;
+	uint32_t value_;
+	RedBlackHook<SplitNode> hook_;
+
+	template<typename, typename > friend class SplitRedBlackTree;
+};
+
+template<typename K, typename V>
+class SplitTreeIterator {
+public:
+	SplitTreeIterator() :
+			node_(NULL), tree_(NULL) {
+	}
+
+	bool operator==(const SplitTreeIterator &rhs) const {
+		return node_ == rhs.node_;
+	}
+
+	bool operator!=(const SplitTreeIterator &rhs) const {
+		return node_ != rhs.node_;
+	}
+
+	std::pair<K, V> operator*() const {
+		return std::pair<K, V>(key(), value());
+	}
+
+	const K& key() const {
+		return node_->key();
+	}
+
+	/**
+	 * Returns the value; this is the only access to the value slab.
+	 */
+	V& value() const {
+		return tree_->values_[node_->value_handle()];
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key.
+	 */
+	SplitTreeIterator& operator++() {
+		node_ = node_ == NULL ?
+				tree_->tree_.first() : tree_->tree_.next(node_);
+		return *this;
+	}
+
+	SplitTreeIterator operator++(int) {
+		SplitTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	SplitNode<K> *node_;
+	SplitRedBlackTree<K, V> *tree_;
+	friend class SplitRedBlackTree<K, V> ;
+
+	SplitTreeIterator(SplitNode<K> *node, SplitRedBlackTree<K, V> *t) :
+			node_(node), tree_(t) {
+	}
+};
+
+/**
+ * Red-black tree with the insert, find, iterator and statistics interface of
+ * RedBlackTree, plus erase, for values too large to keep in the nodes.
+ */
+template<typename K, typename V>
+class SplitRedBlackTree: public Tree {
+	typedef SplitNode<K> node_type;
+
+	struct KeyOf {
+		const K& operator()(const node_type &n) const {
+			return n.key_;
+		}
+	};
+
+	typedef IntrusiveRedBlackTree<node_type, K, &node_type::hook_, KeyOf>
+			tree_type;
+
+	/**
+	 * Accessor for treestats.h.
+	 */
+	struct Access {
+		typedef const node_type *node;
+		const ValueSlab<V> *values;
+
+		bool is_null(node n) const {
+			return n == NULL;
+		}
+
+		node left(node n) const {
+			return tree_type::left(n);
+		}
+
+		node right(node n) const {
+			return tree_type::right(n);
+		}
+
+		const K& key(node n) const {
+			return n->key_;
+		}
+
+		const V& value(node n) const {
+			return (*values)[n->value_];
+		}
+	};
+
+public:
+	typedef SplitTreeIterator<K, V> iterator;
+
+	SplitRedBlackTree() {
+	}
+
+	SplitRedBlackTree(std::vector<std::pair<K, V> > &elements) {
+		insert_elements(elements);
+	}
+
+	~SplitRedBlackTree() {
+		clear();
+	}
+
+	/**
+	 * Removes every key and value.
+	 */
+	void clear() {
+		tree_.clear_and_dispose(Disposer(*this));
+	}
+
+	/**
+	 * Inserts elements from the vector. Duplicate keys are not inserted.
+	 */
+	void insert_elements(std::vector<std::pair<K, V> > &elements) {
+		for (size_t i = 0, len = elements.size(); i < len; ++i) {
+			try {
+				insert(elements[i].first, elements[i].second);
+			} catch (const tree_exception &te) {
+				std::cerr << "Warning: " << te.what() << std::endl;
+			}
+		}
+	}
+
+	/**
+	 * Inserts a key-value pair. Throws a tree_exception on a duplicate key.
+	 */
+	void insert(const K &key, const V &value) {
+		node_type *x = tree_.root(), *y = NULL;
+		bool go_left = false;
+		while (x != NULL) {
+			y = x;
+			if (key < x->key_) {
+				go_left = true;
+				x = tree_type::left(x);
+			} else if (x->key_ < key) {
+				go_left = false;
+				x = tree_type::right(x);
+			} else {
+				std::ostringstream oss;
+				oss << "Attempt to insert duplicate key '" << key << "'.";
+				throw tree_exception(oss.str());
+			}
+		}
+		uint32_t h = values_.allocate(value);
+		void *p;
+		node_type *n;
+		try {
+			p = nodes_.allocate();
+		} catch (...) {
+			values_.deallocate(h);
+			throw;
+		}
+		try {
+			n = new (p) node_type(key, h);
+		} catch (...) {
+			nodes_.deallocate(p);
+			values_.deallocate(h);
+			throw;
+		}
+		tree_.link_leaf(n, y, go_left);
+	}
+
+	/**
+	 * Removes key and its value, returning false if it was not present.
+	 */
+	bool erase(const K &key) {
+		node_type *n = tree_.erase(key);
+		if (n == NULL)
+			return false;
+		Disposer(*this)(n);
+		return true;
+	}
+
+	/**
+	 * Searches for key. Only nodes are read until the key is found.
+	 */
+	iterator find(const K &key) {
+		return iterator(tree_.find(key), this);
+	}
+
+	iterator begin() {
+		return iterator(tree_.first(), this);
+	}
+
+	iterator end() {
+		return iterator(NULL, this);
+	}
+
+	/**
+	 * Returns the bytes reserved for nodes and for values.
+	 */
+	std::pair<size_t, size_t> memory_usage() const {
+		return std::make_pair(nodes_.capacity() * sizeof(node_type),
+				values_.capacity_bytes());
+	}
+
+	std::string to_ascii_drawing() {
+		return tree_ascii_drawing<K, V>(access(), tree_.root());
+	}
+
+	int height() const {
+		return tree_height(access(), tree_.root()) - 1;
+	}
+
+	size_t size() const {
+		return tree_.size();
+	}
+
+	size_t leaf_count() const {
+		return tree_leaf_count(access(), tree_.root());
+	}
+
+	size_t internal_node_count() const {
+		return tree_internal_node_count(access(), tree_.root());
+	}
+
+	size_t diameter() const {
+		return tree_diameter(access(), tree_.root());
+	}
+
+	size_t max_width() const {
+		return tree_max_width(access(), tree_.root());
+	}
+
+	double successful_search_cost() const {
+		return tree_successful_search_cost(access(), tree_.root(), size());
+	}
+
+	double unsuccessful_search_cost() const {
+		return tree_unsuccessful_search_cost(access(), tree_.root(), size());
+	}
+
+private:
+	// Declared before tree_ so that they outlive it.
+	ValueSlab<V> values_;
+	NodePool<node_type> nodes_;
+	tree_type tree_;
+	friend class SplitTreeIterator<K, V> ;
+
+	// Nodes and values are owned by the pools of exactly one tree.
+	SplitRedBlackTree(const SplitRedBlackTree &);
+	SplitRedBlackTree& operator=(const SplitRedBlackTree &);
+
+	struct Disposer {
+		SplitRedBlackTree &tree;
+
+		Disposer(SplitRedBlackTree &t) :
+				tree(t) {
+		}
+
+		void operator()(node_type *n) const {
+			tree.values_.deallocate(n->value_);
+			n->~node_type();
+			tree.nodes_.deallocate(n);
+		}
+	};
+
+	Access access() const {
+		Access a;
+		a.values = &values_;
+		return a;
+	}
+};
+
+#endif /* SPLITTREE_H_ */
@@ -0,0 +1,421 @@
+/*******************************************************************************
+ * Name        : stringtree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Red-black tree for std::string keys. Key bytes live in one
+ *               append-only arena shared by the whole tree, and each node
+ *               keeps the first 8 bytes of its key inline as a big-endian
+ *               integer, so most comparisons are a single integer compare
+ *               that never leaves the node.
+ ******************************************************************************/
+#ifndef STRINGTREE_H_
+#define STRINGTREE_H_
+
+#include "intrusivetree.h"
+#include "nodepool.h"
+#include "rbtree.h"
+#include "tree.h"
+#include "treestats.h"
+#include <cstring>
+#include <new>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Packs the first 8 bytes of a string, zero padded, into an integer whose
+ * order matches the byte order of memcmp.
+ */
+inline uint64_t string_key_prefix(const char *data, size_t length) {
+	uint64_t prefix = 0;
+	for (size_t i = 0; i < 8; ++i) {
+		prefix <<= 8;
+		if (i < length)
+			prefix |= static_cast<unsigned char>(data[i]);
+	}
+	return prefix;
+}
+
+/**
+ * A key as seen during comparison: the inline prefix plus where the full
+ * bytes are, which is only read when the prefixes tie.
+ */
+struct StringKeyView {
+	uint64_t prefix;
+	const char *data;
+	size_t length;
+
+	StringKeyView(uint64_t p, const char *d, size_t n) :
+			prefix(p), data(d), length(n) {
+	}
+
+	explicit StringKeyView(const std::string &s) :
+			prefix(string_key_prefix(s.data(), s.size())), data(s.data()),
+			length(s.size()) {
+	}
+};
+
+/**
+ * Three-way comparison with the same result as std::string::compare.
+ */
+inline int compare_string_keys(const StringKeyView &a, const StringKeyView &b) {
+	if (a.prefix != b.prefix)
+		return a.prefix < b.prefix ? -1 : 1;
+	// The first min(8, length) bytes are equal; compare the rest.
+	size_t n = a.length < b.length ? a.length : b.length;
+	if (n > 8) {
+		int c = std::memcmp(a.data + 8, b.data + 8, n - 8);
+		if (c != 0)
+			return c;
+	}
+	return a.length < b.length ? -1 : a.length > b.length ? 1 : 0;
+}
+
+struct StringKeyLess {
+	bool operator()(const StringKeyView &a, const StringKeyView &b) const {
+		return compare_string_keys(a, b) < 0;
+	}
+};
+
+/**
+ * Append-only byte store for keys, addressed by 32-bit offsets.
+ */
+class StringArena {
+public:
+	/**
+	 * Copies length bytes into the arena and returns their offset.
+	 */
+	uint32_t append(const char *data, size_t length) {
+		if (bytes_.size() + length > UINT32_MAX)
+			throw tree_exception("StringArena: key storage exceeds 4 GiB.");
+		uint32_t offset = static_cast<uint32_t>(bytes_.size());
+		bytes_.insert(bytes_.end(), data, data + length);
+		return offset;
+	}
+
+	inline const char* data(uint32_t offset) const {
+		return bytes_.empty() ? NULL : &bytes_[0] + offset;
+	}
+
+	size_t size() const {
+		return bytes_.size();
+	}
+
+	size_t capacity() const {
+		return bytes_.capacity();
+	}
+
+	void clear() {
+		bytes_.clear();
+	}
+
+private:
+	std::vector<char> bytes_;
+};
+
+template<typename V>
+class StringKeyTree;
+
+template<typename V>
+class StringKeyNode {
+public:
+	StringKeyNode(uint64_t prefix, uint32_t offset, uint32_t length,
+			const V &value) :
+			prefix_(prefix), offset_(offset), length_(length), value_(value) {
+	}
+
+	inline V& value() {
+		return value_;
+	}
+
+	inline const V& value() const {
+		return value_;
+	}
+
+private:
+	uint64_t prefix_;
+	uint32_t offset_;
+	uint32_t length_;
+	V value_;
+	RedBlackHook<StringKeyNode> hook_;
+
+	friend class StringKeyTree<V> ;
+};
+
+template<typename V>
+class StringKeyTreeIterator {
+public:
+	StringKeyTreeIterator() :
+			node_(NULL), tree_(NULL) {
+	}
+
+	bool operator==(const StringKeyTreeIterator &rhs) const {
+		return node_ == rhs.node_;
+	}
+
+	bool operator!=(const StringKeyTreeIterator &rhs) const {
+		return node_ != rhs.node_;
+	}
+
+	/**
+	 * Returns a copy of the key-value pair; the key is rebuilt from the
+	 * arena.
+	 */
+	std::pair<std::string, V> operator*() const {
+		return std::pair<std::string, V>(key(), node_->value());
+	}
+
+	std::string key() const {
+		return tree_->key_of(node_);
+	}
+
+	V& value() const {
+		return node_->value();
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key.
+	 */
+	StringKeyTreeIterator& operator++() {
+		node_ = node_ == NULL ?
+				tree_->tree_.first() : tree_->tree_.next(node_);
+		return *this;
+	}
+
+	StringKeyTreeIterator operator++(int) {
+		StringKeyTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	StringKeyNode<V> *node_;
+	const StringKeyTree<V> *tree_;
+	friend class StringKeyTree<V> ;
+
+	StringKeyTreeIterator(StringKeyNode<V> *node, const StringKeyTree<V> *t) :
+			node_(node), tree_(t) {
+	}
+};
+
+/**
+ * Drop-in alternative to RedBlackTree<std::string, V>. Nodes hold the key
+ * prefix, the key's offset and length in the arena, the value and an
+ * intrusive hook; no node owns a heap-allocated string.
+ */
+template<typename V>
+class StringKeyTree: public Tree {
+	typedef StringKeyNode<V> node_type;
+
+	/**
+	 * Builds the comparison view of a node's key.
+	 */
+	struct KeyOf {
+		const StringArena *arena;
+
+		KeyOf(const StringArena *a) :
+				arena(a) {
+		}
+
+		StringKeyView operator()(const node_type &n) const {
+			return StringKeyView(n.prefix_, arena->data(n.offset_),
+					n.length_);
+		}
+	};
+
+	typedef IntrusiveRedBlackTree<node_type, StringKeyView, &node_type::hook_,
+			KeyOf, StringKeyLess> tree_type;
+
+	/**
+	 * Accessor for treestats.h.
+	 */
+	struct Access {
+		typedef const node_type *node;
+		const StringKeyTree *tree;
+
+		bool is_null(node n) const {
+			return n == NULL;
+		}
+
+		node left(node n) const {
+			return tree_type::left(n);
+		}
+
+		node right(node n) const {
+			return tree_type::right(n);
+		}
+
+		std::string key(node n) const {
+			return tree->key_of(n);
+		}
+
+		const V& value(node n) const {
+			return n->value_;
+		}
+	};
+
+public:
+	typedef StringKeyTreeIterator<V> iterator;
+
+	StringKeyTree() :
+			tree_(KeyOf(&arena_)) {
+	}
+
+	~StringKeyTree() {
+		tree_.clear_and_dispose(Disposer(pool_));
+	}
+
+	/**
+	 * Inserts elements from the vector. Duplicate keys are not inserted.
+	 */
+	void insert_elements(std::vector<std::pair<std::string, V> > &elements) {
+		for (size_t i = 0, len = elements.size(); i < len; ++i) {
+			try {
+				insert(elements[i].first, elements[i].second);
+			} catch (const tree_exception &te) {
+				std::cerr << "Warning: " << te.what() << std::endl;
+			}
+		}
+	}
+
+	/**
+	 * Inserts a key-value pair. Throws a tree_exception on a duplicate key.
+	 * The key bytes are appended to the arena only once the key is known to
+	 * be new.
+	 */
+	void insert(const std::string &key, const V &value) {
+		if (key.size() > UINT32_MAX)
+			throw tree_exception("StringKeyTree: key too long.");
+		StringKeyView probe(key);
+		node_type *x = tree_.root(), *y = NULL;
+		bool go_left = false;
+		while (x != NULL) {
+			y = x;
+			int c = compare_string_keys(probe, view(x));
+			if (c == 0)
+				throw tree_exception("Attempt to insert duplicate key '" + key
+						+ "'.");
+			go_left = c < 0;
+			x = go_left ? tree_type::left(x) : tree_type::right(x);
+		}
+		void *p = pool_.allocate();
+		node_type *n;
+		try {
+			uint32_t offset = arena_.append(key.data(), key.size());
+			n = new (p) node_type(probe.prefix, offset,
+					static_cast<uint32_t>(key.size()), value);
+		} catch (...) {
+			pool_.deallocate(p);
+			throw;
+		}
+		tree_.link_leaf(n, y, go_left);
+	}
+
+	/**
+	 * Searches for key. If found, returns an iterator pointing at it;
+	 * otherwise, returns end().
+	 */
+	iterator find(const std::string &key) const {
+		StringKeyView probe(key);
+		node_type *x = tree_.root();
+		while (x != NULL) {
+			int c = compare_string_keys(probe, view(x));
+			if (c == 0)
+				break; // Found!
+			x = c < 0 ? tree_type::left(x) : tree_type::right(x);
+		}
+		return iterator(x, this);
+	}
+
+	iterator begin() const {
+		return iterator(tree_.first(), this);
+	}
+
+	iterator end() const {
+		return iterator(NULL, this);
+	}
+
+	/**
+	 * Returns the bytes reserved for nodes and key storage.
+	 */
+	size_t memory_usage() const {
+		return pool_.capacity() * sizeof(node_type) + arena_.capacity();
+	}
+
+	std::string to_ascii_drawing() {
+		return tree_ascii_drawing<std::string, V>(access(), tree_.root());
+	}
+
+	int height() const {
+		return tree_height(access(), tree_.root()) - 1;
+	}
+
+	size_t size() const {
+		return tree_.size();
+	}
+
+	size_t leaf_count() const {
+		return tree_leaf_count(access(), tree_.root());
+	}
+
+	size_t internal_node_count() const {
+		return tree_internal_node_count(access(), tree_.root());
+	}
+
+	size_t diameter() const {
+		return tree_diameter(access(), tree_.root());
+	}
+
+	size_t max_width() const {
+		return tree_max_width(access(), tree_.root());
+	}
+
+	double successful_search_cost() const {
+		return tree_successful_search_cost(access(), tree_.root(), size());
+	}
+
+	double unsuccessful_search_cost() const {
+		return tree_unsuccessful_search_cost(access(), tree_.root(), size());
+	}
+
+private:
+	StringArena arena_;
+	NodePool<node_type> pool_;
+	tree_type tree_;
+	friend class StringKeyTreeIterator<V> ;
+
+	// The tree's KeyOf points into arena_; not copyable.
+	StringKeyTree(const StringKeyTree &);
+	StringKeyTree& operator=(const StringKeyTree &);
+
+	struct Disposer {
+		NodePool<node_type> &pool;
+
+		Disposer(NodePool<node_type> &p) :
+				pool(p) {
+		}
+
+		void operator()(node_type *n) const {
+			n->~node_type();
+			pool.deallocate(n);
+		}
+	};
+
+	inline StringKeyView view(const node_type *n) const {
+		return StringKeyView(n->prefix_, arena_.data(n->offset_), n->length_);
+	}
+
+	std::string key_of(const node_type *n) const {
+		return std::string(arena_.data(n->offset_), n->length_);
+	}
+
+	Access access() const {
+		Access a;
+		a.tree = this;
+		return a;
+	}
+};
+
+#endif /* STRINGTREE_H_ */
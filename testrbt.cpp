@@ -1,25 +1,183 @@
 /*******************************************************************************
  * Name          : testrbt.cpp
  * Author        : Brian S. Borowski
- * Version       : 1.1
+ * Version       : 1.2
  * Date          : October 8, 2014
- * Last modified : April 9, 2015
+ * Last modified : October 19, 2026
  * Description   : Driver program to test implementation of red-black tree.
+ *                 Keys come from the command line or, with --file, from a
+ *                 file or stdin, read a chunk at a time.
+ *                 Usage: testrbt [options] [--] [key ...]
+ *                   --file PATH     read keys from PATH ('-' for stdin)
+ *                   --no-drawing    skip the ASCII drawing
+ *                   --no-traversal  skip the inorder traversal
+ *                   --timing        print the time taken by each step
  ******************************************************************************/
 #include "rbtree.h"
+#include <cerrno>
+#include <climits>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
+typedef chrono::steady_clock driver_clock;
+
 Tree *rbt;
 RedBlackTree<int, int> *rbti;
 RedBlackTree<string, string> *rbts;
 bool using_ints = false;
 
+/**
+ * Hands out the keys one at a time, from argv or from a stream, along with
+ * the index reported in error messages: the argv index, or the 1-based
+ * position in the stream.
+ */
+class KeySource {
+public:
+    KeySource(char **first, char **last) :
+        argv_(first), end_(last), in_(NULL), index_(0), peeked_(false) { }
+
+    KeySource(istream &in) :
+        argv_(NULL), end_(NULL), in_(&in), index_(0), peeked_(false) { }
+
+    void set_first_index(size_t index) {
+        index_ = index - 1;
+    }
+
+    /**
+     * Looks at the next key without consuming it.
+     */
+    bool peek(string &key) {
+        if (!peeked_) {
+            peeked_ = read(peeked_key_);
+            if (!peeked_) {
+                return false;
+            }
+        }
+        key = peeked_key_;
+        return true;
+    }
+
+    bool next(string &key, size_t &index) {
+        if (peeked_) {
+            key.swap(peeked_key_);
+            peeked_ = false;
+        } else if (!read(key)) {
+            return false;
+        }
+        index = ++index_;
+        return true;
+    }
+
+private:
+    char **argv_, **end_;
+    istream *in_;
+    size_t index_;
+    string peeked_key_;
+    bool peeked_;
+
+    bool read(string &key) {
+        if (in_ != NULL) {
+            return static_cast<bool>(*in_ >> key);
+        }
+        if (argv_ == end_) {
+            return false;
+        }
+        key = *argv_++;
+        return true;
+    }
+};
+
+/**
+ * Accepts what istringstream >> int accepts: leading whitespace, an optional
+ * sign and digits, with anything after them ignored.
+ */
+bool parse_int(const string &s, int &value) {
+    const char *begin = s.c_str();
+    char *end;
+    errno = 0;
+    long l = strtol(begin, &end, 10);
+    if (end == begin || errno == ERANGE || l < INT_MIN || l > INT_MAX) {
+        return false;
+    }
+    value = static_cast<int>(l);
+    return true;
+}
+
+struct Timing {
+    string label;
+    double seconds;
+    size_t operations;
+
+    Timing(const string &label, double seconds, size_t operations) :
+        label(label), seconds(seconds), operations(operations) { }
+};
+
+vector<Timing> timings;
+
+double seconds_since(driver_clock::time_point start) {
+    return chrono::duration<double>(driver_clock::now() - start).count();
+}
+
+/**
+ * Inserts the keys from source a chunk at a time, so that a file of any
+ * size is read in bounded memory and only the inserts themselves are timed.
+ * Returns false on a key that is not a valid integer in an integer tree.
+ */
+template<typename K>
+bool insert_keys(RedBlackTree<K, K> *tree, KeySource &source,
+        bool (*parse)(const string &, K &)) {
+    static const size_t CHUNK = 1 << 16;
+    vector<K> keys;
+    keys.reserve(CHUNK);
+    string token;
+    size_t index = 0, count = 0;
+    double seconds = 0;
+    bool more = true, valid = true;
+    while (more && valid) {
+        keys.clear();
+        while (keys.size() < CHUNK && (more = source.next(token, index))) {
+            K key;
+            if (!(valid = parse(token, key))) {
+                break;
+            }
+            keys.push_back(key);
+        }
+        driver_clock::time_point start = driver_clock::now();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            try {
+                tree->insert(keys[i], keys[i]);
+            } catch (const tree_exception &te) {
+                cerr << "Warning: " << te.what() << endl;
+            }
+        }
+        seconds += seconds_since(start);
+        count += keys.size();
+    }
+    if (!valid) {
+        // Reported after the keys before it went in, as their warnings were.
+        cerr << "Error: Invalid integer '" << token
+             << "' found at index " << index << "." << endl;
+        return false;
+    }
+    timings.push_back(Timing("Insert", seconds, count));
+    return true;
+}
+
+bool parse_string(const string &s, string &value) {
+    value = s;
+    return true;
+}
+
 string inorder_traversal() {
     ostringstream oss;
     oss << "[";
@@ -70,9 +228,76 @@ void test_find() {
     }
 }
 
+/**
+ * Calls f, records how long it took against label, and returns its result.
+ * operations is the number of keys f visits, or 0 if it does not walk them.
+ */
+template<typename F>
+auto timed(const string &label, size_t operations, F f) -> decltype(f()) {
+    driver_clock::time_point start = driver_clock::now();
+    auto result = f();
+    timings.push_back(Timing(label, seconds_since(start), operations));
+    return result;
+}
+
+void print_timings() {
+    cout << endl << "Timing:" << endl;
+    for (size_t i = 0; i < timings.size(); ++i) {
+        const Timing &t = timings[i];
+        cout << "  " << left << setw(27) << t.label + ":" << right
+             << setw(12) << setprecision(3) << t.seconds * 1e3 << " ms";
+        if (t.operations > 0 && t.seconds > 0) {
+            cout << setw(14) << setprecision(0) << t.operations / t.seconds
+                 << " keys/s";
+        }
+        cout << endl;
+    }
+}
+
 int main(int argc, char *argv[]) {
-    if (argc > 1) {
-        istringstream iss(argv[1]);
+    const char *file = NULL;
+    bool draw = true, traverse = true, timing = false;
+    int i = 1;
+    for (; i < argc; ++i) {
+        if (strcmp(argv[i], "--file") == 0) {
+            if (i + 1 == argc) {
+                cerr << "Error: Missing path after '--file'." << endl
+                     << "Usage: " << argv[0] << " [options] [--] [key ...]"
+                     << endl;
+                return 1;
+            }
+            file = argv[++i];
+        } else if (strcmp(argv[i], "--no-drawing") == 0) {
+            draw = false;
+        } else if (strcmp(argv[i], "--no-traversal") == 0) {
+            traverse = false;
+        } else if (strcmp(argv[i], "--timing") == 0) {
+            timing = true;
+        } else {
+            if (strcmp(argv[i], "--") == 0) {
+                ++i;
+            }
+            break;
+        }
+    }
+
+    ifstream in;
+    KeySource args(argv + i, argv + argc), stream(file != NULL
+            && strcmp(file, "-") == 0 ? cin : in);
+    KeySource &source = file != NULL ? stream : args;
+    if (file == NULL) {
+        args.set_first_index(i);
+    } else if (strcmp(file, "-") != 0) {
+        in.open(file);
+        if (!in) {
+            cerr << "Error: Cannot open file '" << file << "'." << endl;
+            return 1;
+        }
+    }
+
+    string first;
+    if (source.peek(first)) {
+        istringstream iss(first);
         int value;
         if (iss >> value) {
             using_ints = true;
@@ -87,51 +312,53 @@ int main(int argc, char *argv[]) {
         rbts = static_cast<RedBlackTree<string, string> *>(rbt);
     }
 
-    if (using_ints) {
-        for (int i = 1; i < argc; ++i) {
-            istringstream iss(argv[i]);
-            int value;
-            if (!(iss >> value)) {
-                cerr << "Error: Invalid integer '" << argv[i]
-                     << "' found at index " << i << "." << endl;
-                return 1;
-            }
-            try {
-                rbti->insert(value, value);
-            } catch (const tree_exception &te) {
-                cerr << "Warning: " << te.what() << endl;
-            }
-        }
-    } else {
-        for (int i = 1; i < argc; ++i) {
-            try {
-                static_cast<RedBlackTree<string, string> *>(rbt)->insert(argv[i], argv[i]);
-            } catch (const tree_exception &te) {
-                cerr << "Warning: " << te.what() << endl;
-            }
-        }
+    bool inserted = using_ints ? insert_keys(rbti, source, parse_int)
+            : insert_keys(rbts, source, parse_string);
+    if (!inserted) {
+        delete rbt;
+        return 1;
     }
 
-    cout << rbt->to_ascii_drawing() << endl << endl;
-    cout << "Height:                   " << rbt->height() << endl;
-    cout << "Total nodes:              " << rbt->size() << endl;
-    cout << "Leaf count:               " << rbt->leaf_count() << endl;
-    cout << "Internal nodes:           " << rbt->internal_node_count() << endl;
-    cout << "Diameter:                 " << rbt->diameter() << endl;
-    cout << "Maximum width:            " << rbt->max_width() << endl;
+    size_t n = rbt->size();
+    if (draw) {
+        cout << timed("ASCII drawing", 0,
+                [] { return rbt->to_ascii_drawing(); }) << endl << endl;
+    }
+    cout << "Height:                   "
+         << timed("Height", n, [] { return rbt->height(); }) << endl;
+    cout << "Total nodes:              "
+         << timed("Total nodes", 0, [] { return rbt->size(); }) << endl;
+    cout << "Leaf count:               "
+         << timed("Leaf count", n, [] { return rbt->leaf_count(); }) << endl;
+    cout << "Internal nodes:           "
+         << timed("Internal nodes", n,
+                 [] { return rbt->internal_node_count(); }) << endl;
+    cout << "Diameter:                 "
+         << timed("Diameter", n, [] { return rbt->diameter(); }) << endl;
+    cout << "Maximum width:            "
+         << timed("Maximum width", n, [] { return rbt->max_width(); }) << endl;
     cout << fixed;
     cout << "Successful search cost:   " << setprecision(3)
-         << rbt->successful_search_cost() << endl;
+         << timed("Successful search cost", n,
+                 [] { return rbt->successful_search_cost(); }) << endl;
     cout << "Unsuccessful search cost: " << setprecision(3)
-         << rbt->unsuccessful_search_cost() << endl;
-    cout << "Inorder traversal:        " << inorder_traversal() << endl;
+         << timed("Unsuccessful search cost", n,
+                 [] { return rbt->unsuccessful_search_cost(); }) << endl;
+    if (traverse) {
+        cout << "Inorder traversal:        "
+             << timed("Inorder traversal", n, inorder_traversal) << endl;
+    }
 
     try {
-        test_find();
+        timed("Find", n, [] { test_find(); return 0; });
     } catch (const tree_exception &te) {
         cerr << "Error: " << te.what() << endl;
     }
 
+    if (timing) {
+        print_timings();
+    }
+
     delete rbt;
     return 0;
 }
@@ -40,11 +40,7 @@ elif [ "$extension" = "c" ] || [ "$extension" = "cpp" ]; then
     echo -e "done\n"
 fi
 
-run_test_args() {
-    (( ++total ))
-    echo -n "Running test $total..."
-    expected=$2
-    received=$( $command $1 2>&1 | tr -d '\r' )
+check_result() {
     if [ "$expected" = "$received" ]; then
         echo "success"
         (( ++num_right ))
@@ -53,6 +49,43 @@ run_test_args() {
     fi
 }
 
+run_test_args() {
+    (( ++total ))
+    echo -n "Running test $total..."
+    expected=$2
+    received=$( $command $1 2>&1 | tr -d '\r' )
+    check_result
+}
+
+# Feeds $1 to stdin and passes $2 as the arguments.
+run_test_input() {
+    (( ++total ))
+    echo -n "Running test $total..."
+    expected=$3
+    received=$( printf "%s" "$1" | $command $2 2>&1 | tr -d '\r' )
+    check_result
+}
+
+# Like run_test_args, but drops the times from the --timing report, which
+# differ from run to run, and keeps just the labels.
+run_test_timing() {
+    (( ++total ))
+    echo -n "Running test $total..."
+    expected=$2
+    received=$( $command $1 2>&1 | tr -d '\r' | sed -E 's/: +[0-9.]+ ms.*$/:/' )
+    check_result
+}
+
+# Builds and runs one of the checks in check/, each of which prints nothing
+# when every condition it tests holds.
+run_test_check() {
+    (( ++total ))
+    echo -n "Running test $total ($1)..."
+    expected=
+    received=$( { make -s "$1" && "./$1"; } 2>&1 || echo "Exit status: $?" )
+    check_result
+}
+
 run_test_args "" "Root is null."$'\n'$'\n'"Height:                   -1"$'\n'"Total nodes:              0"$'\n'"Leaf count:               0"$'\n'"Internal nodes:           0"$'\n'"Diameter:                 0"$'\n'"Maximum width:            0"$'\n'"Successful search cost:   0.000"$'\n'"Unsuccessful search cost: 0.000"$'\n'"Inorder traversal:        []"
 run_test_args "50" "50"$'\n'$'\n'"Height:                   0"$'\n'"Total nodes:              1"$'\n'"Leaf count:               1"$'\n'"Internal nodes:           0"$'\n'"Diameter:                 0"$'\n'"Maximum width:            1"$'\n'"Successful search cost:   1.000"$'\n'"Unsuccessful search cost: 1.000"$'\n'"Inorder traversal:        [50]"
 run_test_args "50 60" "50"$'\n'"  \\"$'\n'"  60"$'\n'$'\n'"Height:                   1"$'\n'"Total nodes:              2"$'\n'"Leaf count:               1"$'\n'"Internal nodes:           1"$'\n'"Diameter:                 1"$'\n'"Maximum width:            1"$'\n'"Successful search cost:   1.500"$'\n'"Unsuccessful search cost: 1.667"$'\n'"Inorder traversal:        [50, 60]"
@@ -64,6 +97,25 @@ run_test_args "A Z B Y C X D W E V F U G T H S I R J Q K P L O M N" "
 run_test_args "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30" "              8"$'\n'"             / \\"$'\n'"            /   \\"$'\n'"           /     \\"$'\n'"          /       \\"$'\n'"         /         \\"$'\n'"        /           \\"$'\n'"       /             \\"$'\n'"      4              16"$'\n'"     / \\             / \\"$'\n'"    /   \\           /   \\"$'\n'"   /     \\         /     \\"$'\n'"  2       6       /       \\"$'\n'" / \\     / \\     /         \\"$'\n'"1   3   5   7   /           \\"$'\n'"               /             \\"$'\n'"              12             20"$'\n'"             / \\             / \\"$'\n'"            /   \\           /   \\"$'\n'"           /     \\         /     \\"$'\n'"          10     14       18     24"$'\n'"         / \\     / \\     / \\     / \\"$'\n'"        9  11   13 15   17 19   /   \\"$'\n'"                               /     \\"$'\n'"                              22     26"$'\n'"                             / \\     / \\"$'\n'"                            21 23   25 28"$'\n'"                                       / \\"$'\n'"                                      27 29"$'\n'"                                           \\"$'\n'"                                           30"$'\n'$'\n'"Height:                   7"$'\n'"Total nodes:              30"$'\n'"Leaf count:               15"$'\n'"Internal nodes:           15"$'\n'"Diameter:                 10"$'\n'"Maximum width:            8"$'\n'"Successful search cost:   4.500"$'\n'"Unsuccessful search cost: 5.323"$'\n'"Inorder traversal:        [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30]"
 run_test_args "30 29 28 27 26 25 24 23 22 21 20 19 18 17 16 15 14 13 12 11 10 9 8 7 6 5 4 3 2 1" "                             23"$'\n'"                             / \\"$'\n'"                            /   \\"$'\n'"                           /     \\"$'\n'"                          /       \\"$'\n'"                         /         \\"$'\n'"                        /           \\"$'\n'"                       /             \\"$'\n'"                      15             27"$'\n'"                     / \\             / \\"$'\n'"                    /   \\           /   \\"$'\n'"                   /     \\         /     \\"$'\n'"                  /       \\       25     29"$'\n'"                 /         \\     / \\     / \\"$'\n'"                /           \\   24 26   28 30"$'\n'"               /             \\"$'\n'"              11             19"$'\n'"             / \\             / \\"$'\n'"            /   \\           /   \\"$'\n'"           /     \\         /     \\"$'\n'"          7      13       17     21"$'\n'"         / \\     / \\     / \\     / \\"$'\n'"        /   \\   12 14   16 18   20 22"$'\n'"       /     \\"$'\n'"      5       9"$'\n'"     / \\     / \\"$'\n'"    3   6   8  10"$'\n'"   / \\"$'\n'"  2   4"$'\n'" /"$'\n'"1"$'\n'$'\n'"Height:                   7"$'\n'"Total nodes:              30"$'\n'"Leaf count:               15"$'\n'"Internal nodes:           15"$'\n'"Diameter:                 10"$'\n'"Maximum width:            8"$'\n'"Successful search cost:   4.500"$'\n'"Unsuccessful search cost: 5.323"$'\n'"Inorder traversal:        [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30]"
 
+keys_file=$(mktemp)
+printf "50\n60  70\n" > "$keys_file"
+run_test_args "--file $keys_file" " 60"$'\n'" / \\"$'\n'"50 70"$'\n'$'\n'"Height:                   1"$'\n'"Total nodes:              3"$'\n'"Leaf count:               2"$'\n'"Internal nodes:           1"$'\n'"Diameter:                 2"$'\n'"Maximum width:            2"$'\n'"Successful search cost:   1.667"$'\n'"Unsuccessful search cost: 2.000"$'\n'"Inorder traversal:        [50, 60, 70]"
+run_test_input "50 60"$'\n'"70" "--file -" " 60"$'\n'" / \\"$'\n'"50 70"$'\n'$'\n'"Height:                   1"$'\n'"Total nodes:              3"$'\n'"Leaf count:               2"$'\n'"Internal nodes:           1"$'\n'"Diameter:                 2"$'\n'"Maximum width:            2"$'\n'"Successful search cost:   1.667"$'\n'"Unsuccessful search cost: 2.000"$'\n'"Inorder traversal:        [50, 60, 70]"
+run_test_args "--no-drawing 50 60 70" "Height:                   1"$'\n'"Total nodes:              3"$'\n'"Leaf count:               2"$'\n'"Internal nodes:           1"$'\n'"Diameter:                 2"$'\n'"Maximum width:            2"$'\n'"Successful search cost:   1.667"$'\n'"Unsuccessful search cost: 2.000"$'\n'"Inorder traversal:        [50, 60, 70]"
+run_test_args "--no-drawing --no-traversal 50 60 70" "Height:                   1"$'\n'"Total nodes:              3"$'\n'"Leaf count:               2"$'\n'"Internal nodes:           1"$'\n'"Diameter:                 2"$'\n'"Maximum width:            2"$'\n'"Successful search cost:   1.667"$'\n'"Unsuccessful search cost: 2.000"
+run_test_timing "--timing --no-drawing --no-traversal 50 60 70" "Height:                   1"$'\n'"Total nodes:              3"$'\n'"Leaf count:               2"$'\n'"Internal nodes:           1"$'\n'"Diameter:                 2"$'\n'"Maximum width:            2"$'\n'"Successful search cost:   1.667"$'\n'"Unsuccessful search cost: 2.000"$'\n'$'\n'"Timing:"$'\n'"  Insert:"$'\n'"  Height:"$'\n'"  Total nodes:"$'\n'"  Leaf count:"$'\n'"  Internal nodes:"$'\n'"  Diameter:"$'\n'"  Maximum width:"$'\n'"  Successful search cost:"$'\n'"  Unsuccessful search cost:"$'\n'"  Find:"
+run_test_args "-- --timing" "--timing"$'\n'$'\n'"Height:                   0"$'\n'"Total nodes:              1"$'\n'"Leaf count:               1"$'\n'"Internal nodes:           0"$'\n'"Diameter:                 0"$'\n'"Maximum width:            1"$'\n'"Successful search cost:   1.000"$'\n'"Unsuccessful search cost: 1.000"$'\n'"Inorder traversal:        [--timing]"
+printf "50\n60 x 70\n" > "$keys_file"
+run_test_args "--file $keys_file" "Error: Invalid integer 'x' found at index 3."
+run_test_input "50 -8 nine" "--file -" "Error: Invalid integer 'nine' found at index 3."
+rm -f "$keys_file"
+run_test_args "--file $keys_file" "Error: Cannot open file '$keys_file'."
+run_test_args "--no-drawing --file" "Error: Missing path after '--file'."$'\n'"Usage: ./testrbt [options] [--] [key ...]"
+
+for check in check/*.cpp; do
+    run_test_check "${check%.cpp}"
+done
+
 echo -e "\nTotal tests run: $total"
 echo -e "Number correct : $num_right"
 echo -n "Percent correct: "
@@ -0,0 +1,471 @@
+/*******************************************************************************
+ * Name        : topdowntree.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Red-black tree whose nodes have no parent pointer. Insert and
+ *               erase rebalance on the way down in a single pass, so they
+ *               never need to climb, and iterators carry the path from the
+ *               root on a fixed-size stack instead.
+ ******************************************************************************/
+#ifndef TOPDOWNTREE_H_
+#define TOPDOWNTREE_H_
+
+#include "nodepool.h"
+#include "rbtree.h"
+#include "tree.h"
+#include "treestats.h"
+#include <new>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * The child links of a node. The tree uses a bare TopDownLinks as a false
+ * root above the real one, so the root needs no special case.
+ */
+template<typename N>
+struct TopDownLinks {
+	N *link[2];
+
+	TopDownLinks() {
+		link[0] = link[1] = NULL;
+	}
+};
+
+template<typename K, typename V>
+struct TopDownNode: TopDownLinks<TopDownNode<K, V> > {
+	K key;
+	V value;
+	bool red;
+
+	TopDownNode(const K &k, const V &v) :
+			key(k), value(v), red(true) {
+	}
+};
+
+template<typename K, typename V>
+class TopDownRedBlackTree;
+
+template<typename K, typename V>
+class TopDownTreeIterator {
+	typedef TopDownNode<K, V> node_type;
+
+public:
+	/**
+	 * A red-black tree of n nodes is at most 2·log2(n + 1) levels deep, and
+	 * n cannot exceed the address space.
+	 */
+	static const unsigned MAX_DEPTH = 2 * 8 * sizeof(void*);
+
+	TopDownTreeIterator() :
+			depth_(0), tree_(NULL) {
+	}
+
+	bool operator==(const TopDownTreeIterator &rhs) const {
+		return current() == rhs.current();
+	}
+
+	bool operator!=(const TopDownTreeIterator &rhs) const {
+		return current() != rhs.current();
+	}
+
+	std::pair<K, V> operator*() const {
+		return std::pair<K, V>(current()->key, current()->value);
+	}
+
+	const K& key() const {
+		return current()->key;
+	}
+
+	V& value() const {
+		return current()->value;
+	}
+
+	/**
+	 * Preincrement operator. Moves forward to next larger key.
+	 */
+	TopDownTreeIterator& operator++() {
+		if (depth_ == 0) {
+			// ++ from end(). Move to the first node in order.
+			if (tree_->root_ == NULL)
+				throw tree_exception(
+						"TopDownTreeIterator operator++(): tree empty");
+			push_left(tree_->root_);
+		} else {
+			node_type *n = stack_[--depth_];
+			if (n->link[1] != NULL)
+				push_left(n->link[1]);
+		}
+		return *this;
+	}
+
+	TopDownTreeIterator operator++(int) {
+		TopDownTreeIterator tmp(*this);
+		operator++();
+		return tmp;
+	}
+
+private:
+	// stack_[0..depth_) holds the current node on top and, below it, each
+	// ancestor whose left subtree contains it: exactly the nodes still to be
+	// visited on the way back up. An empty stack is end().
+	node_type *stack_[MAX_DEPTH];
+	unsigned depth_;
+	const TopDownRedBlackTree<K, V> *tree_;
+	friend class TopDownRedBlackTree<K, V> ;
+
+	TopDownTreeIterator(const TopDownRedBlackTree<K, V> *t) :
+			depth_(0), tree_(t) {
+	}
+
+	inline node_type* current() const {
+		return depth_ == 0 ? NULL : stack_[depth_ - 1];
+	}
+
+	inline void push(node_type *n) {
+		stack_[depth_++] = n;
+	}
+
+	void push_left(node_type *n) {
+		for (; n != NULL; n = n->link[0])
+			push(n);
+	}
+};
+
+/**
+ * Red-black tree with the insert, find, iterator and statistics interface of
+ * RedBlackTree, plus erase. Nodes hold two links and a color flag; an
+ * int/int node is 32 bytes against 48 for RedBlackNode.
+ *
+ * Insert and erase follow the top-down algorithms of Guibas and Sedgewick:
+ * colors are flipped and rotations made on the way down so that the leaf
+ * being added or removed can be changed without any fixup afterwards. The
+ * resulting shapes differ from those of RedBlackTree.
+ */
+template<typename K, typename V>
+class TopDownRedBlackTree: public Tree {
+	typedef TopDownNode<K, V> node_type;
+	typedef TopDownLinks<node_type> links_type;
+
+	/**
+	 * Accessor for treestats.h.
+	 */
+	struct Access {
+		typedef const node_type *node;
+
+		bool is_null(node n) const {
+			return n == NULL;
+		}
+
+		node left(node n) const {
+			return n->link[0];
+		}
+
+		node right(node n) const {
+			return n->link[1];
+		}
+
+		const K& key(node n) const {
+			return n->key;
+		}
+
+		const V& value(node n) const {
+			return n->value;
+		}
+	};
+
+public:
+	typedef TopDownTreeIterator<K, V> iterator;
+
+	TopDownRedBlackTree() :
+			root_(NULL), size_(0) {
+	}
+
+	TopDownRedBlackTree(std::vector<std::pair<K, V> > &elements) :
+			root_(NULL), size_(0) {
+		insert_elements(elements);
+	}
+
+	~TopDownRedBlackTree() {
+		clear();
+	}
+
+	/**
+	 * Removes every node.
+	 */
+	void clear() {
+		if (!std::is_trivially_destructible<node_type>::value)
+			destroy(root_);
+		root_ = NULL;
+		size_ = 0;
+		pool_.reset();
+	}
+
+	/**
+	 * Inserts elements from the vector. Duplicate keys are not inserted.
+	 */
+	void insert_elements(std::vector<std::pair<K, V> > &elements) {
+		for (size_t i = 0, len = elements.size(); i < len; ++i) {
+			try {
+				insert(elements[i].first, elements[i].second);
+			} catch (const tree_exception &te) {
+				std::cerr << "Warning: " << te.what() << std::endl;
+			}
+		}
+	}
+
+	/**
+	 * Inserts a key-value pair. Throws a tree_exception on a duplicate key;
+	 * the tree may have been rebalanced by then, but holds the same keys.
+	 */
+	void insert(const K &key, const V &value) {
+		if (root_ == NULL) {
+			root_ = new_node(key, value);
+			root_->red = false;
+			size_ = 1;
+			return;
+		}
+		links_type head;
+		links_type *t = &head;    // great-grandparent
+		node_type *g = NULL;      // grandparent
+		node_type *p = NULL;      // parent
+		node_type *q = root_;     // current
+		head.link[1] = root_;
+		int dir = 0, last = 0;
+		bool inserted = false;
+		for (;;) {
+			if (q == NULL) {
+				// Reached the bottom: add the new red leaf.
+				p->link[dir] = q = new_node(key, value);
+				inserted = true;
+			} else if (is_red(q->link[0]) && is_red(q->link[1])) {
+				// A black node with two red children: push the red up.
+				q->red = true;
+				q->link[0]->red = q->link[1]->red = false;
+			}
+			if (is_red(q) && is_red(p)) {
+				// Two reds in a row after an insert or a flip.
+				int dir2 = t->link[1] == g;
+				t->link[dir2] = q == p->link[last] ?
+						rotate_single(g, !last) : rotate_double(g, !last);
+			}
+			if (inserted)
+				break;
+			if (!(key < q->key) && !(q->key < key))
+				break;
+			last = dir;
+			dir = q->key < key;
+			if (g != NULL)
+				t = g;
+			g = p;
+			p = q;
+			q = q->link[dir];
+		}
+		root_ = head.link[1];
+		root_->red = false;
+		if (!inserted) {
+			std::ostringstream oss;
+			oss << "Attempt to insert duplicate key '" << key << "'.";
+			throw tree_exception(oss.str());
+		}
+		++size_;
+	}
+
+	/**
+	 * Removes key, returning false if it was not present. The descent makes
+	 * the node to be unlinked red, so removal needs no fixup. When the key
+	 * sits in an internal node, the in-order predecessor's key and value are
+	 * moved into that node and the predecessor's node is unlinked instead;
+	 * iterators to either are invalidated.
+	 */
+	bool erase(const K &key) {
+		if (root_ == NULL)
+			return false;
+		links_type head;
+		links_type *q = &head, *p = NULL, *g = NULL;
+		node_type *found = NULL;
+		head.link[1] = root_;
+		int dir = 1;
+		while (q->link[dir] != NULL) {
+			int last = dir;
+			g = p;
+			p = q;
+			node_type *n = q->link[dir];
+			q = n;
+			dir = n->key < key;
+			if (!dir && !(key < n->key))
+				found = n;
+			// Push a red node down to n if it has none on the side we take.
+			if (!is_red(n) && !is_red(n->link[dir])) {
+				if (is_red(n->link[!dir])) {
+					p = p->link[last] = rotate_single(n, dir);
+				} else {
+					node_type *s = p->link[!last];
+					if (s != NULL) {
+						// p is a real node here: only the root has an empty
+						// sibling slot above it.
+						node_type *pn = static_cast<node_type*>(p);
+						if (!is_red(s->link[!last]) && !is_red(s->link[last])) {
+							pn->red = false;
+							s->red = true;
+							n->red = true;
+						} else {
+							int dir2 = g->link[1] == pn;
+							g->link[dir2] = is_red(s->link[last]) ?
+									rotate_double(pn, last) :
+									rotate_single(pn, last);
+							node_type *r = g->link[dir2];
+							n->red = r->red = true;
+							r->link[0]->red = r->link[1]->red = false;
+						}
+					}
+				}
+			}
+		}
+		if (found != NULL) {
+			node_type *n = static_cast<node_type*>(q);
+			if (found != n) {
+				found->key = n->key;
+				found->value = n->value;
+			}
+			p->link[p->link[1] == n] = n->link[n->link[0] == NULL];
+			free_node(n);
+			--size_;
+		}
+		root_ = head.link[1];
+		if (root_ != NULL)
+			root_->red = false;
+		return found != NULL;
+	}
+
+	/**
+	 * Searches for key. The returned iterator holds the path to the key, so
+	 * it can be advanced like one from begin().
+	 */
+	iterator find(const K &key) const {
+		iterator it(this);
+		node_type *x = root_;
+		while (x != NULL) {
+			if (key < x->key) {
+				it.push(x);
+				x = x->link[0];
+			} else if (x->key < key) {
+				x = x->link[1];
+			} else {
+				it.push(x); // Found!
+				return it;
+			}
+		}
+		return end();
+	}
+
+	iterator begin() const {
+		iterator it(this);
+		it.push_left(root_);
+		return it;
+	}
+
+	iterator end() const {
+		return iterator(this);
+	}
+
+	std::string to_ascii_drawing() {
+		return tree_ascii_drawing<K, V>(Access(), root_);
+	}
+
+	int height() const {
+		return tree_height(Access(), root_) - 1;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	size_t leaf_count() const {
+		return tree_leaf_count(Access(), root_);
+	}
+
+	size_t internal_node_count() const {
+		return tree_internal_node_count(Access(), root_);
+	}
+
+	size_t diameter() const {
+		return tree_diameter(Access(), root_);
+	}
+
+	size_t max_width() const {
+		return tree_max_width(Access(), root_);
+	}
+
+	double successful_search_cost() const {
+		return tree_successful_search_cost(Access(), root_, size_);
+	}
+
+	double unsuccessful_search_cost() const {
+		return tree_unsuccessful_search_cost(Access(), root_, size_);
+	}
+
+private:
+	node_type *root_;
+	size_t size_;
+	NodePool<node_type> pool_;
+	friend class TopDownTreeIterator<K, V> ;
+
+	// Nodes are owned by the pool of exactly one tree.
+	TopDownRedBlackTree(const TopDownRedBlackTree &);
+	TopDownRedBlackTree& operator=(const TopDownRedBlackTree &);
+
+	static inline bool is_red(const node_type *n) {
+		return n != NULL && n->red;
+	}
+
+	/**
+	 * Rotates root in direction dir and recolors so that the new subtree
+	 * root is black and the old one red. Returns the new subtree root.
+	 */
+	static node_type* rotate_single(node_type *root, int dir) {
+		node_type *save = root->link[!dir];
+		root->link[!dir] = save->link[dir];
+		save->link[dir] = root;
+		root->red = true;
+		save->red = false;
+		return save;
+	}
+
+	static node_type* rotate_double(node_type *root, int dir) {
+		root->link[!dir] = rotate_single(root->link[!dir], !dir);
+		return rotate_single(root, dir);
+	}
+
+	node_type* new_node(const K &key, const V &value) {
+		void *p = pool_.allocate();
+		try {
+			return new (p) node_type(key, value);
+		} catch (...) {
+			pool_.deallocate(p);
+			throw;
+		}
+	}
+
+	void free_node(node_type *n) {
+		n->~node_type();
+		pool_.deallocate(n);
+	}
+
+	/**
+	 * Runs the destructor of every node below n. Recursion depth is bounded
+	 * by the height of the tree.
+	 */
+	static void destroy(node_type *n) {
+		if (n != NULL) {
+			destroy(n->link[0]);
+			destroy(n->link[1]);
+			n->~node_type();
+		}
+	}
+};
+
+#endif /* TOPDOWNTREE_H_ */
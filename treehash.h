@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * Name        : treehash.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : Key hashing for the optional lookup accelerators. Trees work
+ *               with any key that has operator<; only the accelerators need a
+ *               hash, so a key without std::hash still compiles as long as
+ *               they are left off.
+ ******************************************************************************/
+#ifndef TREEHASH_H_
+#define TREEHASH_H_
+
+#include <functional>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+/**
+ * True if std::hash<K> can be used.
+ */
+template<typename K>
+class is_hashable {
+	template<typename T>
+	static char test(decltype(std::hash<T>()(std::declval<const T&>()))*);
+
+	template<typename T>
+	static long test(...);
+
+public:
+	static const bool value = sizeof(test<K>(0)) == 1;
+};
+
+/**
+ * The 64-bit finalizer of MurmurHash3. std::hash is the identity for
+ * integers; this spreads every input bit over all output bits.
+ */
+inline uint64_t mix_hash(uint64_t h) {
+	h ^= h >> 33;
+	h *= UINT64_C(0xff51afd7ed558ccd);
+	h ^= h >> 33;
+	h *= UINT64_C(0xc4ceb9fe1a85ec53);
+	h ^= h >> 33;
+	return h;
+}
+
+template<typename K>
+inline uint64_t tree_hash(const K &key, std::true_type) {
+	return mix_hash(std::hash<K>()(key));
+}
+
+// Never reached at run time: the accelerators static_assert is_hashable<K>
+// when they are switched on.
+template<typename K>
+inline uint64_t tree_hash(const K &, std::false_type) {
+	return 0;
+}
+
+/**
+ * Returns a well-mixed 64-bit hash of key.
+ */
+template<typename K>
+inline uint64_t tree_hash(const K &key) {
+	return tree_hash(key,
+			std::integral_constant<bool, is_hashable<K>::value>());
+}
+
+#endif /* TREEHASH_H_ */
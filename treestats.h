@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * Name        : treestats.h
+ * Author      : Kevin Furlong, Henry Thomas, Jonathan S.
+ * Version     : 1.0
+ * Date        : 10-19-2026
+ * Description : The Tree statistics of rbtree.h, written once for any binary
+ *               tree layout. A layout is described by an accessor with
+ *                 typedef ... node;         // pointer, index, offset...
+ *                 bool is_null(node) const;
+ *                 node left(node) const;
+ *                 node right(node) const;
+ *               and, for drawing, key(node) and value(node).
+ ******************************************************************************/
+#ifndef TREESTATS_H_
+#define TREESTATS_H_
+
+#include "node.h"
+#include "treeprinter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Returns the height of the tree starting at n. A null node has height 0.
+ */
+template<typename Access>
+int tree_height(const Access &a, typename Access::node n) {
+	if (a.is_null(n))
+		return 0;
+	return std::max(tree_height(a, a.left(n)), tree_height(a, a.right(n)))
+			+ 1;
+}
+
+/**
+ * Returns the count of nodes that have no children.
+ */
+template<typename Access>
+size_t tree_leaf_count(const Access &a, typename Access::node n) {
+	if (a.is_null(n))
+		return 0;
+	if (a.is_null(a.left(n)) && a.is_null(a.right(n)))
+		return 1;
+	return tree_leaf_count(a, a.left(n)) + tree_leaf_count(a, a.right(n));
+}
+
+/**
+ * Returns the count of nodes that have at least one child.
+ */
+template<typename Access>
+size_t tree_internal_node_count(const Access &a, typename Access::node n) {
+	if (a.is_null(n) || (a.is_null(a.left(n)) && a.is_null(a.right(n))))
+		return 0;
+	return 1 + tree_internal_node_count(a, a.left(n))
+			+ tree_internal_node_count(a, a.right(n));
+}
+
+/**
+ * Returns the diameter as RedBlackTree defines it: the heights of the two
+ * subtrees of n added together.
+ */
+template<typename Access>
+size_t tree_diameter(const Access &a, typename Access::node n) {
+	if (a.is_null(n))
+		return 0;
+	return tree_height(a, a.left(n)) + tree_height(a, a.right(n));
+}
+
+/**
+ * Returns the number of nodes at the given level below n.
+ */
+template<typename Access>
+size_t tree_width(const Access &a, typename Access::node n, size_t level) {
+	if (a.is_null(n))
+		return 0;
+	if (level == 0)
+		return 1;
+	return tree_width(a, a.left(n), level - 1)
+			+ tree_width(a, a.right(n), level - 1);
+}
+
+/**
+ * Returns the largest number of nodes on any level.
+ */
+template<typename Access>
+size_t tree_max_width(const Access &a, typename Access::node n) {
+	size_t max_width = 0;
+	for (int i = 0, h = tree_height(a, n); i < h; ++i)
+		max_width = std::max(max_width, tree_width(a, n, i));
+	return max_width;
+}
+
+/**
+ * Returns the sum of the levels of each non-null node.
+ */
+template<typename Access>
+size_t tree_sum_levels(const Access &a, typename Access::node n,
+		size_t level = 0) {
+	if (a.is_null(n))
+		return 0;
+	return level + tree_sum_levels(a, a.left(n), level + 1)
+			+ tree_sum_levels(a, a.right(n), level + 1);
+}
+
+/**
+ * Returns the sum of the levels of each null node.
+ */
+template<typename Access>
+size_t tree_sum_null_levels(const Access &a, typename Access::node n,
+		size_t level = 0) {
+	if (a.is_null(n))
+		return level;
+	return tree_sum_null_levels(a, a.left(n), level + 1)
+			+ tree_sum_null_levels(a, a.right(n), level + 1);
+}
+
+/**
+ * Returns the average number of nodes visited to find a present key.
+ */
+template<typename Access>
+double tree_successful_search_cost(const Access &a, typename Access::node n,
+		size_t size) {
+	return size == 0 ? 0 : 1 + (double) tree_sum_levels(a, n) / size;
+}
+
+/**
+ * Returns the average number of nodes visited to find a missing key. A tree
+ * of size nodes has size + 1 null links.
+ */
+template<typename Access>
+double tree_unsuccessful_search_cost(const Access &a, typename Access::node n,
+		size_t size) {
+	return (double) tree_sum_null_levels(a, n) / (size + 1);
+}
+
+/**
+ * Copies the tree into Nodes so that BinaryTreePrinter can draw it.
+ */
+template<typename K, typename V, typename Access>
+Node<K, V>* mirror_tree(const Access &a, typename Access::node n) {
+	if (a.is_null(n))
+		return NULL;
+	Node<K, V> *copy = new Node<K, V>(a.key(n), a.value(n));
+	copy->set_left(mirror_tree<K, V>(a, a.left(n)));
+	copy->set_right(mirror_tree<K, V>(a, a.right(n)));
+	return copy;
+}
+
+template<typename K, typename V>
+void delete_mirror(Node<K, V> *n) {
+	if (n != NULL) {
+		delete_mirror(n->left());
+		delete_mirror(n->right());
+		delete n;
+	}
+}
+
+/**
+ * Returns the same ASCII drawing RedBlackTree produces for this shape.
+ */
+template<typename K, typename V, typename Access>
+std::string tree_ascii_drawing(const Access &a, typename Access::node n) {
+	Node<K, V> *mirror = mirror_tree<K, V>(a, n);
+	std::string drawing;
+	{
+		BinaryTreePrinter<K, V> printer(mirror);
+		drawing = printer.to_string();
+	}
+	delete_mirror(mirror);
+	return drawing;
+}
+
+#endif /* TREESTATS_H_ */